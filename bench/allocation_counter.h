@@ -0,0 +1,29 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+/**
+ * @return The number of heap allocations since the start of the program. They are counted by the replacement of the
+ * global operator new in allocation_counter.cpp.
+ */
+std::size_t allocation_count();
+
+/**
+ * Class that reports the heap allocations of a benchmark as the counter "allocations" per iteration.
+ * Create it right before the benchmark loop; the counter is set when it is destroyed.
+ */
+class AllocationReport {
+public:
+
+    explicit AllocationReport(benchmark::State &state) : state_(state), start_(allocation_count()) {}
+
+    ~AllocationReport() {
+        state_.counters["allocations"] = benchmark::Counter(static_cast<double>(allocation_count() - start_),
+                                                            benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State &state_;
+    std::size_t start_;
+};
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include "allocation_counter.h"
+#include "interval.h"
+
+namespace {
+
+    /**
+     * @param pieces The number of simple intervals.
+     * @param offset The shift of all simple intervals.
+     * @return The union of the closed intervals [2i + offset, 2i + 1 + offset] for i < pieces.
+     */
+    IntervalPtr_t make_interval(std::int64_t pieces, double offset) {
+        auto simple_sets = make_shared_simple_set_set();
+        for (std::int64_t i = 0; i < pieces; ++i) {
+            simple_sets->insert(SimpleInterval::make_shared(2 * i + offset, 2 * i + 1 + offset, BorderType::CLOSED,
+                                                            BorderType::CLOSED));
+        }
+        return Interval::make_shared(simple_sets);
+    }
+}
+
+static void BM_IntervalUnion(benchmark::State &state) {
+    auto lhs = make_interval(state.range(0), 0);
+    auto rhs = make_interval(state.range(0), 0.5);
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs->union_with(rhs));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntervalUnion)->RangeMultiplier(4)->Range(4, 4096);
+
+static void BM_IntervalIntersection(benchmark::State &state) {
+    auto lhs = make_interval(state.range(0), 0);
+    auto rhs = make_interval(state.range(0), 0.5);
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs->intersection_with(rhs));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntervalIntersection)->RangeMultiplier(4)->Range(4, 4096);
+
+static void BM_IntervalComplement(benchmark::State &state) {
+    auto interval = make_interval(state.range(0), 0);
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(interval->complement());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntervalComplement)->RangeMultiplier(4)->Range(4, 4096);
@@ -0,0 +1,318 @@
+#include <benchmark/benchmark.h>
+#include "allocation_counter.h"
+#include "compiled_event.h"
+#include "event_index.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "variable.h"
+#include "workload_generator.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /**
+     * @param count The number of variables.
+     * @return The continuous variables x0, x1, ...
+     */
+    std::vector<AbstractVariablePtr_t> make_variables(std::int64_t count) {
+        std::vector<AbstractVariablePtr_t> variables;
+        for (std::int64_t i = 0; i < count; ++i) {
+            variables.push_back(make_shared_continuous(std::make_shared<std::string>("x" + std::to_string(i))));
+        }
+        return variables;
+    }
+
+    /**
+     * @param variables The variables.
+     * @param lower The lower bound of every side.
+     * @param upper The upper bound of every side.
+     * @return The box [lower, upper]^n over the variables.
+     */
+    SimpleEventPtr_t make_box(const std::vector<AbstractVariablePtr_t> &variables, double lower, double upper) {
+        auto variable_map = std::make_shared<VariableMap>();
+        for (auto const &variable: variables) {
+            variable_map->insert({variable, closed(lower, upper)});
+        }
+        return make_shared_simple_event(variable_map);
+    }
+
+    /**
+     * @param variables The number of continuous variables.
+     * @param count The number of boxes.
+     * @return The generator of random boxes of which 5% of the pairs overlap. The seed is fixed.
+     */
+    WorkloadGenerator make_box_generator(std::size_t variables, std::int64_t count) {
+        WorkloadConfig config;
+        config.seed = 42;
+        config.continuous_variables = variables;
+        config.event_count = static_cast<std::size_t>(count);
+        config.overlap_density = 0.05;
+        return WorkloadGenerator(config);
+    }
+
+    /**
+     * @param variables Two variables.
+     * @param side The number of cells per side.
+     * @return The side x side grid of adjacent unit cells, which simplifies to one box.
+     */
+    EventPtr_t make_grid(const std::vector<AbstractVariablePtr_t> &variables, std::int64_t side) {
+        auto event = make_shared_event();
+        for (std::int64_t i = 0; i < side; ++i) {
+            for (std::int64_t j = 0; j < side; ++j) {
+                auto variable_map = std::make_shared<VariableMap>();
+                variable_map->insert({variables[0], closed_open(i, i + 1)});
+                variable_map->insert({variables[1], closed_open(j, j + 1)});
+                event->simple_sets->insert(make_shared_simple_event(variable_map));
+            }
+        }
+        return event;
+    }
+
+    /**
+     * @param variables The number of variables.
+     * @param rows The number of rows.
+     * @return Uniform columns over the domain of the generated boxes. The seed is fixed.
+     */
+    std::vector<std::vector<double>> make_columns(std::size_t variables, std::size_t rows) {
+        std::mt19937_64 engine(7);
+        std::uniform_real_distribution<double> uniform(0, WorkloadConfig().domain_width);
+        std::vector<std::vector<double>> columns(variables, std::vector<double>(rows));
+        for (auto &column: columns) {
+            for (auto &value: column) {
+                value = uniform(engine);
+            }
+        }
+        return columns;
+    }
+
+    /**
+     * @param count The number of simple events per side.
+     * @return Two events over three continuous variables whose simple events overlap in 0.5% of all pairs.
+     */
+    std::pair<AbstractCompositeSetPtr_t, AbstractCompositeSetPtr_t> make_join_events(std::int64_t count) {
+        WorkloadConfig config;
+        config.seed = 42;
+        config.continuous_variables = 3;
+        config.event_count = static_cast<std::size_t>(count);
+        config.overlap_density = 0.005;
+        WorkloadGenerator generator(config);
+        auto lhs = generator.event();
+        return {lhs, generator.event()};
+    }
+}
+
+static void BM_SimpleEventIntersection(benchmark::State &state) {
+    auto variables = make_variables(state.range(0));
+    auto lhs = make_box(variables, 0, 2);
+    AbstractSimpleSetPtr_t rhs = make_box(variables, 1, 3);
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs->intersection_with(rhs));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SimpleEventIntersection)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_EventMakeDisjoint(benchmark::State &state) {
+    auto event = make_box_generator(2, state.range(0)).event();
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(event->make_disjoint());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventMakeDisjoint)->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMillisecond);
+
+static void BM_EventSimplify(benchmark::State &state) {
+    auto event = make_grid(make_variables(2), state.range(0));
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(event->simplify());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_EventSimplify)->RangeMultiplier(2)->Range(2, 32)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventMakeDisjointDisjointBoxes(benchmark::State &state) {
+    // the simple events of the result keep the assignments of the boxes, which the promoted result shares
+    auto variables = make_variables(state.range(0));
+    auto event = make_shared_event();
+    for (int i = 0; i < 16; ++i) {
+        event->simple_sets->insert(make_box(variables, 2 * i, 2 * i + 1));
+    }
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(event->make_disjoint());
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_EventMakeDisjointDisjointBoxes)->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventMarginal(benchmark::State &state) {
+    auto generator = make_box_generator(3, state.range(0));
+    auto event = generator.event()->make_disjoint();
+    auto marginal_variables = make_shared_variable_set(VariableSet{*generator.variables()->begin()});
+    auto disjoint_event = std::static_pointer_cast<Event>(event);
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(disjoint_event->marginal(marginal_variables));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventMarginal)->RangeMultiplier(2)->Range(8, 64)->Unit(benchmark::kMicrosecond);
+
+static constexpr std::size_t CONTAINS_ROWS = 4096;
+
+static void BM_EventContainsRows(benchmark::State &state) {
+    auto event = make_box_generator(3, state.range(0)).event()->make_disjoint();
+    auto columns = make_columns(3, CONTAINS_ROWS);
+    AllocationReport report(state);
+    for (auto _: state) {
+        std::size_t contained = 0;
+        for (std::size_t row = 0; row < CONTAINS_ROWS; ++row) {
+            for (auto const &simple_set: *event->simple_sets) {
+                // the variable maps are ordered like the columns
+                std::size_t column = 0;
+                bool inside = true;
+                for (auto const &[variable, assignment]: *static_cast<SimpleEvent *>(simple_set.get())->variable_map) {
+                    inside = static_cast<Interval *>(assignment.get())->contains(columns[column++][row]);
+                    if (!inside) {
+                        break;
+                    }
+                }
+                if (inside) {
+                    ++contained;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(contained);
+    }
+    state.SetItemsProcessed(state.iterations() * CONTAINS_ROWS);
+}
+BENCHMARK(BM_EventContainsRows)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventContainsBatch(benchmark::State &state) {
+    auto event = make_box_generator(3, state.range(0)).event()->make_disjoint();
+    auto columns = make_columns(3, CONTAINS_ROWS);
+    auto &batch_event = static_cast<const Event &>(*event);
+    VariableRegistry registry(make_shared_variable_set(batch_event.get_variables_from_simple_events()));
+    std::vector<PointColumn> point_columns(3);
+    for (std::size_t id = 0; id < 3; ++id) {
+        point_columns[id].values = columns[id].data();
+    }
+    std::vector<std::uint8_t> mask(CONTAINS_ROWS);
+    AllocationReport report(state);
+    for (auto _: state) {
+        batch_event.contains(registry, point_columns.data(), CONTAINS_ROWS, mask.data());
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * CONTAINS_ROWS);
+}
+BENCHMARK(BM_EventContainsBatch)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMicrosecond);
+
+static void BM_CompiledEventContainsRows(benchmark::State &state) {
+    auto event = make_box_generator(3, state.range(0)).event()->make_disjoint();
+    auto columns = make_columns(3, CONTAINS_ROWS);
+    std::vector<const double *> column_pointers{columns[0].data(), columns[1].data(), columns[2].data()};
+    std::vector<std::uint8_t> mask(CONTAINS_ROWS);
+    CompiledEvent compiled(static_cast<const Event &>(*event));
+    state.counters["depth"] = static_cast<double>(compiled.depth());
+    state.counters["simple_events"] = static_cast<double>(event->simple_sets->size());
+    AllocationReport report(state);
+    for (auto _: state) {
+        compiled.contains(column_pointers.data(), CONTAINS_ROWS, mask.data());
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * CONTAINS_ROWS);
+}
+BENCHMARK(BM_CompiledEventContainsRows)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMicrosecond);
+
+static void BM_CompileEvent(benchmark::State &state) {
+    auto event = make_box_generator(3, state.range(0)).event()->make_disjoint();
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(CompiledEvent(static_cast<const Event &>(*event)));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(event->simple_sets->size()));
+}
+BENCHMARK(BM_CompileEvent)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventScanCompatible(benchmark::State &state) {
+    auto generator = make_box_generator(3, state.range(0));
+    auto event = generator.event();
+    auto partial_assignment = generator.simple_event();
+    partial_assignment->variable_map->erase(partial_assignment->variable_map->begin());
+    AllocationReport report(state);
+    for (auto _: state) {
+        std::size_t compatible = 0;
+        for (auto const &simple_set: *event->simple_sets) {
+            auto const &variable_map = *static_cast<SimpleEvent *>(simple_set.get())->variable_map;
+            bool intersects = true;
+            for (auto const &[variable, assignment]: *partial_assignment->variable_map) {
+                intersects = !variable_map.at(variable)->intersection_with(assignment)->is_empty();
+                if (!intersects) {
+                    break;
+                }
+            }
+            compatible += intersects;
+        }
+        benchmark::DoNotOptimize(compatible);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventScanCompatible)->RangeMultiplier(4)->Range(256, 16384)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventIndexCompatible(benchmark::State &state) {
+    auto generator = make_box_generator(3, state.range(0));
+    auto event = generator.event();
+    auto partial_assignment = generator.simple_event();
+    partial_assignment->variable_map->erase(partial_assignment->variable_map->begin());
+    EventIndex index(static_cast<const Event &>(*event));
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(index.compatible(*partial_assignment));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventIndexCompatible)->RangeMultiplier(4)->Range(256, 16384)->Unit(benchmark::kMicrosecond);
+
+static void BM_EventIntersectionNestedLoop(benchmark::State &state) {
+    auto [lhs, rhs] = make_join_events(state.range(0));
+    const auto pairs = static_cast<std::int64_t>(lhs->simple_sets->size() * rhs->simple_sets->size());
+    AllocationReport report(state);
+    for (auto _: state) {
+        std::vector<AbstractSimpleSetPtr_t> scratch;
+        for (auto const &a: *lhs->simple_sets) {
+            for (auto const &b: *rhs->simple_sets) {
+                auto intersection = a->intersection_with(b);
+                if (!intersection->is_empty()) {
+                    scratch.push_back(intersection);
+                }
+            }
+        }
+        auto result = make_shared_event();
+        result->simple_sets->insert(scratch.begin(), scratch.end());
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["pairs"] = static_cast<double>(pairs);
+    state.SetItemsProcessed(state.iterations() * pairs);
+}
+BENCHMARK(BM_EventIntersectionNestedLoop)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
+
+static void BM_EventIntersectionJoin(benchmark::State &state) {
+    auto [lhs, rhs] = make_join_events(state.range(0));
+    const auto pairs = static_cast<std::int64_t>(lhs->simple_sets->size() * rhs->simple_sets->size());
+    std::size_t size = 0;
+    AllocationReport report(state);
+    for (auto _: state) {
+        auto result = lhs->intersection_with(rhs->simple_sets);
+        size = result->simple_sets->size();
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["intersections"] = static_cast<double>(size);
+    state.SetItemsProcessed(state.iterations() * pairs);
+}
+BENCHMARK(BM_EventIntersectionJoin)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include "allocation_counter.h"
+#include "set.h"
+
+static void BM_SetComplement(benchmark::State &state) {
+    // every other element of a universe with state.range(0) elements
+    std::set<long long> universe;
+    for (long long i = 0; i < state.range(0); ++i) {
+        universe.insert(i);
+    }
+    auto all_elements = make_shared_all_elements(universe);
+    auto elements = make_shared_simple_set_set();
+    for (long long i = 0; i < state.range(0); i += 2) {
+        elements->insert(make_shared_set_element(static_cast<int>(i), all_elements));
+    }
+    auto set = make_shared_set(elements, all_elements);
+
+    AllocationReport report(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(set->complement());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetComplement)->RangeMultiplier(4)->Range(16, 65536);
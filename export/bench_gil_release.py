@@ -0,0 +1,57 @@
+"""
+Measure how the throughput of set operations scales with the number of Python threads.
+
+The operations release the GIL, hence the throughput should grow with the threads up to the number of cores.
+Run with ``python -m export.bench_gil_release [--operations N] [--events N]``.
+"""
+import argparse
+import os
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+from export import random_events_lib as re
+
+
+def make_events(event_count):
+    config = re.WorkloadConfig()
+    config.seed = 11
+    config.continuous_variables = 3
+    config.event_count = event_count
+    generator = re.WorkloadGenerator(config)
+    return generator.event(), generator.event()
+
+
+def throughput(operation, thread_count, operations):
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=thread_count) as executor:
+        for _ in executor.map(lambda _: operation(), range(operations)):
+            pass
+    return operations / (time.perf_counter() - start)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--operations", type=int, default=64, help="operations per measurement")
+    parser.add_argument("--events", type=int, default=8, help="simple events per operand")
+    arguments = parser.parse_args()
+
+    # one thread per operation, such that only the Python threads run in parallel
+    re.set_thread_count(1)
+    lhs, rhs = make_events(arguments.events)
+    operations = {
+        "union_with": lambda: lhs.union_with(rhs),
+        "difference_with": lambda: lhs.difference_with(rhs),
+        "complement": lambda: lhs.complement(),
+        "simplify": lambda: lhs.union_with(rhs).simplify(),
+    }
+
+    thread_counts = [count for count in (1, 2, 4, 8, 16) if count <= max(os.cpu_count() or 1, 1)]
+    print(f"{'operation':<16}" + "".join(f"{f'{count} threads':>14}" for count in thread_counts) + "   speedup")
+    for name, operation in operations.items():
+        results = [throughput(operation, count, arguments.operations) for count in thread_counts]
+        print(f"{name:<16}" + "".join(f"{f'{result:.1f}/s':>14}" for result in results) +
+              f"   {results[-1] / results[0]:.2f}x")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,37 @@
+"""
+Measure the cost of constructing set elements from Python for growing universes.
+
+Passing a Python set copies the universe on every call, while a Universe handle is shared, hence the construction
+cost with a handle does not depend on the size of the universe.
+Run with ``python -m export.bench_universe [--elements N]``.
+"""
+import argparse
+import time
+
+from export import random_events_lib as re
+
+
+def construction_time(universe, elements):
+    size = len(universe)
+    start = time.perf_counter()
+    for index in range(elements):
+        re.SetElement(index % size, universe)
+    return (time.perf_counter() - start) / elements
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--elements", type=int, default=100_000, help="set elements per measurement")
+    arguments = parser.parse_args()
+
+    print(f"{'universe size':>14}{'python set':>16}{'Universe':>16}")
+    for size in (10, 100, 1_000, 10_000):
+        elements = set(range(size))
+        # copying large universes is slow, hence fewer elements are constructed from sets
+        copied = construction_time(elements, max(arguments.elements // size, 100))
+        shared = construction_time(re.Universe(elements), arguments.elements)
+        print(f"{size:>14}{copied * 1e6:>13.2f} us{shared * 1e6:>13.2f} us")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,45 +1,142 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
+#include "pybind11/numpy.h"
 #include "interval.h"
 #include "product_algebra.h"
 #include "set.h"
+#include "thread_pool.h"
+#include "intern_table.h"
+#include "operation_cache.h"
+#include "operation_statistics.h"
+#include "tracing.h"
+#include "event_builder.h"
+#include "compiled_event.h"
+#include "event_index.h"
+#include "variable_registry.h"
+#include "workload_generator.h"
 
 namespace py = pybind11;
 
+/**
+ * Call guard that releases the GIL while a set operation runs.
+ *
+ * The guarded operations only read their operands and build new objects, and the state they share across threads
+ * (operation cache, intern table, thread pool, counters and tracer) is synchronized in C++. Methods that mutate an
+ * object (constructors, property setters, fill_missing_variables, add_new_simple_set) keep the GIL, such that Python
+ * threads cannot modify an operand while another thread reads it.
+ */
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
+/**
+ * Handle of a universe of set elements.
+ * Set elements, sets and variables that are created from the same handle share one universe instead of a copy each.
+ * Python sets are converted implicitly, which copies them once per call.
+ */
+struct Universe {
+    AllSetElementsPtr_t elements;
+};
+
+/**
+ * Read-only view of the variable map of a simple event. It shares the map instead of converting it to a dict.
+ */
+struct VariableMapView {
+    VariableMapPtr_t variable_map;
+};
+
 PYBIND11_MODULE(random_events_lib, handle) {
     handle.doc()= "A module for handling random events";
 
+    handle.def("set_thread_count", &set_thread_count, py::arg("thread_count"),
+               "Set the number of threads used by make_disjoint. 1 is sequential, 0 uses all hardware threads.");
+    handle.def("get_thread_count", &get_thread_count);
+    handle.def("intern", [](const AbstractCompositeSetPtr_t &composite_set) {
+        return InternTable::global().intern(composite_set);
+    }, py::arg("composite_set"), release_gil(), "Return the shared canonical instance of a composite set (hash-consing). The instance is frozen, i.e. it rejects "
+       "modification; modify a copy instead.");
+    handle.def("set_operation_cache_capacity", &set_operation_cache_capacity, py::arg("capacity"),
+               "Memoize up to capacity results of intersections, unions and complements. 0 disables the cache.");
+    handle.def("clear_operation_cache", &clear_operation_cache);
+    handle.def("operation_statistics", []() {
+        auto statistics = get_operation_statistics();
+        py::dict result;
+        result["simple_intersections"] = statistics.simple_intersections;
+        result["simple_complements"] = statistics.simple_complements;
+        result["empty_allocations"] = statistics.empty_allocations;
+        result["split_rounds"] = statistics.split_rounds;
+        result["simplify_passes"] = statistics.simplify_passes;
+        result["peak_simple_sets"] = statistics.peak_simple_sets;
+        return result;
+    }, "The operation counters summed over all threads.");
+    handle.def("reset_operation_statistics", &reset_operation_statistics);
+    handle.def("start_tracing", &start_tracing, py::arg("path"),
+               "Record spans of the expensive operations and write them to path (Chrome trace-event JSON) when "
+               "tracing is stopped.");
+    handle.def("stop_tracing", &stop_tracing, "Stop recording spans and write the trace file.");
+    handle.def("tracing_enabled", &tracing_enabled);
+    handle.def("operation_statistics_enabled", &operation_statistics_enabled,
+               "True if the library was built with operation counters (RANDOM_EVENTS_STATISTICS).");
+    handle.def("operation_cache_statistics", []() {
+        auto statistics = get_operation_cache_statistics();
+        py::dict result;
+        result["hits"] = statistics.hits;
+        result["misses"] = statistics.misses;
+        result["evictions"] = statistics.evictions;
+        result["size"] = statistics.size;
+        result["capacity"] = statistics.capacity;
+        return result;
+    });
+
+    auto memory_usage_dict = [](const MemoryUsage &usage) {
+        py::dict result;
+        result["total_bytes"] = usage.total_bytes;
+        result["unique_bytes"] = usage.unique_bytes;
+        return result;
+    };
+
     py::class_<AbstractSimpleSet, std::shared_ptr<AbstractSimpleSet>>(handle, "AbstractSimpleSet")
-        .def("intersection_with", &AbstractSimpleSet::intersection_with)
-        .def("complement", [](AbstractSimpleSet &x){return * x.complement();})
+        .def("intersection_with", &AbstractSimpleSet::intersection_with, release_gil())
+        .def("complement", [](AbstractSimpleSet &x){return * x.complement();}, release_gil())
         .def("contains", &AbstractSimpleSet::contains)
         .def("is_empty", &AbstractSimpleSet::is_empty)
-        .def("difference_with", [](AbstractSimpleSet &x, AbstractSimpleSet &y) {
-            auto const p = AbstractSimpleSetPtr_t(&y);
-            return *x.difference_with(p);
-        })
+        .def("difference_with", [](AbstractSimpleSet &x, const AbstractSimpleSetPtr_t &y) {
+            return *x.difference_with(y);
+        }, release_gil())
         .def ("__repr__", &AbstractSimpleSet::to_string)
         .def("__eq__", &AbstractSimpleSet::operator==)
+        .def("__hash__", &AbstractSimpleSet::hash)
+        .def("memory_usage", [memory_usage_dict](const AbstractSimpleSet &x) {
+            return memory_usage_dict(x.memory_usage());
+        }, "The estimated heap footprint in bytes. Shared substructures are counted once in total_bytes and not "
+           "at all in unique_bytes.")
+        .def("is_frozen", &AbstractSimpleSet::is_frozen)
         .def("__lt__", &AbstractSimpleSet::operator<);
 
 
     py::class_<AbstractCompositeSet, std::shared_ptr<AbstractCompositeSet>>(handle, "AbstractCompositeSet")
         .def_property("simple_sets",
             [](const AbstractCompositeSet &x){return *x.simple_sets;},
-            [](AbstractCompositeSet &x, SimpleSetSet_t const &v){x.simple_sets = make_shared_simple_set_set(v);})
+            [](AbstractCompositeSet &x, SimpleSetSet_t const &v){
+                x.check_mutable();
+                x.simple_sets = make_shared_simple_set_set(v);})
         .def("is_empty", &AbstractCompositeSet::is_empty)
-        .def("is_disjoint", &AbstractCompositeSet::is_disjoint)
-        .def("simplify", &AbstractCompositeSet::simplify)
-        .def("make_disjoint", &AbstractCompositeSet::make_disjoint)
-        .def("intersection_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::intersection_with), "Intersect this with another composite set.")
-        .def("intersection_with_simple_set", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::intersection_with), "Intersect this with another simple set.")
-        .def("complement", [](const AbstractCompositeSet &x){return x.complement();})
-        .def("union_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::union_with), "Union this with another composite set.")
-        .def("union_with", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::union_with), "Union this with a simple set.")
-        .def("difference_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::difference_with), "Difference this with another composite set.")
-        .def("difference_with", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::difference_with), "Difference this with a simple set.")
+        .def("is_disjoint", &AbstractCompositeSet::is_disjoint, release_gil())
+        .def("simplify", &AbstractCompositeSet::simplify, release_gil())
+        .def("make_disjoint", &AbstractCompositeSet::make_disjoint, release_gil())
+        .def("intersection_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::intersection_with), release_gil(), "Intersect this with another composite set.")
+        .def("intersection_with_simple_set", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::intersection_with), release_gil(), "Intersect this with another simple set.")
+        .def("complement", [](const AbstractCompositeSet &x){return x.complement();}, release_gil())
+        .def("union_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::union_with), release_gil(), "Union this with another composite set.")
+        .def("union_with", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::union_with), release_gil(), "Union this with a simple set.")
+        .def("difference_with", pybind11::overload_cast<const AbstractCompositeSetPtr_t&>(&AbstractCompositeSet::difference_with), release_gil(), "Difference this with another composite set.")
+        .def("difference_with", pybind11::overload_cast<const AbstractSimpleSetPtr_t&>(&AbstractCompositeSet::difference_with), release_gil(), "Difference this with a simple set.")
         .def("add_new_simple_set", &AbstractCompositeSet::add_new_simple_set)
+        .def("is_frozen", &AbstractCompositeSet::is_frozen)
         .def("__eq__", &AbstractCompositeSet::operator==)
+        .def("__hash__", &AbstractCompositeSet::hash)
+        .def("memory_usage", [memory_usage_dict](const AbstractCompositeSet &x) {
+            return memory_usage_dict(x.memory_usage());
+        }, "The estimated heap footprint in bytes. Shared substructures are counted once in total_bytes and not "
+           "at all in unique_bytes.")
         .def("__lt__", &AbstractCompositeSet::operator<);
 
 
@@ -65,14 +162,15 @@ PYBIND11_MODULE(random_events_lib, handle) {
 
             return std::make_shared<SimpleInterval>(lower, upper, x, y);
         }))
-        .def_readwrite("lower", &SimpleInterval::lower)
-        .def_readwrite("upper", &SimpleInterval::upper)
-        .def_readwrite("left", &SimpleInterval::left)
-        .def_readwrite("right", &SimpleInterval::right)
-        .def("__hash__", [](const SimpleInterval &interval) {
-            return std::hash<double>()(interval.lower) ^ std::hash<double>()(interval.upper) ^
-                   std::hash<int>()(static_cast<int>(interval.left)) ^ std::hash<int>()(static_cast<int>(interval.right));
-        });
+        .def_property("lower", [](const SimpleInterval &x){return x.lower;},
+            [](SimpleInterval &x, double v){x.check_mutable(); x.lower = v;})
+        .def_property("upper", [](const SimpleInterval &x){return x.upper;},
+            [](SimpleInterval &x, double v){x.check_mutable(); x.upper = v;})
+        .def_property("left", [](const SimpleInterval &x){return x.left;},
+            [](SimpleInterval &x, BorderType v){x.check_mutable(); x.left = v;})
+        .def_property("right", [](const SimpleInterval &x){return x.right;},
+            [](SimpleInterval &x, BorderType v){x.check_mutable(); x.right = v;})
+        .def("__hash__", &SimpleInterval::hash);
 
 
     py::class_<Interval, AbstractCompositeSet, std::shared_ptr<Interval>>(handle, "Interval")
@@ -84,7 +182,43 @@ PYBIND11_MODULE(random_events_lib, handle) {
         .def(py::init([](SimpleSetSet_t const &x) {
             auto p = std::make_shared<SimpleSetSet_t>(x);
             return std::make_shared<Interval>(p);
-        }));
+        }))
+        .def("contains_batch", [](const Interval &x, const py::array_t<double, py::array::c_style | py::array::forcecast> &points) {
+            const auto count = static_cast<std::size_t>(points.size());
+            auto mask = py::array_t<bool>(points.size());
+            const double *elements = points.data();
+            auto *result = reinterpret_cast<std::uint8_t *>(mask.mutable_data());
+            {
+                py::gil_scoped_release release;
+                x.contains(elements, count, result);
+            }
+            return mask;
+        }, "Check which values of a numpy array are contained in this. Returns a boolean array of the same length.")
+        .def_static("from_arrays", [](const py::array_t<double, py::array::c_style | py::array::forcecast> &lower,
+                                      const py::array_t<double, py::array::c_style | py::array::forcecast> &upper,
+                                      const py::array_t<bool, py::array::c_style | py::array::forcecast> &left_closed,
+                                      const py::array_t<bool, py::array::c_style | py::array::forcecast> &right_closed) {
+            const auto count = static_cast<std::size_t>(lower.size());
+            if (static_cast<std::size_t>(upper.size()) != count || static_cast<std::size_t>(left_closed.size()) != count ||
+                static_cast<std::size_t>(right_closed.size()) != count) {
+                throw std::invalid_argument("lower, upper, left_closed and right_closed must have the same length");
+            }
+            const double *lowers = lower.data(), *uppers = upper.data();
+            const auto *lefts = reinterpret_cast<const std::uint8_t *>(left_closed.data());
+            const auto *rights = reinterpret_cast<const std::uint8_t *>(right_closed.data());
+            py::gil_scoped_release release;
+            return Interval::from_arrays(lowers, uppers, lefts, rights, count);
+        }, py::arg("lower"), py::arg("upper"), py::arg("left_closed"), py::arg("right_closed"),
+           "Create a simplified interval from numpy columns of pieces, which may be unsorted or overlapping.")
+        .def("to_arrays", [](const Interval &x) {
+            const auto count = static_cast<py::ssize_t>(x.simple_sets->size());
+            py::array_t<double> lower(count), upper(count);
+            py::array_t<bool> left_closed(count), right_closed(count);
+            x.to_arrays(lower.mutable_data(), upper.mutable_data(),
+                        reinterpret_cast<std::uint8_t *>(left_closed.mutable_data()),
+                        reinterpret_cast<std::uint8_t *>(right_closed.mutable_data()));
+            return py::make_tuple(lower, upper, left_closed, right_closed);
+        }, "Return the simple intervals as numpy arrays (lower, upper, left_closed, right_closed).");
 
 
     handle.def("closed", &closed, "Create a closed interval");
@@ -96,43 +230,98 @@ PYBIND11_MODULE(random_events_lib, handle) {
     handle.def("reals", &reals, "Create the real line interval");
 
 
-    py::class_<SetElement, AbstractSimpleSet, std::shared_ptr<SetElement>>(handle, "SetElement")
+    py::class_<Universe>(handle, "Universe")
         .def(py::init([](std::set<long long> const &x) {
-            auto const p = make_shared_all_elements(x);
-            const auto set_element = SetElement(p);
-            return make_shared_set_element(set_element);
+            return Universe{make_shared_all_elements(x)};
         }))
-        .def(py::init([](int const &x, std::set<long long> const &y) {
-            auto const p = make_shared_all_elements(y);
-            const auto set_element = SetElement(x, p);
-            return make_shared_set_element(set_element);
+        .def(py::init([](const py::array_t<long long, py::array::c_style | py::array::forcecast> &x) {
+            return Universe{make_shared_all_elements(x.data(), x.data() + x.size())};
+        }))
+        .def("__len__", [](Universe const &x){return x.elements->size();})
+        .def("__contains__", [](Universe const &x, long long v){return x.elements->count(v) > 0;})
+        .def("__iter__", [](Universe const &x) {
+            return py::make_iterator(x.elements->begin(), x.elements->end());
+        }, py::keep_alive<0, 1>())
+        .def("__eq__", [](Universe const &x, Universe const &y) {
+            return x.elements == y.elements || *x.elements == *y.elements;
+        })
+        .def("__repr__", [](Universe const &x) {
+            return "Universe of " + std::to_string(x.elements->size()) + " elements";
+        })
+        .def("to_set", [](Universe const &x){return *x.elements;}, "Copy the elements into a Python set.");
+    py::implicitly_convertible<std::set<long long>, Universe>();
+
+
+    py::class_<SetElement, AbstractSimpleSet, std::shared_ptr<SetElement>>(handle, "SetElement")
+        .def(py::init([](Universe const &x) {
+            return make_shared_set_element(x.elements);
+        }))
+        .def(py::init([](int const &x, Universe const &y) {
+            return make_shared_set_element(x, y.elements);
         }))
         .def_property("element_index", [](SetElement const &x){return x.element_index;},
-            [](SetElement &x, int const &v){x.element_index = v;})
-        .def_property("all_elements", [](SetElement const &x){return *x.all_elements;},
-            [](SetElement &x, std::set<long long> const &v){x.all_elements = make_shared_all_elements(v);})
-        .def("__hash__", [](SetElement const &x) {
-            return std::hash<int>{}(x.element_index);
-        });
+            [](SetElement &x, int const &v){x.check_mutable(); x.element_index = v;})
+        .def_property("all_elements", [](SetElement const &x){return Universe{x.all_elements};},
+            [](SetElement &x, Universe const &v){x.check_mutable(); x.all_elements = v.elements;})
+        .def("__hash__", &SetElement::hash);
 
 
     py::class_<Set, AbstractCompositeSet, std::shared_ptr<Set>>(handle, "Set")
-        .def(py::init([] (std::set<long long> const &x) {
-            auto const p = make_shared_all_elements(x);
-            return std::make_shared<Set>(p);
+        .def(py::init([] (Universe const &x) {
+            return std::make_shared<Set>(x.elements);
         }))
-        .def(py::init([](SimpleSetSet_t const &x, std::set<long long> const &y) {
+        .def(py::init([](SimpleSetSet_t const &x, Universe const &y) {
             auto const p = make_shared_simple_set_set(x);
-            auto const q = make_shared_all_elements(y);
-            return std::make_shared<Set>(p, q);
+            return std::make_shared<Set>(p, y.elements);
         }))
-        .def(py::init([](SetElement const &x, std::set<long long> const &y) {
+        .def(py::init([](SetElement const &x, Universe const &y) {
             auto const q = std::make_shared<SetElement>(x);
-            auto const p = make_shared_all_elements(y);
-            return std::make_shared<Set>(q, p);
+            return std::make_shared<Set>(q, y.elements);
         }))
-        .def_property("all_elements", [](Set const &x){return *x.all_elements;},
-            [](Set &x, std::set<long long> const &v){x.all_elements = make_shared_all_elements(v);});
+        .def_property("all_elements", [](Set const &x){return Universe{x.all_elements};},
+            [](Set &x, Universe const &v){x.check_mutable(); x.all_elements = v.elements;})
+        .def("cardinality", &Set::cardinality, "The number of elements in this set.")
+        .def_static("from_indices", [](const py::array_t<long long, py::array::c_style | py::array::forcecast> &indices,
+                                       Universe const &all_elements) {
+            const long long *data = indices.data();
+            const auto count = static_cast<std::size_t>(indices.size());
+            py::gil_scoped_release release;
+            return Set::from_indices(data, count, all_elements.elements);
+        }, py::arg("indices"), py::arg("all_elements"),
+           "Create a set from a numpy array of element indices, which may be unsorted or contain duplicates.")
+        .def("to_indices", [](const Set &x) {
+            py::array_t<long long> indices(static_cast<py::ssize_t>(x.cardinality()));
+            x.to_indices(indices.mutable_data());
+            return indices;
+        }, "Return the element indices as sorted numpy array.");
+
+    py::class_<VariableMapView>(handle, "VariableMapView")
+        .def("__len__", [](VariableMapView const &x){return x.variable_map->size();})
+        .def("__contains__", [](VariableMapView const &x, AbstractVariablePtr_t const &v) {
+            return x.variable_map->count(v) > 0;
+        })
+        .def("__getitem__", [](VariableMapView const &x, AbstractVariablePtr_t const &v) {
+            auto const it = x.variable_map->find(v);
+            if (it == x.variable_map->end()) {
+                throw py::key_error(*v->name);
+            }
+            return it->second;
+        })
+        .def("__iter__", [](VariableMapView const &x) {
+            return py::make_key_iterator(x.variable_map->begin(), x.variable_map->end());
+        }, py::keep_alive<0, 1>())
+        .def("keys", [](VariableMapView const &x) {
+            return py::make_key_iterator(x.variable_map->begin(), x.variable_map->end());
+        }, py::keep_alive<0, 1>())
+        .def("values", [](VariableMapView const &x) {
+            return py::make_value_iterator(x.variable_map->begin(), x.variable_map->end());
+        }, py::keep_alive<0, 1>())
+        .def("items", [](VariableMapView const &x) {
+            return py::make_iterator(x.variable_map->begin(), x.variable_map->end());
+        }, py::keep_alive<0, 1>())
+        .def("to_dict", [](VariableMapView const &x){return *x.variable_map;},
+             "Copy the variable map into a Python dict.");
+
 
     py::class_<SimpleEvent, AbstractSimpleSet, std::shared_ptr<SimpleEvent>>(handle, "SimpleEvent")
         .def(py::init())
@@ -140,22 +329,26 @@ PYBIND11_MODULE(random_events_lib, handle) {
             auto p = std::make_shared<VariableMap>(x);
             return std::make_shared<SimpleEvent>(p);
         }))
+        .def(py::init([](VariableMapView const &x) {
+            auto p = std::make_shared<VariableMap>(*x.variable_map);
+            return std::make_shared<SimpleEvent>(p);
+        }))
         .def(py::init([](VariableSet const &x) {
             auto const p = make_shared_variable_set(x);
             return std::make_shared<SimpleEvent>(p);
         }))
-        .def_property("variable_map", [](SimpleEvent const &x){return * x.variable_map;},
-            [](SimpleEvent x, VariableMap const &v){x.variable_map = std::make_shared<VariableMap>(v);})
+        .def_property("variable_map", [](SimpleEvent const &x){return VariableMapView{x.variable_map};},
+            [](SimpleEvent &x, VariableMap const &v){
+                x.check_mutable();
+                x.variable_map = std::make_shared<VariableMap>(v);})
         .def("marginal", [](const SimpleEvent &x, VariableSet const &y) {
             auto const p = make_shared_variable_set(y);
             return x.marginal(p);
-        })
+        }, release_gil())
         .def("fill_missing_variables", [](const SimpleEvent &e, const VariableSet &v) {
             auto const p = make_shared_variable_set(v);
             e.fill_missing_variables(p);})
-        .def("__hash__", [](SimpleEvent const &x) {
-            return VariableMapHash{}(*x.variable_map);
-        });
+        .def("__hash__", &SimpleEvent::hash);
 
     py::class_<Event, AbstractCompositeSet, std::shared_ptr<Event>>(handle, "Event")
         .def(py::init())
@@ -167,7 +360,102 @@ PYBIND11_MODULE(random_events_lib, handle) {
             auto p = std::make_shared<SimpleEvent>(x);
             return make_shared_event(p);
         }))
-        .def("simplify_once", &Event::simplify_once)
+        .def_static("from_columns", [](const std::vector<AbstractVariablePtr_t> &variables, const py::list &columns) {
+            using DoubleColumn_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+            using BoolColumn_t = py::array_t<bool, py::array::c_style | py::array::forcecast>;
+            using IndexColumn_t = py::array_t<long long, py::array::c_style | py::array::forcecast>;
+            if (variables.size() != columns.size()) {
+                throw std::invalid_argument("every variable needs exactly one column");
+            }
+
+            // the converted arrays own the buffers that the builder reads
+            std::vector<std::vector<py::array>> arrays(variables.size());
+            for (std::size_t index = 0; index < variables.size(); ++index) {
+                if (dynamic_cast<Symbolic *>(variables[index].get())) {
+                    arrays[index].push_back(columns[index].cast<IndexColumn_t>());
+                    continue;
+                }
+                auto const parts = columns[index].cast<py::sequence>();
+                if (parts.size() != 2 && parts.size() != 4) {
+                    throw std::invalid_argument("the column of " + *variables[index]->name +
+                                                " must be (lower, upper) or (lower, upper, left_closed, right_closed)");
+                }
+                arrays[index].push_back(parts[0].cast<DoubleColumn_t>());
+                arrays[index].push_back(parts[1].cast<DoubleColumn_t>());
+                for (std::size_t part = 2; part < parts.size(); ++part) {
+                    arrays[index].push_back(parts[part].cast<BoolColumn_t>());
+                }
+            }
+            const auto rows = arrays.empty() ? 0 : static_cast<std::size_t>(arrays.front().front().size());
+            for (auto const &column: arrays) {
+                for (auto const &array: column) {
+                    if (static_cast<std::size_t>(array.size()) != rows) {
+                        throw std::invalid_argument("all columns must have the same length");
+                    }
+                }
+            }
+
+            EventBuilder builder(rows);
+            for (std::size_t index = 0; index < variables.size(); ++index) {
+                auto const &column = arrays[index];
+                if (column.size() == 1) {
+                    builder.add_set_column(variables[index], static_cast<const long long *>(column[0].data()));
+                } else {
+                    builder.add_interval_column(
+                            variables[index], static_cast<const double *>(column[0].data()),
+                            static_cast<const double *>(column[1].data()),
+                            column.size() == 4 ? static_cast<const std::uint8_t *>(column[2].data()) : nullptr,
+                            column.size() == 4 ? static_cast<const std::uint8_t *>(column[3].data()) : nullptr);
+                }
+            }
+            py::gil_scoped_release release;
+            return builder.build();
+        }, py::arg("variables"), py::arg("columns"),
+           "Build an event with one simple event per row. A continuous or integer variable takes a column "
+           "(lower, upper) or (lower, upper, left_closed, right_closed) of numpy arrays; a symbolic variable takes an "
+           "array of element indices into its domain. Rows with an empty assignment are skipped.")
+        .def("contains_batch", [](const Event &e, const std::vector<AbstractVariablePtr_t> &variables,
+                                  const py::list &columns) {
+            using DoubleColumn_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+            using IndexColumn_t = py::array_t<long long, py::array::c_style | py::array::forcecast>;
+            if (variables.size() != columns.size()) {
+                throw std::invalid_argument("every variable needs exactly one column");
+            }
+
+            // the columns are addressed by the position of their variable
+            VariableRegistry registry;
+            std::vector<py::array> arrays;
+            std::vector<PointColumn> point_columns(variables.size());
+            for (std::size_t index = 0; index < variables.size(); ++index) {
+                if (registry.register_variable(variables[index]) != index) {
+                    throw std::invalid_argument("variable " + *variables[index]->name + " has more than one column");
+                }
+                if (dynamic_cast<Symbolic *>(variables[index].get())) {
+                    arrays.push_back(columns[index].cast<IndexColumn_t>());
+                    point_columns[index].indices = static_cast<const long long *>(arrays.back().data());
+                } else {
+                    arrays.push_back(columns[index].cast<DoubleColumn_t>());
+                    point_columns[index].values = static_cast<const double *>(arrays.back().data());
+                }
+            }
+            const auto rows = arrays.empty() ? 0 : static_cast<std::size_t>(arrays.front().size());
+            for (auto const &array: arrays) {
+                if (static_cast<std::size_t>(array.size()) != rows) {
+                    throw std::invalid_argument("all columns must have the same length");
+                }
+            }
+
+            auto mask = py::array_t<bool>(static_cast<py::ssize_t>(rows));
+            auto *result = reinterpret_cast<std::uint8_t *>(mask.mutable_data());
+            {
+                py::gil_scoped_release release;
+                e.contains(registry, point_columns.data(), rows, result);
+            }
+            return mask;
+        }, py::arg("variables"), py::arg("columns"),
+           "Check a batch of points given as one numpy column per variable: values for continuous and integer "
+           "variables, element indices for symbolic variables. Returns a boolean array with one entry per row.")
+        .def("simplify_once", &Event::simplify_once, release_gil())
         .def("fill_missing_variables", [](const Event &e, const VariableSet &v) {
             auto const p = make_shared_variable_set(v);
             e.fill_missing_variables(p);
@@ -175,8 +463,96 @@ PYBIND11_MODULE(random_events_lib, handle) {
         .def("marginal", [](const Event &x, VariableSet const &y) {
             auto const p = make_shared_variable_set(y);
             return x.marginal(p);
-        });
+        }, release_gil());
+
+
+    py::class_<CompiledEvent, std::shared_ptr<CompiledEvent>>(handle, "CompiledEvent")
+        .def(py::init<const Event &>(), py::arg("event"), release_gil(),
+             "Compile an event into a decision tree for fast point membership.")
+        .def_property_readonly("variables", [](const CompiledEvent &x){return x.registry()->variables();},
+                               "The variables in the order of the values of a row.")
+        .def_property_readonly("depth", &CompiledEvent::depth)
+        .def_property_readonly("node_count", &CompiledEvent::node_count)
+        .def("contains", [](const CompiledEvent &x,
+                            const py::array_t<double, py::array::c_style | py::array::forcecast> &row) {
+            if (static_cast<std::size_t>(row.size()) != x.registry()->size()) {
+                throw std::invalid_argument("a row needs one value per variable");
+            }
+            return x.contains(row.data());
+        }, py::arg("row"), "Check if a row (one value per variable, element indices for symbolic variables) is "
+                           "contained in the event.")
+        .def("contains_batch", [](const CompiledEvent &x, const py::list &columns) {
+            using Column_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+            if (columns.size() != x.registry()->size()) {
+                throw std::invalid_argument("a batch needs one column per variable");
+            }
+            std::vector<Column_t> arrays;
+            std::vector<const double *> pointers;
+            for (auto const &column: columns) {
+                arrays.push_back(column.cast<Column_t>());
+                pointers.push_back(arrays.back().data());
+            }
+            const auto rows = arrays.empty() ? 0 : static_cast<std::size_t>(arrays.front().size());
+            for (auto const &array: arrays) {
+                if (static_cast<std::size_t>(array.size()) != rows) {
+                    throw std::invalid_argument("all columns must have the same length");
+                }
+            }
+            auto mask = py::array_t<bool>(static_cast<py::ssize_t>(rows));
+            auto *result = reinterpret_cast<std::uint8_t *>(mask.mutable_data());
+            {
+                py::gil_scoped_release release;
+                x.contains(pointers.data(), rows, result);
+            }
+            return mask;
+        }, py::arg("columns"), "Check a batch of rows given as one numpy column per variable. Returns a boolean "
+                               "array with one entry per row.");
+
+
+    auto bitset_positions = [](const DynamicBitset &bits) {
+        auto positions = py::array_t<long long>(static_cast<py::ssize_t>(bits.count()));
+        auto *data = positions.mutable_data();
+        bits.for_each_set_bit([&data](const std::size_t position) {*data++ = static_cast<long long>(position);});
+        return positions;
+    };
 
+    py::class_<EventIndex, std::shared_ptr<EventIndex>>(handle, "EventIndex")
+        .def(py::init<const Event &>(), py::arg("event"), release_gil(),
+             "Index the simple events of an event by the values of their variables.")
+        .def("__len__", &EventIndex::size)
+        .def_property_readonly("simple_events", &EventIndex::simple_events,
+                               "The indexed simple events in the order of the returned positions.")
+        .def("matching", [bitset_positions](const EventIndex &x, const AbstractVariablePtr_t &variable,
+                                            long long element) {
+            return bitset_positions(x.matching(variable, element));
+        }, py::arg("variable"), py::arg("element"),
+           "The positions of the simple events whose set of a symbolic variable contains an element index.")
+        .def("matching", [bitset_positions](const EventIndex &x, const AbstractVariablePtr_t &variable,
+                                            const Interval &range) {
+            return bitset_positions(x.matching(variable, range));
+        }, py::arg("variable"), py::arg("range"),
+           "The positions of the simple events whose interval of a variable intersects a range.")
+        .def("compatible", [bitset_positions](const EventIndex &x, const SimpleEvent &partial_assignment) {
+            DynamicBitset bits;
+            {
+                py::gil_scoped_release release;
+                bits = x.compatible(partial_assignment);
+            }
+            return bitset_positions(bits);
+        }, py::arg("partial_assignment"),
+           "The positions of the simple events that intersect a partial assignment.")
+        .def("select", [](const EventIndex &x, const py::array_t<long long, py::array::c_style | py::array::forcecast>
+                &positions) {
+            DynamicBitset bits(x.size());
+            for (py::ssize_t index = 0; index < positions.size(); ++index) {
+                const auto position = positions.data()[index];
+                if (position < 0 || static_cast<std::size_t>(position) >= x.size()) {
+                    throw std::invalid_argument("position " + std::to_string(position) + " is out of range");
+                }
+                bits.set(static_cast<std::size_t>(position));
+            }
+            return x.select(bits);
+        }, py::arg("positions"), "The event of the simple events at the given positions.");
 
     py::class_<AbstractVariable, std::shared_ptr<AbstractVariable>>(handle, "AbstractVariable")
         // .def("get_domain", &AbstractVariable::get_domain)
@@ -184,23 +560,24 @@ PYBIND11_MODULE(random_events_lib, handle) {
         .def("__lt__", &AbstractVariable::operator<)
         .def("__hash__", [](AbstractVariable const &x) {
             return std::hash<std::string>{}(*x.name);
+        })
+        .def("memory_usage", [memory_usage_dict](AbstractVariable const &x) {
+            return memory_usage_dict(x.memory_usage());
         });
 
     py::class_<Symbolic, AbstractVariable, std::shared_ptr<Symbolic>>(handle, "Symbolic")
-        .def(py::init([](std::string const &x, Set const &y) {
+        .def(py::init([](std::string const &x, SetPtr_t const &y) {
             auto const p = std::make_shared<std::string>(x);
-            auto const q = std::make_shared<Set>(y);
-            return std::make_shared<Symbolic>(p, q);
+            return std::make_shared<Symbolic>(p, y);
         }))
-        .def(py::init([](char* const x, Set const &y) {
+        .def(py::init([](char* const x, SetPtr_t const &y) {
             auto const p = std::make_shared<std::string>(x);
-            auto const q = std::make_shared<Set>(y);
-            return std::make_shared<Symbolic>(p, q);
+            return std::make_shared<Symbolic>(p, y);
         }))
         .def_property("name", [](Symbolic const &x){return *x.name;},
             [](Symbolic &x, std::string const &v){x.name = std::make_shared<std::string>(v);})
-        .def_property("domain", [](Symbolic const &x){return *x.domain;},
-            [](Symbolic &x, Set const &v){x.domain = std::make_shared<Set>(v);});
+        .def_property("domain", [](Symbolic const &x){return x.domain;},
+            [](Symbolic &x, SetPtr_t const &v){x.domain = v;});
 
 
     py::class_<Continuous, AbstractVariable, std::shared_ptr<Continuous>>(handle, "Continuous")
@@ -228,4 +605,28 @@ PYBIND11_MODULE(random_events_lib, handle) {
         .def_property("name", [](Integer const &x){return *x.name;},
             [](Integer &x, std::string const &v){x.name = std::make_shared<std::string>(v);});
 
+
+    py::class_<WorkloadConfig>(handle, "WorkloadConfig")
+        .def(py::init<>())
+        .def_readwrite("seed", &WorkloadConfig::seed)
+        .def_readwrite("continuous_variables", &WorkloadConfig::continuous_variables)
+        .def_readwrite("symbolic_variables", &WorkloadConfig::symbolic_variables)
+        .def_readwrite("integer_variables", &WorkloadConfig::integer_variables)
+        .def_readwrite("universe_size", &WorkloadConfig::universe_size)
+        .def_readwrite("pieces_per_interval", &WorkloadConfig::pieces_per_interval)
+        .def_readwrite("overlap_density", &WorkloadConfig::overlap_density)
+        .def_readwrite("event_count", &WorkloadConfig::event_count)
+        .def_readwrite("domain_width", &WorkloadConfig::domain_width);
+
+
+    py::class_<WorkloadGenerator, std::shared_ptr<WorkloadGenerator>>(handle, "WorkloadGenerator")
+        .def(py::init<const WorkloadConfig &>(), py::arg("config") = WorkloadConfig())
+        .def_property_readonly("config", &WorkloadGenerator::config)
+        .def_property_readonly("variables", [](WorkloadGenerator const &x){return *x.variables();})
+        .def_property_readonly("all_elements", [](WorkloadGenerator const &x){return Universe{x.all_elements()};})
+        .def("interval", pybind11::overload_cast<>(&WorkloadGenerator::interval))
+        .def("set", pybind11::overload_cast<>(&WorkloadGenerator::set))
+        .def("simple_event", &WorkloadGenerator::simple_event)
+        .def("event", &WorkloadGenerator::event);
+
 }
@@ -0,0 +1,43 @@
+import unittest
+
+import numpy as np
+
+from export import random_events_lib as re
+
+
+class ColumnsTestCase(unittest.TestCase):
+
+    def test_from_columns(self):
+        x = re.Continuous("x")
+        color = re.Symbolic("color", re.Set(re.Universe({0, 1, 2})))
+        lower = np.array([0., 2.])
+        upper = np.array([1., 3.])
+        event = re.Event.from_columns([x, color], [(lower, upper), np.array([0, 2])])
+        self.assertEqual(len(event.simple_sets), 2)
+
+        open_borders = np.array([False, False])
+        event = re.Event.from_columns([x], [(lower, upper, open_borders, open_borders)])
+        self.assertEqual(event, re.Event({re.SimpleEvent({x: re.open(0, 1)}), re.SimpleEvent({x: re.open(2, 3)})}))
+
+    def test_contains_batch(self):
+        x = re.Continuous("x")
+        color = re.Symbolic("color", re.Set(re.Universe({0, 1, 2})))
+        event = re.Event.from_columns([x, color], [(np.array([0., 2.]), np.array([1., 3.])), np.array([0, 2])])
+        mask = event.contains_batch([x, color], [np.array([0.5, 0.5, 2.5, 5.]), np.array([0, 2, 2, 2])])
+        self.assertEqual(mask.dtype, np.bool_)
+        self.assertEqual(mask.tolist(), [True, False, True, False])
+        with self.assertRaises(ValueError):
+            event.contains_batch([x], [np.zeros(2)])
+        with self.assertRaises(ValueError):
+            event.contains_batch([x, color], [np.zeros(2), np.zeros(3)])
+
+    def test_errors(self):
+        x = re.Continuous("x")
+        with self.assertRaises(ValueError):
+            re.Event.from_columns([x], [(np.zeros(2), np.zeros(3))])
+        with self.assertRaises(ValueError):
+            re.Event.from_columns([x], [])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,38 @@
+import unittest
+
+import numpy as np
+
+from export import random_events_lib as re
+
+
+class EventIndexTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.x = re.Continuous("x")
+        self.color = re.Symbolic("color", re.Set(re.Universe({0, 1, 2})))
+        self.event = re.Event.from_columns([self.x, self.color],
+                                           [(np.array([0., 2., 4.]), np.array([1., 3., 5.])), np.array([0, 1, 1])])
+        self.index = re.EventIndex(self.event)
+
+    def test_matching(self):
+        self.assertEqual(len(self.index), 3)
+        self.assertEqual(len(self.index.matching(self.color, 1)), 2)
+        self.assertEqual(len(self.index.matching(self.color, 2)), 0)
+        self.assertEqual(len(self.index.matching(self.x, re.closed(0.5, 2))), 2)
+
+    def test_compatible(self):
+        partial_assignment = re.SimpleEvent({self.x: re.closed(0.5, 4.5)})
+        positions = self.index.compatible(partial_assignment)
+        self.assertEqual(positions.dtype, np.int64)
+        self.assertEqual(len(positions), 3)
+        universe = self.color.domain.all_elements
+        partial_assignment = re.SimpleEvent({self.x: re.closed(2.5, 4.5),
+                                             self.color: re.Set(re.SetElement(1, universe), universe)})
+        selected = self.index.select(self.index.compatible(partial_assignment))
+        self.assertEqual(len(selected.simple_sets), 2)
+        with self.assertRaises(ValueError):
+            self.index.select(np.array([3]))
+
+
+if __name__ == '__main__':
+    unittest.main()
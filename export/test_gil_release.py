@@ -0,0 +1,62 @@
+import threading
+import time
+import unittest
+
+from export import random_events_lib as re
+
+
+def make_events(event_count):
+    config = re.WorkloadConfig()
+    config.seed = 3
+    config.continuous_variables = 2
+    config.symbolic_variables = 1
+    config.event_count = event_count
+    generator = re.WorkloadGenerator(config)
+    return generator.event(), generator.event()
+
+
+class GilReleaseTestCase(unittest.TestCase):
+
+    def test_concurrent_results(self):
+        lhs, rhs = make_events(4)
+        expected = (lhs.union_with(rhs), lhs.difference_with(rhs), lhs.complement(), lhs.union_with(rhs).simplify())
+        errors = []
+
+        def work():
+            for _ in range(5):
+                union = lhs.union_with(rhs)
+                result = (union, lhs.difference_with(rhs), lhs.complement(), union.simplify())
+                if result != expected:
+                    errors.append(result)
+
+        threads = [threading.Thread(target=work) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(errors, [])
+
+    def test_other_threads_progress(self):
+        lhs, _ = make_events(10)
+        start = time.perf_counter()
+        lhs.complement()
+        duration = time.perf_counter() - start
+        if duration < 0.05:
+            self.skipTest("the complement is too fast to observe the GIL")
+
+        worker = threading.Thread(target=lhs.complement)
+        worker.start()
+
+        # with the GIL held during the complement, this loop would stall for the whole operation
+        largest_gap = 0.
+        previous = time.perf_counter()
+        while worker.is_alive():
+            now = time.perf_counter()
+            largest_gap = max(largest_gap, now - previous)
+            previous = now
+        worker.join()
+        self.assertLess(largest_gap, duration / 2)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,45 @@
+import unittest
+
+from export import random_events_lib as re
+
+
+class ViewsTestCase(unittest.TestCase):
+
+    def test_universe(self):
+        universe = re.Universe({0, 1, 2})
+        a = re.SetElement(0, universe)
+        b = re.SetElement(2, universe)
+        self.assertEqual(len(a.all_elements), 3)
+        self.assertIn(2, b.all_elements)
+        self.assertEqual(a.all_elements, b.all_elements)
+        self.assertEqual(a.all_elements.to_set(), {0, 1, 2})
+        self.assertEqual(list(universe), [0, 1, 2])
+
+        # python sets are still accepted
+        c = re.SetElement(1, {0, 1, 2})
+        self.assertEqual(c.all_elements, universe)
+        self.assertEqual(re.Set(a, universe).all_elements, universe)
+
+    def test_variable_map(self):
+        x = re.Continuous("x")
+        y = re.Continuous("y")
+        interval = re.closed(0, 1)
+        simple_event = re.SimpleEvent({x: interval, y: re.closed(2, 3)})
+        view = simple_event.variable_map
+        self.assertEqual(len(view), 2)
+        self.assertIn(x, view)
+        self.assertEqual(view[x], interval)
+        self.assertEqual(list(view), [x, y])
+        self.assertEqual(len(view.to_dict()), 2)
+        with self.assertRaises(KeyError):
+            view[re.Continuous("z")]
+        self.assertEqual(re.SimpleEvent(view), simple_event)
+
+    def test_symbolic_domain_is_shared(self):
+        domain = re.Set(re.Universe({0, 1}))
+        variable = re.Symbolic("a", domain)
+        self.assertIs(variable.domain, domain)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ * The size of the first block of an operation arena in bytes.
+ */
+static constexpr std::size_t ARENA_INITIAL_SIZE = 64 * 1024;
+
+/**
+ * Memory resource that takes the blocks of an arena from the heap and remembers their address ranges.
+ */
+class ArenaBlocks : public std::pmr::memory_resource {
+public:
+
+    /**
+     * @param address The address.
+     * @return True if the address lies in one of the blocks.
+     */
+    bool contains(const void *address) const {
+        const auto *byte = static_cast<const char *>(address);
+        for (auto const &[begin, size]: blocks_) {
+            if (byte >= begin && byte < begin + size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<std::pair<const char *, std::size_t>> blocks_;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        auto result = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        blocks_.emplace_back(static_cast<const char *>(result), bytes);
+        return result;
+    }
+
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * Class that represents a monotonic memory arena for the temporaries of one set operation.
+ *
+ * Allocation is a pointer bump in the current block and deallocation does nothing.
+ * All memory is released at once when the arena is destroyed. The arena counts its references, which are the
+ * open OperationScope and every object allocated in it (see ArenaAllocator), and destroys itself when the last
+ * reference is released. Hence, objects that escape an operation stay valid.
+ *
+ * An arena is only allocated from by the thread that opened its OperationScope.
+ */
+class OperationArena {
+public:
+
+    explicit OperationArena(std::size_t initial_size = ARENA_INITIAL_SIZE) : resource_(initial_size, &blocks_) {
+        ++alive_;
+    }
+
+    ~OperationArena() {
+        --alive_;
+    }
+
+    OperationArena(const OperationArena &) = delete;
+
+    OperationArena &operator=(const OperationArena &) = delete;
+
+    void *allocate(std::size_t bytes, std::size_t alignment) {
+        allocated_bytes_ += bytes;
+        return resource_.allocate(bytes, alignment);
+    }
+
+    void acquire() {
+        references_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    /**
+     * @return The number of bytes handed out by this arena.
+     */
+    std::size_t allocated_bytes() const {
+        return allocated_bytes_;
+    }
+
+    /**
+     * @param address The address of an object.
+     * @return True if the object is allocated in this arena.
+     */
+    bool owns(const void *address) const {
+        return blocks_.contains(address);
+    }
+
+    /**
+     * @return The arena of the open operation scope of this thread or nullptr.
+     */
+    static OperationArena *current();
+
+    /**
+     * @return The number of arenas that are not destroyed yet.
+     */
+    static std::size_t alive() {
+        return alive_;
+    }
+
+private:
+    ArenaBlocks blocks_;
+    std::pmr::monotonic_buffer_resource resource_;
+    std::size_t allocated_bytes_ = 0;
+    std::atomic<std::size_t> references_{0};
+    static inline std::atomic<std::size_t> alive_{0};
+};
+
+/**
+ * Allocator that allocates from an operation arena. Every allocation holds a reference to the arena.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    OperationArena *arena;
+
+    explicit ArenaAllocator(OperationArena *arena_) noexcept: arena(arena_) {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena(other.arena) {
+    }
+
+    T *allocate(std::size_t count) {
+        auto result = static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T)));
+        arena->acquire();
+        return result;
+    }
+
+    void deallocate(T *, std::size_t) noexcept {
+        arena->release();
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept {
+        return arena == other.arena;
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const noexcept {
+        return arena != other.arena;
+    }
+};
+
+/**
+ * Class that marks the extent of a set operation whose temporaries are allocated in an arena.
+ *
+ * The outermost scope of a thread creates the arena and makes it current, nested scopes reuse it.
+ * Before the outermost scope closes, the result of the operation is promoted to the heap (see
+ * AbstractCompositeSet::promote), such that it does not keep the temporaries alive.
+ */
+class OperationScope {
+public:
+
+    OperationScope();
+
+    ~OperationScope();
+
+    OperationScope(const OperationScope &) = delete;
+
+    OperationScope &operator=(const OperationScope &) = delete;
+
+    /**
+     * @return True if this scope created the arena and is not closed yet.
+     */
+    bool is_outermost() const {
+        return outermost_;
+    }
+
+    /**
+     * Stop allocating in the arena. Only has an effect for the outermost scope.
+     */
+    void close();
+
+private:
+    bool outermost_;
+};
+
+/**
+ * Class that suspends the arena of the open operation scope of this thread, such that objects that must outlive the
+ * operation (e.g. entries of an InternTable) are allocated on the heap.
+ */
+class ArenaSuspension {
+public:
+
+    ArenaSuspension();
+
+    ~ArenaSuspension();
+
+    ArenaSuspension(const ArenaSuspension &) = delete;
+
+    ArenaSuspension &operator=(const ArenaSuspension &) = delete;
+
+private:
+    OperationArena *suspended_;
+};
+
+/**
+ * Enable or disable arenas for set operations. Arenas are enabled by default.
+ * @param enabled True to enable.
+ */
+void set_arenas_enabled(bool enabled);
+
+/**
+ * @return True if set operations allocate their temporaries in arenas.
+ */
+bool get_arenas_enabled();
+
+/**
+ * Create a shared object in the arena of the current operation scope or on the heap if there is none.
+ *
+ * @tparam T The type of the object.
+ * @param args The arguments of the constructor.
+ * @return The shared object.
+ */
+template<typename T, typename... Args>
+std::shared_ptr<T> make_shared_in_scope(Args &&... args) {
+    auto arena = OperationArena::current();
+    if (arena) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
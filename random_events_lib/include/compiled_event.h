@@ -0,0 +1,158 @@
+#pragma once
+
+#include "product_algebra.h"
+#include "variable_registry.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * The number of simple events of a node below which CompiledEvent stops splitting and checks them directly.
+ */
+static constexpr std::size_t COMPILED_EVENT_LEAF_SIZE = 2;
+
+/**
+ * The maximal depth of the decision tree of a CompiledEvent.
+ */
+static constexpr std::size_t COMPILED_EVENT_MAX_DEPTH = 48;
+
+/**
+ * The number of extra references per simple event that the leaves of a CompiledEvent may hold, because simple events
+ * that cross a threshold are stored on both sides. Nodes that would exceed it become leaves.
+ */
+static constexpr std::size_t COMPILED_EVENT_DUPLICATION = 8;
+
+/**
+ * The number of rows per task of CompiledEvent::contains for batches.
+ */
+static constexpr std::size_t COMPILED_EVENT_GRAIN = 4096;
+
+/**
+ * Class that represents an immutable, compiled point-membership predicate of an Event.
+ *
+ * A row is a value per variable, addressed by the IDs of registry(). Continuous and integer variables take their
+ * value, symbolic variables the index of the element in the universe of their domain.
+ *
+ * Every simple event is flattened to one sorted array of pieces (see FlatInterval) per variable; the elements of sets
+ * are pieces [index, index]. The simple events are then partitioned by a decision tree whose nodes compare one value
+ * against a threshold, such that a lookup walks one path of the tree and checks the few simple events of its leaf.
+ * Simple events that cross a threshold are stored in both subtrees.
+ *
+ * All data lives in flat vectors, so a compiled event can be shared between threads.
+ */
+class CompiledEvent {
+public:
+
+    /**
+     * Compile an event.
+     *
+     * @param event The event. Variables that a simple event does not assign are unconstrained.
+     */
+    explicit CompiledEvent(const Event &event);
+
+    /**
+     * @return The registry that maps the variables of the event to their position in a row.
+     */
+    const VariableRegistryPtr_t &registry() const {
+        return registry_;
+    }
+
+    /**
+     * @return The number of inner nodes of the decision tree.
+     */
+    std::size_t node_count() const {
+        return nodes_.size();
+    }
+
+    /**
+     * @return The length of the longest path from the root to a leaf.
+     */
+    std::size_t depth() const {
+        return depth_;
+    }
+
+    /**
+     * @param row Pointer to one value per variable, indexed by variable ID.
+     * @return True if the row is contained in the event.
+     */
+    bool contains(const double *row) const;
+
+    /**
+     * Check a batch of rows in columnar layout. Large batches are split over the shared thread pool.
+     *
+     * @param columns Pointer to one column per variable, indexed by variable ID. Each column has `rows` values.
+     * @param rows The number of rows.
+     * @param mask Pointer to `rows` bytes. Byte `i` is set to 1 if row `i` is contained and to 0 otherwise.
+     */
+    void contains(const double *const *columns, std::size_t rows, std::uint8_t *mask) const;
+
+private:
+
+    /**
+     * Inner node of the decision tree. Rows with a value less than the threshold continue at `children[0]`,
+     * all others at `children[1]`. Non-negative children are nodes, negative children `c` are the leaves `~c`.
+     */
+    struct Node {
+        double threshold;
+        std::uint32_t variable;
+        std::int32_t children[2];
+    };
+
+    VariableRegistryPtr_t registry_;
+
+    /**
+     * The number of flattened simple events.
+     */
+    std::size_t box_count_ = 0;
+
+    /**
+     * The pieces of simple event `b` and variable `v` are `[box_offsets_[b * V + v], box_offsets_[b * V + v + 1])`.
+     */
+    std::vector<std::uint32_t> box_offsets_;
+    std::vector<double> lowers_;
+    std::vector<double> uppers_;
+    std::vector<std::uint8_t> borders_;
+
+    std::vector<Node> nodes_;
+
+    /**
+     * The simple events of leaf `l` are `leaf_boxes_[leaf_offsets_[l], leaf_offsets_[l + 1])`.
+     */
+    std::vector<std::uint32_t> leaf_offsets_{0};
+    std::vector<std::uint32_t> leaf_boxes_;
+
+    std::int32_t root_ = -1;
+    std::size_t depth_ = 0;
+
+    /**
+     * The number of references that splits may still duplicate while building.
+     */
+    std::size_t duplication_budget_ = 0;
+
+    /**
+     * Recursively build the subtree of a set of simple events.
+     * @return The reference of the subtree (see Node::children).
+     */
+    std::int32_t build(std::vector<std::uint32_t> boxes, std::size_t depth);
+
+    /**
+     * @return The reference of a new leaf that contains the given simple events.
+     */
+    std::int32_t make_leaf(const std::vector<std::uint32_t> &boxes);
+
+    /**
+     * @return True if a simple event has a value of the variable less than the threshold.
+     */
+    bool reaches_below(std::uint32_t box, std::uint32_t variable, double threshold) const;
+
+    /**
+     * @return True if a simple event has a value of the variable greater than or equal to the threshold.
+     */
+    bool reaches_above(std::uint32_t box, std::uint32_t variable, double threshold) const;
+
+    /**
+     * Walk the tree and check the leaf.
+     * @param value Function that returns the value of a variable ID.
+     */
+    template<typename Value>
+    bool contains_values(const Value &value) const;
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "product_algebra.h"
+#include "variable_registry.h"
+#include <vector>
+
+// FORWARD DECLARATIONS
+class DenseSimpleEvent;
+class DenseEvent;
+
+// TYPEDEFS
+using Assignments_t = std::vector<AbstractCompositeSetPtr_t>;
+using DenseSimpleEventPtr_t = std::shared_ptr<DenseSimpleEvent>;
+using DenseEventPtr_t = std::shared_ptr<DenseEvent>;
+
+template<typename... Args>
+DenseSimpleEventPtr_t make_shared_dense_simple_event(Args &&... args) {
+    return make_shared_in_scope<DenseSimpleEvent>(std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+DenseEventPtr_t make_shared_dense_event(Args &&... args) {
+    return make_shared_in_scope<DenseEvent>(std::forward<Args>(args)...);
+}
+
+/**
+ * Class that represents a simple event whose assignments are stored in a flat vector indexed by variable ID.
+ *
+ * All dense simple events that interact with each other have to be built against the same VariableRegistry.
+ * Slot `i` holds the assignment of the variable with ID `i`. Variables that were registered after this event was
+ * created have no slot yet and are treated as assigned to their domain.
+ * Binary operations therefore are elementwise loops over aligned slots instead of merges of ordered maps.
+ *
+ * SimpleEvent and Event never use this representation on their own. Only callers that convert explicitly (see the
+ * constructors and to_simple_event) use it.
+ */
+class DenseSimpleEvent : public AbstractSimpleSet {
+public:
+
+    /**
+     * The registry that defines the meaning of the slots.
+     */
+    VariableRegistryPtr_t registry;
+
+    /**
+     * The assignments, indexed by variable ID.
+     */
+    Assignments_t assignments;
+
+    /**
+     * Create a dense simple event where every registered variable is assigned to its domain.
+     * @param registry_ The registry.
+     */
+    explicit DenseSimpleEvent(const VariableRegistryPtr_t &registry_);
+
+    /**
+     * Create a dense simple event from given assignments.
+     * @param registry_ The registry.
+     * @param assignments_ The assignments, indexed by variable ID.
+     */
+    DenseSimpleEvent(const VariableRegistryPtr_t &registry_, Assignments_t assignments_);
+
+    /**
+     * Create a dense simple event from a simple event. Unknown variables are registered.
+     * @param registry_ The registry.
+     * @param simple_event The simple event.
+     */
+    DenseSimpleEvent(const VariableRegistryPtr_t &registry_, const SimpleEvent &simple_event);
+
+    /**
+     * @param id The variable ID.
+     * @return The assignment of the variable, which is its domain if this has no slot for it.
+     */
+    AbstractCompositeSetPtr_t assignment(std::size_t id) const;
+
+    /**
+     * @return This as simple event with an ordered variable map.
+     */
+    SimpleEventPtr_t to_simple_event() const;
+
+    AbstractSimpleSetPtr_t intersection_with_impl(const AbstractSimpleSetPtr_t &other) override;
+
+    SimpleSetSetPtr_t complement_impl() override;
+
+    bool contains(const ElementaryVariant *element) override;
+
+    bool is_empty() override;
+
+    std::string *non_empty_to_string() override;
+
+    bool operator==(const AbstractSimpleSet &other) override;
+
+    /**
+     * Compare two dense simple events lexicographically by their assignments in ID order.
+     * If the registry was created from a variable set, this is the same order as for simple events.
+     */
+    bool operator<(const AbstractSimpleSet &other) override;
+
+    /**
+     * Hash the slots that are not assigned to the domain of their variable, together with their IDs.
+     * Equal dense simple events therefore have equal hashes, independent of their number of slots and of variables
+     * that are registered later.
+     */
+    std::size_t compute_hash() const override;
+
+    /**
+     * Append the bounding range of the assignment of every registered variable in ID order.
+     */
+    bool bounding_box(BoundingBox_t &box) override;
+
+    AbstractSimpleSetPtr_t deep_copy() override;
+
+    AbstractSimpleSetPtr_t shallow_copy() override;
+
+    /**
+     * Promote the assignments that are allocated in the arena and share the others.
+     */
+    AbstractSimpleSetPtr_t promote(const OperationArena &arena) override;
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
+};
+
+/**
+ * Class that represents an event made of dense simple events that share one VariableRegistry.
+ * Like DenseSimpleEvent, it is only used by callers that convert an Event explicitly (see the constructors and
+ * to_event).
+ */
+class DenseEvent : public AbstractCompositeSet {
+public:
+
+    /**
+     * The registry of all contained dense simple events.
+     */
+    VariableRegistryPtr_t registry;
+
+    explicit DenseEvent(const VariableRegistryPtr_t &registry_);
+
+    DenseEvent(const VariableRegistryPtr_t &registry_, const SimpleSetSetPtr_t &dense_simple_events);
+
+    /**
+     * Create a dense event from an event. Unknown variables are registered.
+     * @param registry_ The registry.
+     * @param event The event.
+     */
+    DenseEvent(const VariableRegistryPtr_t &registry_, const Event &event);
+
+    /**
+     * @return This as event of simple events with ordered variable maps.
+     */
+    EventPtr_t to_event() const;
+
+    /**
+     * Merge dense simple events that differ in exactly one slot until no such pair is left.
+     * Uses the signature grouping of simplify_by_signature.
+     *
+     * @return The simplified dense event.
+     */
+    AbstractCompositeSetPtr_t simplify() override;
+
+    AbstractCompositeSetPtr_t make_new_empty() const override;
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
+};
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Count the set bits of a word.
+ * @param word The word.
+ * @return The number of set bits.
+ */
+inline std::size_t popcount64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+    std::size_t count = 0;
+    while (word) {
+        word &= word - 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * Index of the lowest set bit of a non-zero word.
+ * @param word The word.
+ * @return The index of the lowest set bit.
+ */
+inline std::size_t lowest_bit64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    std::size_t index = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Index of the highest set bit of a non-zero word.
+ * @param word The word.
+ * @return The index of the highest set bit.
+ */
+inline std::size_t highest_bit64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<std::size_t>(__builtin_clzll(word));
+#else
+    std::size_t index = 0;
+    while (word >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Class that represents a fixed-size set of bits, stored as contiguous 64-bit words.
+ *
+ * All set operations are word-wise. Bits beyond `size()` in the last word are always kept cleared, such that
+ * equality and cardinality can be computed on whole words.
+ */
+class DynamicBitset {
+public:
+
+    /**
+     * Construct a bitset with `size` cleared bits.
+     * @param size The number of bits.
+     */
+    explicit DynamicBitset(std::size_t size = 0) : size_(size), words_((size + 63) / 64, 0) {
+    }
+
+    /**
+     * @return The number of bits.
+     */
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @return The underlying words.
+     */
+    const std::vector<std::uint64_t> &words() const {
+        return words_;
+    }
+
+    void set(std::size_t index) {
+        words_[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+
+    void reset(std::size_t index) {
+        words_[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+    }
+
+    bool test(std::size_t index) const {
+        return (words_[index / 64] >> (index % 64)) & 1;
+    }
+
+    /**
+     * @return The number of set bits.
+     */
+    std::size_t count() const {
+        std::size_t result = 0;
+        for (const auto word: words_) {
+            result += popcount64(word);
+        }
+        return result;
+    }
+
+    /**
+     * @return True if any bit is set.
+     */
+    bool any() const {
+        return std::any_of(words_.begin(), words_.end(), [](const std::uint64_t word) { return word != 0; });
+    }
+
+    /**
+     * @return True if no bit is set.
+     */
+    bool none() const {
+        return !any();
+    }
+
+    /**
+     * Find the next set bit.
+     * @param index The index to start searching from (inclusive).
+     * @return The index of the next set bit or `size()` if there is none.
+     */
+    std::size_t find_next(std::size_t index) const {
+        if (index >= size_) {
+            return size_;
+        }
+        std::size_t word_index = index / 64;
+        std::uint64_t word = words_[word_index] & (~std::uint64_t{0} << (index % 64));
+        while (word == 0) {
+            if (++word_index == words_.size()) {
+                return size_;
+            }
+            word = words_[word_index];
+        }
+        return word_index * 64 + lowest_bit64(word);
+    }
+
+    /**
+     * @return The index of the highest set bit or `size()` if there is none.
+     */
+    std::size_t find_last() const {
+        for (std::size_t word_index = words_.size(); word_index-- > 0;) {
+            if (words_[word_index] != 0) {
+                return word_index * 64 + highest_bit64(words_[word_index]);
+            }
+        }
+        return size_;
+    }
+
+    /**
+     * Change the number of bits. New bits are cleared and bits beyond the new size are dropped.
+     * @param size The new number of bits.
+     */
+    void resize(std::size_t size) {
+        size_ = size;
+        words_.resize((size + 63) / 64, 0);
+        clear_unused_bits();
+    }
+
+    /**
+     * Call a function for every set bit in ascending order.
+     * @param function The function that is called with the index of each set bit.
+     */
+    template<typename Function>
+    void for_each_set_bit(Function &&function) const {
+        for (std::size_t word_index = 0; word_index < words_.size(); ++word_index) {
+            std::uint64_t word = words_[word_index];
+            while (word) {
+                function(word_index * 64 + lowest_bit64(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    /**
+     * Flip every bit, i.e. form the complement with respect to `size()` bits.
+     */
+    DynamicBitset &flip() {
+        for (auto &word: words_) {
+            word = ~word;
+        }
+        clear_unused_bits();
+        return *this;
+    }
+
+    DynamicBitset &operator&=(const DynamicBitset &other) {
+        const std::size_t common = std::min(words_.size(), other.words_.size());
+        for (std::size_t index = 0; index < common; ++index) {
+            words_[index] &= other.words_[index];
+        }
+        std::fill(words_.begin() + static_cast<std::ptrdiff_t>(common), words_.end(), 0);
+        return *this;
+    }
+
+    DynamicBitset &operator|=(const DynamicBitset &other) {
+        const std::size_t common = std::min(words_.size(), other.words_.size());
+        for (std::size_t index = 0; index < common; ++index) {
+            words_[index] |= other.words_[index];
+        }
+        clear_unused_bits();
+        return *this;
+    }
+
+    /**
+     * Remove all bits that are set in another bitset (set difference).
+     */
+    DynamicBitset &operator-=(const DynamicBitset &other) {
+        const std::size_t common = std::min(words_.size(), other.words_.size());
+        for (std::size_t index = 0; index < common; ++index) {
+            words_[index] &= ~other.words_[index];
+        }
+        return *this;
+    }
+
+    /**
+     * Keep the bits that are set in exactly one of both bitsets (symmetric difference).
+     */
+    DynamicBitset &operator^=(const DynamicBitset &other) {
+        const std::size_t common = std::min(words_.size(), other.words_.size());
+        for (std::size_t index = 0; index < common; ++index) {
+            words_[index] ^= other.words_[index];
+        }
+        clear_unused_bits();
+        return *this;
+    }
+
+    bool operator==(const DynamicBitset &other) const {
+        return size_ == other.size_ and words_ == other.words_;
+    }
+
+    bool operator!=(const DynamicBitset &other) const {
+        return !(*this == other);
+    }
+
+private:
+    std::size_t size_;
+    std::vector<std::uint64_t> words_;
+
+    void clear_unused_bits() {
+        if (size_ % 64 != 0) {
+            words_.back() &= (std::uint64_t{1} << (size_ % 64)) - 1;
+        }
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "interval.h"
+#include "product_algebra.h"
+#include "set.h"
+#include "variable.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Class that builds an Event from columnar data, e.g. the columns of a data frame with one row per simple event.
+ *
+ * Every continuous or integer variable is described by a column of lower and a column of upper bounds and every
+ * symbolic variable by a column of element indices into its domain. All columns have one entry per row and are read
+ * through raw pointers, which have to stay valid until build() returns.
+ *
+ * The simple events assign exactly the variables of the columns, hence no fill_missing_variables pass is needed.
+ * The rows are inserted as given; rows that may overlap have to be made disjoint afterwards.
+ */
+class EventBuilder {
+public:
+
+    /**
+     * @param rows The number of rows, i.e. the length of every column.
+     */
+    explicit EventBuilder(std::size_t rows);
+
+    /**
+     * @return The number of rows.
+     */
+    std::size_t rows() const {
+        return rows_;
+    }
+
+    /**
+     * Add the columns of a continuous or integer variable.
+     *
+     * @param variable The variable.
+     * @param lowers Pointer to the lower bounds.
+     * @param uppers Pointer to the upper bounds.
+     * @param left_closed Pointer to bytes that are non-zero for closed left borders, or nullptr if all are closed.
+     * @param right_closed Pointer to bytes that are non-zero for closed right borders, or nullptr if all are closed.
+     * @throws std::invalid_argument If the variable is symbolic or already has a column.
+     */
+    void add_interval_column(const AbstractVariablePtr_t &variable, const double *lowers, const double *uppers,
+                             const std::uint8_t *left_closed = nullptr, const std::uint8_t *right_closed = nullptr);
+
+    /**
+     * Add the column of a symbolic variable. Every row is assigned the set of one element of the domain.
+     *
+     * @param variable The variable.
+     * @param indices Pointer to the element indices into the universe of the domain of the variable.
+     * @throws std::invalid_argument If the variable is not symbolic or already has a column.
+     */
+    void add_set_column(const AbstractVariablePtr_t &variable, const long long *indices);
+
+    /**
+     * Build the event. Rows with an empty assignment are skipped.
+     *
+     * @return The event.
+     * @throws std::invalid_argument If an element index is not in the universe of its variable.
+     */
+    EventPtr_t build() const;
+
+private:
+
+    /**
+     * The columns of one variable.
+     */
+    struct Column {
+        AbstractVariablePtr_t variable;
+        const double *lowers = nullptr;
+        const double *uppers = nullptr;
+        const std::uint8_t *left_closed = nullptr;
+        const std::uint8_t *right_closed = nullptr;
+        const long long *indices = nullptr;
+        AllSetElementsPtr_t all_elements;
+    };
+
+    std::size_t rows_;
+
+    /**
+     * The columns, sorted by variable such that the variable maps can be filled in order.
+     */
+    std::vector<Column> columns_;
+
+    /**
+     * Insert a column at its sorted position.
+     */
+    void insert_column(Column column);
+
+    /**
+     * @return The assignment of a column in a row.
+     */
+    AbstractCompositeSetPtr_t assignment(const Column &column, std::size_t row) const;
+};
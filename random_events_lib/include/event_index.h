@@ -0,0 +1,158 @@
+#pragma once
+
+#include "dynamic_bitset.h"
+#include "flat_interval.h"
+#include "product_algebra.h"
+#include "variable_registry.h"
+#include <cstdint>
+#include <vector>
+
+// FORWARD DECLARATIONS
+class EventIndex;
+
+// TYPEDEFS
+using EventIndexPtr_t = std::shared_ptr<EventIndex>;
+
+template<typename... Args>
+EventIndexPtr_t make_shared_event_index(Args &&... args) {
+    return std::make_shared<EventIndex>(std::forward<Args>(args)...);
+}
+
+/**
+ * Class that represents an immutable inverted index from (variable, value) to the simple events of an Event.
+ *
+ * The simple events are numbered in the iteration order of the event at construction time, and every query returns
+ * the bitmap of the numbers of the matching simple events. A symbolic variable maps each element index of its
+ * universe to the bitmap of the simple events whose set contains it. Every other variable holds an interval tree over
+ * the pieces of all its assignments. Simple events that do not assign a variable are unconstrained in it and match
+ * every value. Queries over several variables intersect the bitmaps of the single variables.
+ *
+ * The index references the simple events but does not observe later modifications of the event.
+ */
+class EventIndex {
+public:
+
+    /**
+     * Index the simple events of an event.
+     *
+     * @param event The event.
+     * @throws std::invalid_argument If an assignment is neither an Interval nor a Set.
+     */
+    explicit EventIndex(const Event &event);
+
+    /**
+     * @return The number of indexed simple events.
+     */
+    std::size_t size() const {
+        return simple_events_.size();
+    }
+
+    /**
+     * @return The indexed simple events, in the order of the bits of all results.
+     */
+    const std::vector<SimpleEventPtr_t> &simple_events() const {
+        return simple_events_;
+    }
+
+    /**
+     * @return The registry of all variables that some simple event assigns.
+     */
+    const VariableRegistryPtr_t &registry() const {
+        return registry_;
+    }
+
+    /**
+     * Find the simple events whose set of a symbolic variable contains an element.
+     *
+     * @param variable The symbolic variable.
+     * @param element The index of the element in the universe of the domain of the variable.
+     * @return The bitmap of the matching simple events.
+     * @throws std::invalid_argument If the variable is indexed and not symbolic.
+     */
+    DynamicBitset matching(const AbstractVariablePtr_t &variable, long long element) const;
+
+    /**
+     * Find the simple events whose interval of a variable intersects a range.
+     *
+     * @param variable The continuous or integer variable.
+     * @param range The range.
+     * @return The bitmap of the matching simple events.
+     * @throws std::invalid_argument If the variable is indexed and symbolic.
+     */
+    DynamicBitset matching(const AbstractVariablePtr_t &variable, const Interval &range) const;
+
+    /**
+     * Find the simple events that are compatible with a partial assignment, i.e. whose intersection with it is not
+     * empty. Variables that the partial assignment does not mention are unconstrained, and a partial assignment with an
+     * empty assignment is compatible with no simple event.
+     *
+     * @param partial_assignment The partial assignment.
+     * @return The bitmap of the compatible simple events.
+     */
+    DynamicBitset compatible(const SimpleEvent &partial_assignment) const;
+
+    /**
+     * @param simple_events A bitmap of simple events, e.g. the result of a query.
+     * @return The event that consists of the selected simple events. The simple events are shared.
+     */
+    EventPtr_t select(const DynamicBitset &simple_events) const;
+
+private:
+
+    /**
+     * The index of one variable. Symbolic variables fill `elements`, all others the interval tree.
+     *
+     * The interval tree is implicit: the pieces are sorted by their lower bound, the subtree of the range
+     * `[begin, end)` is rooted at its midpoint and `max_uppers[mid]` is the largest upper bound in that subtree.
+     */
+    struct VariableIndex {
+        bool is_symbolic = false;
+
+        /**
+         * The simple events that do not assign the variable.
+         */
+        DynamicBitset unconstrained;
+
+        /**
+         * The bitmap of simple events of every element index.
+         */
+        std::vector<DynamicBitset> elements;
+
+        std::vector<double> lowers;
+        std::vector<double> uppers;
+        std::vector<std::uint8_t> borders;
+        std::vector<std::uint32_t> owners;
+        std::vector<double> max_uppers;
+    };
+
+    std::vector<SimpleEventPtr_t> simple_events_;
+    VariableRegistryPtr_t registry_;
+
+    /**
+     * The simple events without an empty assignment.
+     */
+    DynamicBitset non_empty_;
+
+    std::vector<VariableIndex> indices_;
+
+    /**
+     * Sort the pieces of an interval tree by their lower bound and compute the maximal upper bounds.
+     */
+    static void build_tree(VariableIndex &index);
+
+    /**
+     * Compute the maximal upper bound of the subtree of `[begin, end)`.
+     */
+    static double build_max_uppers(VariableIndex &index, std::size_t begin, std::size_t end);
+
+    /**
+     * Set the owners of all pieces in the subtree of `[begin, end)` that intersect a piece.
+     */
+    static void query_tree(const VariableIndex &index, std::size_t begin, std::size_t end, double lower, double upper,
+                           std::uint8_t borders, DynamicBitset &result);
+
+    /**
+     * @return The matching simple events of an assignment of an indexed variable.
+     */
+    DynamicBitset matching_assignment(const VariableIndex &index, const AbstractCompositeSet &assignment) const;
+};
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "interval.h"
+#include <cstdint>
+#include <vector>
+
+// FORWARD DECLARATIONS
+class FlatInterval;
+
+// TYPEDEFS
+using FlatIntervalPtr_t = std::shared_ptr<FlatInterval>;
+
+/**
+ * Bit that is set in the packed border byte of a piece if its left border is closed.
+ */
+constexpr std::uint8_t LEFT_CLOSED_BIT = 1;
+
+/**
+ * Bit that is set in the packed border byte of a piece if its right border is closed.
+ */
+constexpr std::uint8_t RIGHT_CLOSED_BIT = 2;
+
+/**
+ * Pack two border types into the bit representation used by FlatInterval.
+ * @param left The left border.
+ * @param right The right border.
+ * @return The packed borders.
+ */
+inline std::uint8_t pack_borders(const BorderType left, const BorderType right) {
+    return static_cast<std::uint8_t>((left == BorderType::CLOSED ? LEFT_CLOSED_BIT : 0) |
+                                     (right == BorderType::CLOSED ? RIGHT_CLOSED_BIT : 0));
+}
+
+/**
+ * Class that represents a composite interval as contiguous, sorted arrays (struct of arrays).
+ *
+ * Every piece `i` is described by `lowers()[i]`, `uppers()[i]` and the packed border bits `borders()[i]`.
+ * A FlatInterval is always kept in canonical form: the pieces are non-empty, sorted by their lower bound,
+ * pairwise disjoint and no two pieces can be merged into one.
+ * Hence, two FlatIntervals are equal iff they describe the same set of reals.
+ *
+ * The SimpleInterval API is available as a view via `simple_interval(i)` and the conversion from and to `Interval`.
+ */
+class FlatInterval {
+public:
+
+    /**
+     * Construct the empty interval.
+     */
+    FlatInterval() = default;
+
+    /**
+     * Construct a flat interval from arbitrary, possibly overlapping or empty pieces.
+     * The pieces are brought into canonical form.
+     *
+     * @param lowers The lower bounds of the pieces.
+     * @param uppers The upper bounds of the pieces.
+     * @param borders The packed border bits of the pieces.
+     */
+    FlatInterval(std::vector<double> lowers, std::vector<double> uppers, std::vector<std::uint8_t> borders);
+
+    /**
+     * Construct a flat interval from a set of simple intervals.
+     * @param simple_sets The simple intervals.
+     */
+    explicit FlatInterval(const SimpleSetSet_t &simple_sets);
+
+    /**
+     * Construct a flat interval from a simple interval.
+     * @param simple_interval The simple interval.
+     */
+    explicit FlatInterval(const SimpleInterval &simple_interval);
+
+    /**
+     * Construct a flat interval from a composite interval.
+     * @param interval The interval.
+     */
+    explicit FlatInterval(const Interval &interval);
+
+    /**
+     * @return The number of pieces.
+     */
+    std::size_t size() const {
+        return lowers_.size();
+    }
+
+    /**
+     * @return True if this is empty.
+     */
+    bool is_empty() const {
+        return lowers_.empty();
+    }
+
+    const std::vector<double> &lowers() const {
+        return lowers_;
+    }
+
+    const std::vector<double> &uppers() const {
+        return uppers_;
+    }
+
+    const std::vector<std::uint8_t> &borders() const {
+        return borders_;
+    }
+
+    BorderType left(std::size_t index) const {
+        return borders_[index] & LEFT_CLOSED_BIT ? BorderType::CLOSED : BorderType::OPEN;
+    }
+
+    BorderType right(std::size_t index) const {
+        return borders_[index] & RIGHT_CLOSED_BIT ? BorderType::CLOSED : BorderType::OPEN;
+    }
+
+    /**
+     * @return The lowest value of this interval. Requires this to be non-empty.
+     */
+    double lower() const {
+        return lowers_.front();
+    }
+
+    /**
+     * @return The highest value of this interval. Requires this to be non-empty.
+     */
+    double upper() const {
+        return uppers_.back();
+    }
+
+    /**
+     * View a piece of this as simple interval.
+     * @param index The index of the piece.
+     * @return The piece as simple interval.
+     */
+    SimpleInterval simple_interval(std::size_t index) const {
+        return SimpleInterval(lowers_[index], uppers_[index], left(index), right(index));
+    }
+
+    /**
+     * Check if a value is contained in this.
+     * The piece that may contain the value is located by binary search.
+     *
+     * @param element The value.
+     * @return True if the value is contained.
+     */
+    bool contains(double element) const;
+
+    /**
+     * Check for a batch of values if they are contained in this.
+     *
+     * Intervals with few pieces are tested piece by piece against all values, many-piece intervals locate the
+     * candidate piece of every value by binary search over the lower bounds.
+     * The border comparisons are vectorized with AVX2 if the library is compiled with it (e.g. `-mavx2`),
+     * with SSE2 on other x86-64 targets and with a scalar loop everywhere else.
+     *
+     * @param elements Pointer to `count` contiguous values.
+     * @param count The number of values.
+     * @param mask Pointer to `count` bytes. Byte `i` is set to 1 if `elements[i]` is contained and to 0 otherwise.
+     */
+    void contains(const double *elements, std::size_t count, std::uint8_t *mask) const;
+
+    /**
+     * Check for a batch of values if they are contained in this and write the result as bitmask.
+     *
+     * @param elements Pointer to `count` contiguous values.
+     * @param count The number of values.
+     * @param bits Pointer to `(count + 63) / 64` words. Bit `i % 64` of word `i / 64` is set iff `elements[i]` is
+     * contained. Unused bits of the last word are cleared.
+     */
+    void contains_bitmask(const double *elements, std::size_t count, std::uint64_t *bits) const;
+
+    /**
+     * Form the union with another flat interval in one merge sweep over both.
+     *
+     * @param other The other flat interval.
+     * @return The union.
+     */
+    FlatInterval union_with(const FlatInterval &other) const;
+
+    /**
+     * Form the intersection with another flat interval in one sweep over both.
+     *
+     * @param other The other flat interval.
+     * @return The intersection.
+     */
+    FlatInterval intersection_with(const FlatInterval &other) const;
+
+    /**
+     * Form the difference with another flat interval in one sweep over both.
+     *
+     * @param other The other flat interval.
+     * @return The difference.
+     */
+    FlatInterval difference_with(const FlatInterval &other) const;
+
+    /**
+     * @return The complement of this, i.e. the gaps between the pieces.
+     */
+    FlatInterval complement() const;
+
+    /**
+     * Convert this to a composite interval of shared simple intervals.
+     * @return The composite interval.
+     */
+    IntervalPtr_t to_interval() const;
+
+    bool operator==(const FlatInterval &other) const;
+
+    bool operator!=(const FlatInterval &other) const {
+        return !(*this == other);
+    }
+
+    static FlatInterval closed(double lower, double upper);
+
+    static FlatInterval open(double lower, double upper);
+
+    static FlatInterval closed_open(double lower, double upper);
+
+    static FlatInterval open_closed(double lower, double upper);
+
+    static FlatInterval singleton(double value);
+
+    static FlatInterval reals();
+
+private:
+    std::vector<double> lowers_;
+    std::vector<double> uppers_;
+    std::vector<std::uint8_t> borders_;
+
+    /**
+     * Append a piece without any checks. The caller has to maintain the canonical form.
+     */
+    void push_back(double lower, double upper, std::uint8_t borders);
+
+    /**
+     * Append a piece and merge it with the last piece if they overlap or touch.
+     * Pieces have to be appended in ascending order of their lower bounds.
+     */
+    void merge_back(double lower, double upper, std::uint8_t borders);
+
+    /**
+     * Create a flat interval that contains exactly one piece.
+     */
+    static FlatInterval single_piece(double lower, double upper, std::uint8_t borders);
+};
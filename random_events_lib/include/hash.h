@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * 64-bit hashing primitives in the style of wyhash.
+ *
+ * All structural hashes of sets and events are built from these functions, such that the hashes are well mixed and
+ * do not depend on the hash functions of the standard library (which are the identity for integers in libstdc++).
+ */
+
+static constexpr std::uint64_t HASH_SECRET_0 = 0xa0761d6478bd642fULL;
+static constexpr std::uint64_t HASH_SECRET_1 = 0xe7037ed1a0b428dbULL;
+static constexpr std::uint64_t HASH_SECRET_2 = 0x8ebc6af09c88c6e3ULL;
+
+/**
+ * Multiply two 64-bit numbers to 128 bits and fold the halves with xor.
+ *
+ * @param lhs The first factor.
+ * @param rhs The second factor.
+ * @return The folded product.
+ */
+inline std::uint64_t hash_mix(std::uint64_t lhs, std::uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+    const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    const std::uint64_t lhs_high = lhs >> 32, lhs_low = static_cast<std::uint32_t>(lhs);
+    const std::uint64_t rhs_high = rhs >> 32, rhs_low = static_cast<std::uint32_t>(rhs);
+    const std::uint64_t high_high = lhs_high * rhs_high, high_low = lhs_high * rhs_low;
+    const std::uint64_t low_high = lhs_low * rhs_high, low_low = lhs_low * rhs_low;
+    const std::uint64_t middle = (low_low >> 32) + static_cast<std::uint32_t>(high_low) +
+                                 static_cast<std::uint32_t>(low_high);
+    const std::uint64_t low = (middle << 32) | static_cast<std::uint32_t>(low_low);
+    const std::uint64_t high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+}
+
+/**
+ * Combine a hash value into a seed. The result depends on the order of combination.
+ *
+ * @param seed The seed.
+ * @param value The hash value to combine.
+ * @return The combined hash.
+ */
+inline std::size_t hash_combine(std::size_t seed, std::size_t value) {
+    return hash_mix(seed ^ HASH_SECRET_0, value ^ HASH_SECRET_1);
+}
+
+/**
+ * @param value The integer.
+ * @return The hash of the integer.
+ */
+inline std::size_t hash_integer(std::uint64_t value) {
+    return hash_mix(hash_mix(value ^ HASH_SECRET_0, HASH_SECRET_1) ^ value, HASH_SECRET_2);
+}
+
+/**
+ * Hash a double by its bits. 0.0 and -0.0 compare equal and therefore have the same hash.
+ *
+ * @param value The double.
+ * @return The hash of the double.
+ */
+inline std::size_t hash_double(double value) {
+    if (value == 0.0) {
+        value = 0.0;
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return hash_integer(bits);
+}
+
+/**
+ * Hash a byte sequence in blocks of 8 bytes.
+ *
+ * @param data The bytes.
+ * @param length The number of bytes.
+ * @return The hash of the bytes.
+ */
+inline std::size_t hash_bytes(const void *data, std::size_t length) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    std::size_t seed = hash_integer(length);
+    std::uint64_t block;
+    for (; length >= sizeof(block); length -= sizeof(block), bytes += sizeof(block)) {
+        std::memcpy(&block, bytes, sizeof(block));
+        seed = hash_combine(seed, block);
+    }
+    if (length > 0) {
+        block = 0;
+        std::memcpy(&block, bytes, length);
+        seed = hash_combine(seed, block);
+    }
+    return seed;
+}
+
+/**
+ * @param value The string.
+ * @return The hash of the characters of the string.
+ */
+inline std::size_t hash_string(const std::string &value) {
+    return hash_bytes(value.data(), value.size());
+}
+
+/**
+ * Class that stores a lazily computed hash inside the hashed object.
+ *
+ * Sets only use it while they are frozen (see AbstractSimpleSet::freeze), since nothing tracks in-place
+ * modifications of their contents.
+ * 0 marks a hash that was not computed yet, hence computed hashes of 0 are stored as 1.
+ * Copies start without a hash, such that a copy that is modified afterwards never reports the hash of its origin.
+ * Concurrent computations store the same value, so relaxed atomics suffice.
+ */
+class CachedHash {
+public:
+
+    CachedHash() = default;
+
+    CachedHash(const CachedHash &) {}
+
+    CachedHash &operator=(const CachedHash &) {
+        invalidate();
+        return *this;
+    }
+
+    /**
+     * @param compute The function that computes the hash if it is not cached.
+     * @return The cached hash.
+     */
+    template<typename Compute>
+    std::size_t get(Compute &&compute) const {
+        auto value = value_.load(std::memory_order_relaxed);
+        if (value == 0) {
+            value = compute();
+            if (value == 0) {
+                value = 1;
+            }
+            value_.store(value, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    /**
+     * Forget the cached hash.
+     */
+    void invalidate() const {
+        value_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    mutable std::atomic<std::size_t> value_{0};
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "sigma_algebra.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The default number of shards of an intern table.
+ */
+static constexpr std::size_t INTERN_SHARD_COUNT = 64;
+
+/**
+ * Class that canonicalizes structurally equal sets to one shared instance (hash-consing).
+ *
+ * Interning a set returns the canonical instance that is equal to it. The canonical instances are built from
+ * interned parts, i.e. all simple sets of an interned composite set and all assignments of an interned simple event
+ * are interned themselves. Equal sub-assignments of different events are therefore shared, and equality checks
+ * between interned sets short-circuit on pointer identity.
+ *
+ * Canonical instances are allocated on the heap and frozen (see AbstractSimpleSet::freeze), since every holder shares
+ * them. Mutating operations reject them, and Event copies frozen simple events before filling in missing variables.
+ * The table only holds weak references, hence instances that are no longer used elsewhere are released and their
+ * entries are removed lazily.
+ *
+ * The table is split into shards by hash, each guarded by its own mutex, such that it can be used concurrently.
+ */
+class InternTable {
+public:
+
+    /**
+     * Create an intern table.
+     * @param shard_count The number of shards.
+     */
+    explicit InternTable(std::size_t shard_count = INTERN_SHARD_COUNT);
+
+    InternTable(const InternTable &) = delete;
+
+    InternTable &operator=(const InternTable &) = delete;
+
+    /**
+     * @param simple_set The simple set.
+     * @return The canonical simple set that is equal to the given one.
+     */
+    AbstractSimpleSetPtr_t intern(const AbstractSimpleSetPtr_t &simple_set);
+
+    /**
+     * @param composite_set The composite set.
+     * @return The canonical composite set that is equal to the given one.
+     */
+    AbstractCompositeSetPtr_t intern(const AbstractCompositeSetPtr_t &composite_set);
+
+    /**
+     * @return The number of entries, including entries of released instances that are not purged yet.
+     */
+    std::size_t size() const;
+
+    /**
+     * Remove the entries of released instances.
+     * @return The number of removed entries.
+     */
+    std::size_t purge();
+
+    /**
+     * Remove all entries. Instances that were returned before stay valid, but are no longer canonical.
+     */
+    void clear();
+
+    /**
+     * @return The number of intern calls that found an existing instance.
+     */
+    std::size_t hits() const {
+        return hits_;
+    }
+
+    /**
+     * @return The number of intern calls that created a new canonical instance.
+     */
+    std::size_t misses() const {
+        return misses_;
+    }
+
+    /**
+     * @return The table shared by the whole process.
+     */
+    static InternTable &global();
+
+private:
+
+    template<typename T>
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_multimap<std::size_t, std::weak_ptr<T>> entries;
+    };
+
+    std::vector<std::unique_ptr<Shard<AbstractSimpleSet>>> simple_shards_;
+    std::vector<std::unique_ptr<Shard<AbstractCompositeSet>>> composite_shards_;
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+
+    /**
+     * Build the canonical instance of a simple set from interned parts.
+     */
+    AbstractSimpleSetPtr_t make_canonical(const AbstractSimpleSetPtr_t &simple_set);
+
+    /**
+     * Build the canonical instance of a composite set from interned simple sets.
+     */
+    AbstractCompositeSetPtr_t make_canonical(const AbstractCompositeSetPtr_t &composite_set);
+};
@@ -6,6 +6,7 @@
 #include <memory>
 #include <utility>
 #include <limits>
+#include <cstdint>
 
 
 //FORWARD DECLARE
@@ -91,7 +92,7 @@ public:
     }
 
 
-    AbstractSimpleSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &other) override {
+    AbstractSimpleSetPtr_t intersection_with_impl(const AbstractSimpleSetPtr_t &other) override {
         const auto derived_other = (SimpleInterval *) other.get();
 
         // get the new lower and upper bounds
@@ -126,7 +127,7 @@ public:
         return make_shared(new_lower, new_upper, new_left, new_right);
     };
 
-    SimpleSetSetPtr_t complement() override {
+    SimpleSetSetPtr_t complement_impl() override {
         auto resulting_intervals = make_shared_simple_set_set();
 
         // if the interval is the real line, return an empty set
@@ -165,23 +166,10 @@ public:
     };
 
     bool contains(double element) const {
-        if (left == BorderType::OPEN and element <= lower) {
-            return false;
-        }
-
-        if (right == BorderType::OPEN and element >= upper) {
-            return false;
-        }
-
-        if (left == BorderType::CLOSED and element < lower) {
-            return false;
-        }
-
-        if (right == BorderType::CLOSED and element > upper) {
-            return false;
-        }
-
-        return true;
+        // phrased positively, such that NaN is never contained
+        const bool left_ok = element > lower or (element == lower and left == BorderType::CLOSED);
+        const bool right_ok = element < upper or (element == upper and right == BorderType::CLOSED);
+        return left_ok and right_ok;
     };
 
     bool is_empty() override {
@@ -200,9 +188,32 @@ public:
     };
 
     bool operator==(const SimpleInterval &other) {
+        return static_cast<const SimpleInterval &>(*this) == other;
+    };
+
+    bool operator==(const SimpleInterval &other) const {
         return lower == other.lower and upper == other.upper and left == other.left and right == other.right;
     };
 
+    std::size_t compute_hash() const override {
+        std::size_t seed = hash_double(lower);
+        seed = hash_combine(seed, hash_double(upper));
+        return hash_combine(seed, static_cast<std::size_t>(left) << 1 | static_cast<std::size_t>(right));
+    };
+
+    bool bounding_box(BoundingBox_t &box) override {
+        box.emplace_back(lower, upper);
+        return true;
+    };
+
+    AbstractSimpleSetPtr_t deep_copy() override {
+        return make_shared(lower, upper, left, right);
+    };
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override {
+        accountant.add(sizeof(SimpleInterval), owned);
+    };
+
     std::string *non_empty_to_string() override {
         const char left_representation = left == BorderType::OPEN ? '(' : '[';
         const char right_representation = right == BorderType::OPEN ? ')' : ']';
@@ -233,7 +244,7 @@ public:
 
     template<typename... Args>
     static SimpleIntervalPtr_t make_shared(Args &&... args) {
-        return std::make_shared<SimpleInterval>(std::forward<Args>(args)...);
+        return make_shared_in_scope<SimpleInterval>(std::forward<Args>(args)...);
     };
 
 };
@@ -245,8 +256,7 @@ namespace std {
     template <>
     struct hash<SimpleInterval> {
         size_t operator()(const SimpleInterval &interval) const {
-            return std::hash<double>()(interval.lower) ^ std::hash<double>()(interval.upper) ^
-                   std::hash<int>()(static_cast<int>(interval.left)) ^ std::hash<int>()(static_cast<int>(interval.right));
+            return interval.hash();
         }
     };
 }
@@ -281,39 +291,46 @@ public:
         return *this < *derived_other;
     };
 
-    AbstractCompositeSetPtr_t simplify() override {
-        auto result = make_shared_simple_set_set();
-        bool first_iteration = true;
-
-        for (const auto &current_simple_set: *simple_sets) {
-            auto current_simple_interval = std::static_pointer_cast<SimpleInterval>(current_simple_set);
-
-            // if this is the first iteration, just copy the interval
-            if (first_iteration) {
-                result->insert(current_simple_interval);
-                first_iteration = false;
-                continue;
-            }
-
-            auto last_simple_interval = std::dynamic_pointer_cast<SimpleInterval>(*result->rbegin());
-
-            if (last_simple_interval->upper > current_simple_interval->lower or (
-                last_simple_interval->upper == current_simple_interval->lower and not (
-                  last_simple_interval->right == BorderType::OPEN and
-                  current_simple_interval->left == BorderType::OPEN))) {
-                last_simple_interval->upper = current_simple_interval->upper;
-                last_simple_interval->right = current_simple_interval->right;
-                  } else {
-                      result->insert(current_simple_interval);
-                  }
-        }
-        return Interval::make_shared(result);
-    };
+    /**
+     * Simplify this interval by merging overlapping and touching simple intervals.
+     * The merge is performed on a flat copy (see FlatInterval), hence the simple intervals of this are not mutated.
+     *
+     * @return The simplified interval.
+     */
+    AbstractCompositeSetPtr_t simplify() override;
 
     AbstractCompositeSetPtr_t make_new_empty() const override {
+        RANDOM_EVENTS_COUNT(empty_allocations);
         return Interval::make_shared();
     };
 
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
+
+    /*
+     * The set operations of intervals exploit the total order of the reals.
+     * Both operands are flattened (see FlatInterval) and combined in one linear sweep instead of the generic,
+     * pairwise make_disjoint() path. The results are disjoint and simplified.
+     */
+
+    using AbstractCompositeSet::intersection_with;
+    using AbstractCompositeSet::union_with;
+
+    AbstractCompositeSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &simple_set) override;
+
+    AbstractCompositeSetPtr_t intersection_with(const SimpleSetSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t intersection_with_impl(const AbstractCompositeSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t complement_impl() const override;
+
+    AbstractCompositeSetPtr_t union_with(const AbstractSimpleSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t union_with_impl(const AbstractCompositeSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t difference_with(const AbstractSimpleSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t difference_with(const AbstractCompositeSetPtr_t &other) override;
+
     double lower() const {
         return std::dynamic_pointer_cast<SimpleInterval>(*simple_sets->begin())->lower;
     };
@@ -324,7 +341,12 @@ public:
 
     bool contains(double element) const {
         for (const auto &simple_set: *simple_sets) {
-            auto simple_interval = std::static_pointer_cast<SimpleInterval>(simple_set);
+            auto simple_interval = static_cast<SimpleInterval *>(simple_set.get());
+
+            // the simple intervals are sorted by their lower bound, no later one can contain the element
+            if (simple_interval->lower > element) {
+                break;
+            }
             if (simple_interval->contains(element)) {
                 return true;
             }
@@ -332,9 +354,44 @@ public:
         return false;
     };
 
+    /**
+     * Check for a batch of values if they are contained in this.
+     * See FlatInterval::contains for the vectorized kernels.
+     *
+     * @param elements Pointer to `count` contiguous values.
+     * @param count The number of values.
+     * @param mask Pointer to `count` bytes. Byte `i` is set to 1 if `elements[i]` is contained and to 0 otherwise.
+     */
+    void contains(const double *elements, std::size_t count, std::uint8_t *mask) const;
+
+    /**
+     * Create an interval from columns of simple intervals, e.g. the buffers of numpy arrays.
+     * The pieces may be unsorted, empty or overlapping; the result is simplified (see FlatInterval).
+     *
+     * @param lowers Pointer to `count` lower bounds.
+     * @param uppers Pointer to `count` upper bounds.
+     * @param left_closed Pointer to `count` bytes. Byte `i` is non-zero if the left border of piece `i` is closed.
+     * @param right_closed Pointer to `count` bytes. Byte `i` is non-zero if the right border of piece `i` is closed.
+     * @param count The number of pieces.
+     * @return The interval.
+     */
+    static IntervalPtr_t from_arrays(const double *lowers, const double *uppers, const std::uint8_t *left_closed,
+                                     const std::uint8_t *right_closed, std::size_t count);
+
+    /**
+     * Write the simple intervals of this in ascending order into columns of `simple_sets->size()` entries.
+     * This is the inverse of from_arrays.
+     *
+     * @param lowers The lower bounds.
+     * @param uppers The upper bounds.
+     * @param left_closed Set to 1 if the left border is closed and to 0 otherwise.
+     * @param right_closed Set to 1 if the right border is closed and to 0 otherwise.
+     */
+    void to_arrays(double *lowers, double *uppers, std::uint8_t *left_closed, std::uint8_t *right_closed) const;
+
     template<typename... Args>
     static std::shared_ptr<Interval> make_shared(Args &&... args) {
-        return std::make_shared<Interval>(std::forward<Args>(args)...);
+        return make_shared_in_scope<Interval>(std::forward<Args>(args)...);
     }
 
 };
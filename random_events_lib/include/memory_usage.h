@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * The heap footprint of an object graph.
+ */
+struct MemoryUsage {
+
+    /**
+     * The bytes of everything that is reachable, counting every shared subobject once.
+     */
+    std::size_t total_bytes = 0;
+
+    /**
+     * The bytes that are only reachable through the root, i.e. that would be freed if the root was destroyed.
+     */
+    std::size_t unique_bytes = 0;
+};
+
+/**
+ * The estimated size of the control block that std::make_shared and std::allocate_shared put in front of an object
+ * (virtual table pointer, use count and weak count).
+ */
+static constexpr std::size_t SHARED_CONTROL_BLOCK_BYTES = sizeof(void *) + 2 * sizeof(int);
+
+/**
+ * The estimated size of the bookkeeping of a node of std::set and std::map (color and three pointers).
+ */
+static constexpr std::size_t TREE_NODE_BYTES = 4 * sizeof(void *);
+
+/**
+ * Class that accumulates the memory usage of an object graph.
+ *
+ * Every object is counted once, identified by its address. A shared object counts as uniquely owned if all its
+ * references are found within the graph (use_count() equals the number of references walked) and its owner is
+ * uniquely owned.
+ *
+ * The graph is walked twice: the first pass only counts the references of every shared object, the second one adds
+ * the bytes. Walk it as long as next_pass() returns true.
+ */
+class MemoryAccountant {
+public:
+
+    /**
+     * Add bytes to the usage.
+     * @param bytes The bytes.
+     * @param owned True if the bytes are uniquely owned.
+     */
+    void add(std::size_t bytes, bool owned) {
+        if (counting_) {
+            return;
+        }
+        usage_.total_bytes += bytes;
+        if (owned) {
+            usage_.unique_bytes += bytes;
+        }
+    }
+
+    /**
+     * Mark an object as visited.
+     * @param address The address of the object.
+     * @return True if the object was not visited before and has to be accounted.
+     */
+    bool enter(const void *address) {
+        return visited_.insert(address).second;
+    }
+
+    /**
+     * Enter the object of a shared pointer and add its control block.
+     *
+     * @param pointer The pointer.
+     * @param owner_owned True if the owner of the pointer is uniquely owned.
+     * @param owned Set to true if the object is uniquely owned.
+     * @return True if the object was not visited before and has to be accounted.
+     */
+    template<typename T>
+    bool enter(const std::shared_ptr<T> &pointer, bool owner_owned, bool &owned) {
+        if (!pointer) {
+            return false;
+        }
+        const auto *address = static_cast<const void *>(pointer.get());
+        if (counting_) {
+            owned = owner_owned;
+            ++references_[address];
+            return enter(address);
+        }
+        if (!enter(address)) {
+            return false;
+        }
+        owned = owner_owned && static_cast<std::size_t>(pointer.use_count()) == references_[address];
+        add(SHARED_CONTROL_BLOCK_BYTES, owned);
+        return true;
+    }
+
+    /**
+     * Finish a walk over the graph.
+     * @return True if the graph has to be walked again to add the bytes.
+     */
+    bool next_pass() {
+        if (!counting_) {
+            return false;
+        }
+        counting_ = false;
+        visited_.clear();
+        return true;
+    }
+
+    /**
+     * @return The accumulated usage.
+     */
+    const MemoryUsage &usage() const {
+        return usage_;
+    }
+
+private:
+    MemoryUsage usage_;
+    std::unordered_set<const void *> visited_;
+    bool counting_ = true;
+
+    /**
+     * The number of references to every shared object within the graph.
+     */
+    std::unordered_map<const void *, std::size_t> references_;
+};
+
+/**
+ * @param value The string.
+ * @return The bytes of the heap buffer of the string, which is 0 for strings in the small string buffer.
+ */
+inline std::size_t string_heap_bytes(const std::string &value) {
+    const auto *buffer = reinterpret_cast<const char *>(value.data());
+    const auto *object = reinterpret_cast<const char *>(&value);
+    const bool in_object = buffer >= object && buffer < object + sizeof(std::string);
+    return in_object ? 0 : value.capacity() + 1;
+}
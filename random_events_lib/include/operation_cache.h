@@ -0,0 +1,177 @@
+#pragma once
+
+#include "sigma_algebra.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * The kinds of operations that are memoized by the operation cache.
+ */
+enum class SetOperation : std::uint8_t {
+    SIMPLE_INTERSECTION,
+    SIMPLE_COMPLEMENT,
+    INTERSECTION,
+    UNION,
+    COMPLEMENT
+};
+
+/**
+ * Counters of an operation cache.
+ */
+struct OperationCacheStatistics {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+};
+
+/**
+ * Class that represents a bounded least recently used cache for the results of set operations.
+ *
+ * Entries are keyed by the operation kind and the structural hashes of the operands. Since hashes can collide,
+ * an entry only matches if its operands are also equal (and of the same type) to the queried ones.
+ * Operands and results are stored as deep copies on the heap (see deep_copy and ArenaSuspension) and results are
+ * returned as deep copies, such that callers that modify an operand or a result afterwards do not modify the cache,
+ * and no entry keeps an operation arena alive.
+ *
+ * All methods are thread safe. Lookups only hold the lock to collect the candidate entries of a hash and to mark a
+ * hit as recently used; the operands are compared outside of it, since the entries are immutable.
+ */
+class OperationCache {
+public:
+
+    /**
+     * Create a cache.
+     * @param capacity The maximal number of entries per level (simple and composite). 0 disables the cache.
+     */
+    explicit OperationCache(std::size_t capacity = 0);
+
+    /**
+     * @return True if the capacity is not 0.
+     */
+    bool enabled() const {
+        return capacity_.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * Set the capacity. Evicts the least recently used entries if there are too many.
+     * @param capacity The maximal number of entries per level. 0 disables the cache and removes all entries.
+     */
+    void set_capacity(std::size_t capacity);
+
+    /**
+     * Find the result of an operation on simple sets.
+     * @return The result or nullptr.
+     */
+    std::shared_ptr<void> find(SetOperation operation, std::size_t hash, AbstractSimpleSet &lhs,
+                               AbstractSimpleSet *rhs);
+
+    /**
+     * Find the result of an operation on composite sets.
+     * @return The result or nullptr.
+     */
+    std::shared_ptr<void> find(SetOperation operation, std::size_t hash, const AbstractCompositeSet &lhs,
+                               const AbstractCompositeSet *rhs);
+
+    /**
+     * Store the result of an operation on simple sets.
+     */
+    void insert(SetOperation operation, std::size_t hash, AbstractSimpleSetPtr_t lhs, AbstractSimpleSetPtr_t rhs,
+                std::shared_ptr<void> result);
+
+    /**
+     * Store the result of an operation on composite sets.
+     */
+    void insert(SetOperation operation, std::size_t hash, AbstractCompositeSetPtr_t lhs,
+                AbstractCompositeSetPtr_t rhs, std::shared_ptr<void> result);
+
+    /**
+     * Remove all entries and reset the counters.
+     */
+    void clear();
+
+    /**
+     * @return The counters of this cache.
+     */
+    OperationCacheStatistics statistics() const;
+
+    /**
+     * @return The cache used by the set operations.
+     */
+    static OperationCache &global();
+
+private:
+
+    template<typename Operand>
+    struct Entry {
+        /**
+         * Identifies the entry across lookups, since iterators may be invalidated while the lock is released.
+         */
+        std::uint64_t id;
+        SetOperation operation;
+        std::size_t hash;
+        std::shared_ptr<Operand> lhs;
+        std::shared_ptr<Operand> rhs;
+        std::shared_ptr<void> result;
+    };
+
+    template<typename Operand>
+    struct Level {
+        std::list<Entry<Operand>> entries;
+        std::unordered_multimap<std::size_t, typename std::list<Entry<Operand>>::iterator> index;
+    };
+
+    mutable std::mutex mutex_;
+    std::atomic<std::size_t> capacity_;
+    Level<AbstractSimpleSet> simple_level_;
+    Level<AbstractCompositeSet> composite_level_;
+    OperationCacheStatistics statistics_;
+    std::uint64_t next_id_ = 0;
+
+    template<typename Operand, typename Queried>
+    std::shared_ptr<void> find_in(Level<Operand> &level, SetOperation operation, std::size_t hash, Queried &lhs,
+                                  Queried *rhs);
+
+    /**
+     * Mark an entry as most recently used if it is still cached. The lock has to be held.
+     */
+    template<typename Operand>
+    void touch(Level<Operand> &level, std::size_t hash, std::uint64_t id);
+
+    template<typename Operand>
+    void insert_into(Level<Operand> &level, Entry<Operand> entry);
+
+    template<typename Operand>
+    void evict(Level<Operand> &level, std::size_t capacity);
+};
+
+/**
+ * Compute the key hash of an operation.
+ *
+ * @param operation The operation kind.
+ * @param lhs_hash The hash of the left operand.
+ * @param rhs_hash The hash of the right operand or 0 for unary operations.
+ * @return The key hash.
+ */
+inline std::size_t operation_hash(SetOperation operation, std::size_t lhs_hash, std::size_t rhs_hash = 0) {
+    return hash_combine(hash_combine(static_cast<std::size_t>(operation), lhs_hash), rhs_hash);
+}
+
+/**
+ * Enable the memoization of set operations with the given capacity, or disable it with 0 (the default).
+ * @param capacity The maximal number of cached results per level (simple and composite).
+ */
+void set_operation_cache_capacity(std::size_t capacity);
+
+/**
+ * @return The counters of the cache of set operations.
+ */
+OperationCacheStatistics get_operation_cache_statistics();
+
+/**
+ * Remove all cached results and reset the counters.
+ */
+void clear_operation_cache();
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Set to 0 (e.g. with -DRANDOM_EVENTS_STATISTICS=0) to compile all operation counters out.
+ */
+#ifndef RANDOM_EVENTS_STATISTICS
+#define RANDOM_EVENTS_STATISTICS 1
+#endif
+
+/**
+ * Snapshot of the operation counters, summed over all threads.
+ */
+struct OperationStatistics {
+
+    /**
+     * The number of intersections of two simple sets.
+     */
+    std::uint64_t simple_intersections = 0;
+
+    /**
+     * The number of complements of simple sets.
+     */
+    std::uint64_t simple_complements = 0;
+
+    /**
+     * The number of composite sets created by make_new_empty.
+     */
+    std::uint64_t empty_allocations = 0;
+
+    /**
+     * The number of calls of split_into_disjoint_and_non_disjoint.
+     */
+    std::uint64_t split_rounds = 0;
+
+    /**
+     * The number of merge passes of simplify (simplify_once calls and rounds of simplify_by_signature).
+     */
+    std::uint64_t simplify_passes = 0;
+
+    /**
+     * The largest number of simple sets of a composite set that was split or made disjoint. Maximum over all threads.
+     */
+    std::uint64_t peak_simple_sets = 0;
+};
+
+/**
+ * Class that holds the operation counters of one thread.
+ *
+ * Only the owning thread writes the counters, hence an increment is a relaxed load and store instead of a locked
+ * read-modify-write. Other threads only read them when a snapshot is taken.
+ */
+class ThreadOperationCounters {
+public:
+
+    /**
+     * Counter that is written by one thread and read by any.
+     */
+    class Counter {
+    public:
+        void increment() {
+            value_.store(value_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void maximize(std::uint64_t value) {
+            if (value > value_.load(std::memory_order_relaxed)) {
+                value_.store(value, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint64_t get() const {
+            return value_.load(std::memory_order_relaxed);
+        }
+
+        void reset() {
+            value_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<std::uint64_t> value_{0};
+    };
+
+    Counter simple_intersections;
+    Counter simple_complements;
+    Counter empty_allocations;
+    Counter split_rounds;
+    Counter simplify_passes;
+    Counter peak_simple_sets;
+
+    /**
+     * Register the counters of the current thread.
+     */
+    ThreadOperationCounters();
+
+    /**
+     * Add the counters to the totals of finished threads and unregister them.
+     */
+    ~ThreadOperationCounters();
+
+    /**
+     * Add the counters to a snapshot.
+     * @param statistics The snapshot.
+     */
+    void add_to(OperationStatistics &statistics) const;
+
+    /**
+     * Set all counters to 0.
+     */
+    void reset();
+
+    /**
+     * @return The counters of the calling thread.
+     */
+    static ThreadOperationCounters &current() {
+        thread_local ThreadOperationCounters counters;
+        return counters;
+    }
+};
+
+#if RANDOM_EVENTS_STATISTICS
+#define RANDOM_EVENTS_COUNT(counter) ThreadOperationCounters::current().counter.increment()
+#define RANDOM_EVENTS_PEAK(counter, value) ThreadOperationCounters::current().counter.maximize(value)
+#else
+#define RANDOM_EVENTS_COUNT(counter) ((void) 0)
+#define RANDOM_EVENTS_PEAK(counter, value) ((void) 0)
+#endif
+
+/**
+ * @return True if the operation counters are compiled in.
+ */
+constexpr bool operation_statistics_enabled() {
+    return RANDOM_EVENTS_STATISTICS != 0;
+}
+
+/**
+ * Sum the counters of all threads, including the threads that have finished.
+ * Counts of operations that run concurrently with this call may or may not be included.
+ *
+ * @return The snapshot.
+ */
+OperationStatistics get_operation_statistics();
+
+/**
+ * Set the counters of all threads to 0.
+ * Increments that run concurrently with this call may be lost.
+ */
+void reset_operation_statistics();
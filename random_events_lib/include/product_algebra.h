@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sigma_algebra.h"
+#include <cstdint>
 #include <map>
 #include <memory>
 #include "variable.h"
@@ -10,6 +11,7 @@
 // FORWARD DECLARATIONS
 class SimpleEvent;
 class Event;
+class VariableRegistry;
 
 
 // TYPEDEFS
@@ -20,14 +22,28 @@ using EventPtr_t = std::shared_ptr<Event>;
 using VariableSet = std::set<AbstractVariablePtr_t, PointerLess<AbstractVariablePtr_t>>;
 using VariableSetPtr_t = std::shared_ptr<VariableSet>;
 
+/**
+ * The number of 64-row words per task of Event::contains for batches.
+ */
+static constexpr std::size_t EVENT_CONTAINS_GRAIN = 64;
+
+/**
+ * One column of a batch of points in columnar layout. Continuous and integer variables read `values`, symbolic
+ * variables read `indices`, the indices of the elements in the universe of their domain.
+ */
+struct PointColumn {
+    const double *values = nullptr;
+    const long long *indices = nullptr;
+};
+
 template<typename... Args>
 SimpleEventPtr_t make_shared_simple_event(Args &&... args) {
-    return std::make_shared<SimpleEvent>(std::forward<Args>(args)...);
+    return make_shared_in_scope<SimpleEvent>(std::forward<Args>(args)...);
 }
 
 template<typename... Args>
 EventPtr_t make_shared_event(Args &&... args) {
-    return std::make_shared<Event>(std::forward<Args>(args)...);
+    return make_shared_in_scope<Event>(std::forward<Args>(args)...);
 }
 
 template<typename... Args>
@@ -35,11 +51,16 @@ VariableSetPtr_t make_shared_variable_set(Args &&... args) {
     return std::make_shared<VariableSet>(std::forward<Args>(args)...);
 }
 
+/**
+ * Hash function for variable maps by value, i.e. by the names of the variables and the hashes of their assignments
+ * in the order of the map. Equal variable maps have equal hashes.
+ */
 struct VariableMapHash {
     std::size_t operator()(const VariableMap &vm) const {
-        std::size_t seed = 0;
-        for (const auto &pair : vm) {
-            seed ^= std::hash<std::shared_ptr<AbstractVariable>>{}(pair.first) ^ std::hash<std::shared_ptr<AbstractCompositeSet>>{}(pair.second);
+        std::size_t seed = hash_integer(vm.size());
+        for (const auto &[variable, assignment] : vm) {
+            seed = hash_combine(seed, hash_string(*variable->name));
+            seed = hash_combine(seed, assignment->hash());
         }
         return seed;
     }
@@ -59,6 +80,12 @@ public:
 
     VariableMapPtr_t variable_map;
 
+    /**
+     * Assign every variable that is not assigned yet to its domain.
+     *
+     * @param variables The variables.
+     * @throws std::invalid_argument If a variable is missing and this is frozen.
+     */
     void fill_missing_variables(const VariableSetPtr_t &variables) const;
 
     VariableSetPtr_t get_variables() const;
@@ -68,9 +95,9 @@ public:
     AbstractSimpleSetPtr_t marginal(const VariableSetPtr_t &variables) const;
 
 
-    AbstractSimpleSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &other) override;
+    AbstractSimpleSetPtr_t intersection_with_impl(const AbstractSimpleSetPtr_t &other) override;
 
-    SimpleSetSetPtr_t complement() override;
+    SimpleSetSetPtr_t complement_impl() override;
 
     bool contains(const ElementaryVariant *element) override;
 
@@ -81,6 +108,33 @@ public:
     bool operator==(const AbstractSimpleSet &other) override;
 
     bool operator<(const AbstractSimpleSet &other) override;
+
+    std::size_t compute_hash() const override;
+
+    /**
+     * Append the bounding range of every assignment in the order of the variables.
+     */
+    bool bounding_box(BoundingBox_t &box) override;
+
+    /**
+     * Copy the variable map and every assignment. The variables themselves are shared.
+     */
+    AbstractSimpleSetPtr_t deep_copy() override;
+
+    /**
+     * Copy the variable map. The assignments are shared.
+     */
+    AbstractSimpleSetPtr_t shallow_copy() override;
+
+    /**
+     * Promote the variable map and the assignments that are allocated in the arena and share the others.
+     */
+    AbstractSimpleSetPtr_t promote(const OperationArena &arena) override;
+
+    /**
+     * Account this simple event, the nodes of its variable map, its variables and its assignments.
+     */
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
 };
 
 class Event: public AbstractCompositeSet {
@@ -90,17 +144,63 @@ public:
     explicit Event(const SimpleSetSetPtr_t &simple_events);
     explicit Event(const SimpleEventPtr_t &simple_event);
 
+    /**
+     * Assign every variable that a simple event misses to its domain.
+     * Frozen simple events (e.g. interned ones) are shared, hence they are replaced by filled copies.
+     *
+     * @param variable_set The variables.
+     * @throws std::invalid_argument If a simple event has to be replaced and this is frozen.
+     */
     void fill_missing_variables(const VariableSetPtr_t &variable_set) const;
 
+    /**
+     * Assign the variables of all simple events to every simple event (see above).
+     */
     void fill_missing_variables() const;
 
     VariableSet get_variables_from_simple_events() const;
 
     AbstractCompositeSetPtr_t marginal(const VariableSetPtr_t &variables) const;
 
+    /**
+     * Simplify this event by merging simple events that differ in exactly one variable.
+     * If all simple events share their variables, all mergeable events are grouped by hash signatures
+     * (see simplify_by_signature). Otherwise, simplify_once is repeated until nothing changes.
+     *
+     * @return The simplified event.
+     */
     AbstractCompositeSetPtr_t simplify() override;
 
     std::tuple<EventPtr_t , bool> simplify_once();
 
+    /**
+     * @return True if all simple events are defined over the same variables.
+     */
+    bool has_aligned_axes() const override;
+
+    /**
+     * @return True if the simple events of this and the other simple events are all defined over the same variables.
+     */
+    bool has_aligned_axes_with(const SimpleSetSetPtr_t &other) const override;
+
     AbstractCompositeSetPtr_t make_new_empty() const override;
+
+    /**
+     * Check a batch of points in columnar layout.
+     *
+     * Every simple event is evaluated variable by variable over whole columns with the vectorized kernels of
+     * FlatInterval. Rows that an earlier variable rejected or an earlier simple event accepted are skipped in blocks
+     * of 64, and a simple event stops as soon as it rejects all remaining rows. Large batches are split over the
+     * shared thread pool.
+     *
+     * @param registry The registry that maps every variable of the event to its column.
+     * @param columns Pointer to one column per variable, indexed by variable ID. Each column has `rows` entries.
+     * @param rows The number of rows.
+     * @param mask Pointer to `rows` bytes. Byte `i` is set to 1 if row `i` is contained and to 0 otherwise.
+     * @throws std::invalid_argument If a variable is not in the registry or its column lacks the required entries.
+     */
+    void contains(const VariableRegistry &registry, const PointColumn *columns, std::size_t rows,
+                  std::uint8_t *mask) const;
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
 };
\ No newline at end of file
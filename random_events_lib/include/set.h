@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sigma_algebra.h"
+#include "dynamic_bitset.h"
 #include <set>
 #include <utility>
 
@@ -22,13 +23,13 @@ AllSetElementsPtr_t make_shared_all_elements(Args &&... args) {
 
 template<typename... Args>
 SetElementPtr_t make_shared_set_element(Args &&... args) {
-    return std::make_shared<SetElement>(std::forward<Args>(args)...);
+    return make_shared_in_scope<SetElement>(std::forward<Args>(args)...);
 }
 
 
 template<typename... Args>
 SetPtr_t make_shared_set(Args &&... args) {
-    return std::make_shared<Set>(std::forward<Args>(args)...);
+    return make_shared_in_scope<Set>(std::forward<Args>(args)...);
 }
 
 
@@ -51,16 +52,17 @@ public:
 
     ~SetElement() override;
 
-    AbstractSimpleSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &other) override;
+    AbstractSimpleSetPtr_t intersection_with_impl(const AbstractSimpleSetPtr_t &other) override;
 
-    SimpleSetSetPtr_t complement() override;
+    SimpleSetSetPtr_t complement_impl() override;
 
     bool contains(const ElementaryVariant *element) override;
 
     bool is_empty() override;
 
     /**
-     * Two simple sets are equal if the element_index is equal. The all_elements set is not considered.
+     * Two simple sets are equal if the element_index is equal and their all_elements sets are the same object or
+     * contain the same elements.
      *
      * @param other The other simple set.
      * @return True if they are equal.
@@ -69,6 +71,17 @@ public:
 
     bool operator==(const SetElement &other);
 
+    std::size_t compute_hash() const override;
+
+    bool bounding_box(BoundingBox_t &box) override;
+
+    AbstractSimpleSetPtr_t deep_copy() override;
+
+    /**
+     * Account this element and its universe, which is usually shared by all elements.
+     */
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
+
     std::string *non_empty_to_string() override;
 
     bool operator<(const AbstractSimpleSet &other) override;
@@ -98,6 +111,14 @@ public:
 };
 
 
+/**
+ * Class that represents a subset of a finite universe.
+ *
+ * The element indices are stored as bitset over the universe, and all set operations are word-wise bit operations
+ * (see DynamicBitset). The SetElements of simple_sets are only views for generic code: results of set operations
+ * create them on the first access to simple_sets (see SimpleSetSetHandle). Once simple_sets was accessed, it is the
+ * representation of the set, since the caller may have modified it.
+ */
 class Set : public AbstractCompositeSet {
 public:
 
@@ -107,12 +128,137 @@ public:
     Set(const SetElementPtr_t& element_, const AllSetElementsPtr_t& all_elements_);
     Set(const SimpleSetSetPtr_t& elements, const AllSetElementsPtr_t& all_elements_);
 
+    /**
+     * Create a set from a bitset over the universe, where bit `i` indicates that element index `i` is contained.
+     * @param bits The bitset.
+     * @param all_elements_ The universe.
+     */
+    Set(DynamicBitset bits, const AllSetElementsPtr_t& all_elements_);
+
     ~Set() override;
 
+    bool is_empty() override;
+
     AbstractCompositeSetPtr_t simplify() override;
 
     AbstractCompositeSetPtr_t make_new_empty() const override;
 
+    void account_memory(MemoryAccountant &accountant, bool owned) const override;
+
     std::string *to_string() override;
 
+    /**
+     * Two sets are equal if they contain the same element indices of the same universe.
+     */
+    bool operator==(const AbstractCompositeSet &other) const override;
+
+    /**
+     * Sets are ordered lexicographically by their ascending element indices, like their simple sets, and sets with
+     * the same indices by their universes.
+     */
+    bool operator<(const AbstractCompositeSet &other) const override;
+
+    std::size_t compute_hash() const override;
+
+    bool bounding_range(std::pair<double, double> &range) const override;
+
+    AbstractCompositeSetPtr_t deep_copy() const override;
+
+    AbstractCompositeSetPtr_t shallow_copy() const override;
+
+    /**
+     * @return The element indices of this as bitset with one bit per element of the universe.
+     * @throws std::invalid_argument If an element index lies outside the universe of this.
+     */
+    DynamicBitset to_bitset() const;
+
+    /**
+     * @return The number of elements in this.
+     */
+    std::size_t cardinality() const;
+
+    /**
+     * Create a set from element indices, e.g. the buffer of a numpy array.
+     * The indices may be unsorted and contain duplicates.
+     *
+     * @param indices Pointer to `count` element indices.
+     * @param count The number of indices.
+     * @param all_elements_ The universe.
+     * @return The set.
+     * @throws std::invalid_argument If an index is not in [0, all_elements_->size()).
+     */
+    static SetPtr_t from_indices(const long long *indices, std::size_t count,
+                                 const AllSetElementsPtr_t &all_elements_);
+
+    /**
+     * Write the element indices of this in ascending order into `cardinality()` entries.
+     * This is the inverse of from_indices.
+     *
+     * @param indices The element indices.
+     */
+    void to_indices(long long *indices) const;
+
+    /*
+     * The set operations of sets are word-wise bit operations over the universe instead of the generic, pairwise
+     * make_disjoint() path. Element indices of the operands outside the universe of this are dropped, unless the
+     * result would contain them.
+     */
+
+    using AbstractCompositeSet::intersection_with;
+    using AbstractCompositeSet::union_with;
+
+    AbstractCompositeSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &simple_set) override;
+
+    AbstractCompositeSetPtr_t intersection_with(const SimpleSetSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t intersection_with_impl(const AbstractCompositeSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t complement_impl() const override;
+
+    AbstractCompositeSetPtr_t union_with(const AbstractSimpleSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t union_with_impl(const AbstractCompositeSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t difference_with(const AbstractSimpleSetPtr_t &other) override;
+
+    AbstractCompositeSetPtr_t difference_with(const AbstractCompositeSetPtr_t &other) override;
+
+protected:
+
+    SimpleSetSetPtr_t make_simple_sets() const override;
+
+private:
+
+    /**
+     * The element indices, which are the representation of this until simple_sets is observed.
+     */
+    DynamicBitset bits_;
+
+    /**
+     * @return The element indices of this. The bitset has at least one bit per element of the universe and more if an
+     * element lies outside of it.
+     */
+    DynamicBitset bits() const;
+
+    /**
+     * @return The element indices of arbitrary set elements, sized like bits().
+     */
+    DynamicBitset bits_of(const SimpleSetSet_t &elements) const;
+
+    /**
+     * @return The element indices of a single set element, sized like bits().
+     */
+    DynamicBitset bits_of(const AbstractSimpleSetPtr_t &element) const;
+
+    /**
+     * @return The element indices of another composite set, sized like bits().
+     */
+    DynamicBitset bits_of(const AbstractCompositeSet &other) const;
+
+    /**
+     * @return The set of the element indices of the result of an operation.
+     * @throws std::invalid_argument If an element index lies outside the universe of this.
+     */
+    SetPtr_t make_result(DynamicBitset bits) const;
+
 };
\ No newline at end of file
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <atomic>
 #include <set>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <memory>
 #include <string>
+#include "arena.h"
+#include "hash.h"
+#include "memory_usage.h"
+#include "operation_statistics.h"
 
 // FORWARD DECLARATIONS
 class AbstractSimpleSet;
@@ -23,15 +29,143 @@ typedef std::shared_ptr<AbstractSimpleSet> AbstractSimpleSetPtr_t;
 typedef std::shared_ptr<AbstractCompositeSet> AbstractCompositeSetPtr_t;
 
 typedef std::set<AbstractSimpleSetPtr_t, PointerLess<AbstractSimpleSetPtr_t>> SimpleSetSet_t;
+
+/**
+ * An axis aligned box, given as one closed range [lower, upper] per axis.
+ */
+typedef std::vector<std::pair<double, double>> BoundingBox_t;
 typedef std::shared_ptr<SimpleSetSet_t> SimpleSetSetPtr_t;
 
 template<typename... Args>
 SimpleSetSetPtr_t make_shared_simple_set_set(Args&&... args) {
-    return std::make_shared<SimpleSetSet_t>(std::forward<Args>(args)...);
+    return make_shared_in_scope<SimpleSetSet_t>(std::forward<Args>(args)...);
 }
 
+/**
+ * The container of the simple sets of a composite set, which is used like a SimpleSetSetPtr_t.
+ *
+ * Composite sets with a more compact representation (see Set) may defer creating the container. The first access
+ * through the handle fills it, such that all generic code sees the simple sets. Since the caller may modify the
+ * container afterwards, every access also marks it as observed, and from then on the container is the representation
+ * of the composite set.
+ *
+ * The composite set itself uses container() to access the container without filling or observing it.
+ */
+class SimpleSetSetHandle {
+public:
+
+    explicit SimpleSetSetHandle(const AbstractCompositeSet *owner) : owner_(owner) {
+    }
+
+    SimpleSetSetHandle(const SimpleSetSetHandle &) = delete;
+
+    SimpleSetSetHandle &operator=(const SimpleSetSetHandle &other) {
+        return *this = static_cast<const SimpleSetSetPtr_t &>(other);
+    }
+
+    SimpleSetSetHandle &operator=(SimpleSetSetPtr_t simple_sets) {
+        pointer_ = std::move(simple_sets);
+        deferred_.store(false, std::memory_order_release);
+        observed_.store(true, std::memory_order_relaxed);
+        return *this;
+    }
+
+    operator const SimpleSetSetPtr_t &() const {
+        return observe();
+    }
+
+    SimpleSetSet_t *operator->() const {
+        return observe().get();
+    }
+
+    SimpleSetSet_t &operator*() const {
+        return *observe();
+    }
+
+    /**
+     * @return The container without filling or observing it, which is nullptr while it is deferred.
+     */
+    const SimpleSetSetPtr_t &container() const {
+        return pointer_;
+    }
+
+    /**
+     * @return True if the container was accessed through this handle since it was deferred.
+     */
+    bool observed() const {
+        return observed_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Drop the container and create it on the first access.
+     */
+    void defer() {
+        pointer_ = nullptr;
+        observed_.store(false, std::memory_order_relaxed);
+        deferred_.store(true, std::memory_order_release);
+    }
+
+private:
+    const AbstractCompositeSet *owner_;
+    mutable SimpleSetSetPtr_t pointer_;
+    mutable std::atomic<bool> deferred_{false};
+    mutable std::atomic<bool> observed_{true};
+
+    const SimpleSetSetPtr_t &observe() const {
+        if (deferred_.load(std::memory_order_acquire)) {
+            fill();
+        }
+        if (!observed_.load(std::memory_order_relaxed)) {
+            observed_.store(true, std::memory_order_relaxed);
+        }
+        return pointer_;
+    }
+
+    /**
+     * Create the deferred container (see AbstractCompositeSet::make_simple_sets).
+     */
+    void fill() const;
+};
+
+/**
+ * Flag that marks a set as immutable, because it is shared as canonical instance of an InternTable.
+ * Copies start unfrozen, such that copying a frozen set is the way to obtain a modifiable one.
+ */
+class FrozenFlag {
+public:
+
+    FrozenFlag() = default;
+
+    FrozenFlag(const FrozenFlag &) {}
+
+    FrozenFlag &operator=(const FrozenFlag &) {
+        return *this;
+    }
+
+    void set() {
+        value_.store(true, std::memory_order_release);
+    }
+
+    bool get() const {
+        return value_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<bool> value_{false};
+};
+
 static std::string EMPTY_SET_SYMBOL = "∅";
 
+/**
+ * The minimal number of candidate pairs for which split_into_disjoint_and_non_disjoint intersects in parallel.
+ */
+static constexpr std::size_t PARALLEL_MIN_PAIRS = 256;
+
+/**
+ * The minimal number of candidate pairs per parallel task.
+ */
+static constexpr std::size_t PARALLEL_GRAIN = 32;
+
 union ElementaryVariant {
     float f;
     int i;
@@ -40,6 +174,9 @@ union ElementaryVariant {
 
 template <typename T>
 bool compare_sets(const T &lhs, const T &rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
     if (lhs->size() != rhs->size()) {
         return false;
     }
@@ -48,7 +185,7 @@ bool compare_sets(const T &lhs, const T &rhs) {
     auto it_rhs = rhs->begin();
 
     while (it_lhs != end_lhs) {
-        if (**it_lhs != **it_rhs) {
+        if (*it_lhs != *it_rhs && **it_lhs != **it_rhs) {
             return false;
         }
         ++it_lhs;
@@ -63,18 +200,36 @@ public:
 
     /**
     * Intersect this with another simple set.
+    * Results are memoized if the operation cache is enabled (see set_operation_cache_capacity).
     *
     * @param other the other simples set.
     * @return The intersection of both as simple set.
     */
-    virtual AbstractSimpleSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &other)= 0;
+    AbstractSimpleSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &other);
 
     /**
+    * Intersect this with another simple set without the operation cache.
+    * This method depends on the type of simple set and has to be overwritten.
+    *
+    * @param other the other simples set.
+    * @return The intersection of both as simple set.
+    */
+    virtual AbstractSimpleSetPtr_t intersection_with_impl(const AbstractSimpleSetPtr_t &other)= 0;
+
+    /**
+    * Results are memoized if the operation cache is enabled (see set_operation_cache_capacity).
+    *
+    * @return The complement of this simple set as disjoint composite set.
+    */
+    SimpleSetSetPtr_t complement();
+
+    /**
+    * Compute the complement without the operation cache.
     * This method depends on the type of simple set and has to be overwritten.
     *
     * @return The complement of this simple set as disjoint composite set.
     */
-    virtual SimpleSetSetPtr_t complement()= 0;
+    virtual SimpleSetSetPtr_t complement_impl()= 0;
 
     /**
     * Check if an elementary event is contained in this.
@@ -108,6 +263,100 @@ public:
 
     virtual bool operator<(const AbstractSimpleSet &other)= 0;
 
+    /**
+    * Hash this simple set by value. Equal simple sets have equal hashes.
+    * Only frozen simple sets cache their hash, since everything else may be modified in place.
+    *
+    * @return The hash of this simple set.
+    */
+    std::size_t hash() const {
+        if (is_frozen()) {
+            return cached_hash.get([this] { return compute_hash(); });
+        }
+        return compute_hash();
+    }
+
+    /**
+    * Compute the structural hash of this simple set (see hash.h).
+    *
+    * @return The hash of this simple set.
+    */
+    virtual std::size_t compute_hash() const= 0;
+
+    /**
+    * Append the ranges that enclose this simple set to a bounding box, one range per axis.
+    * Two simple sets whose bounding boxes (over the same axes) do not overlap have an empty intersection.
+    *
+    * Simple sets that cannot be enclosed by ranges keep the default, which appends nothing and returns false.
+    *
+    * @param box The box to append to.
+    * @return True if the ranges were appended.
+    */
+    virtual bool bounding_box(BoundingBox_t & /*box*/) {
+        return false;
+    }
+
+    /**
+    * Copy this simple set and everything it owns. The copy is allocated in the current operation arena or,
+    * outside of operation scopes, on the heap.
+    *
+    * @return The copy.
+    */
+    virtual AbstractSimpleSetPtr_t deep_copy()= 0;
+
+    /**
+    * Copy this simple set without copying the parts that it shares with other sets (e.g. the assignments of an
+    * event). The default is a deep copy.
+    *
+    * @return The copy.
+    */
+    virtual AbstractSimpleSetPtr_t shallow_copy() {
+        return deep_copy();
+    }
+
+    /**
+    * Copy the parts of this simple set that are allocated in an operation arena to the heap and share the others.
+    * The default deep copies this if it is allocated in the arena, which suits simple sets without shared parts.
+    *
+    * @param arena The arena.
+    * @return This if no part of it is allocated in the arena, else a copy without such parts.
+    */
+    virtual AbstractSimpleSetPtr_t promote(const OperationArena &arena);
+
+    /**
+    * Add the bytes of this simple set and of everything it references to an accountant.
+    *
+    * @param accountant The accountant.
+    * @param owned True if this simple set is uniquely owned.
+    */
+    virtual void account_memory(MemoryAccountant &accountant, bool owned) const= 0;
+
+    /**
+    * @return The heap footprint of this simple set and everything it references.
+    */
+    MemoryUsage memory_usage() const;
+
+    /**
+    * Mark this simple set as immutable, e.g. because an InternTable shares it.
+    */
+    void freeze() {
+        frozen.set();
+    }
+
+    /**
+    * @return True if this simple set is frozen (see freeze).
+    */
+    bool is_frozen() const {
+        return frozen.get();
+    }
+
+    /**
+    * Check that this simple set may be modified in place.
+    *
+    * @throws std::invalid_argument If this is frozen.
+    */
+    void check_mutable() const;
+
     bool operator!=(const AbstractSimpleSet &other);
 
     std::shared_ptr<AbstractSimpleSet> share_more()
@@ -115,6 +364,9 @@ public:
         return shared_from_this();
     }
 
+private:
+    CachedHash cached_hash;
+    FrozenFlag frozen;
 };
 
 /**
@@ -142,22 +394,27 @@ std::vector<std::tuple<T, T>> unique_combinations(const std::vector<T> &elements
 /**
 * Abstract class for composite elements.
 * Composite elements contain a **disjoint** union of (abstract) simple sets.
+*
+* The set operations are implemented generically via make_disjoint().
+* They are virtual, such that composite sets with more structure (e.g. a total order) can provide faster algorithms.
 */
 class AbstractCompositeSet : public std::enable_shared_from_this<AbstractCompositeSet>{
 public:
 
-    SimpleSetSetPtr_t simple_sets;
+    SimpleSetSetHandle simple_sets{this};
 
     AbstractCompositeSet() = default;
 
     virtual ~AbstractCompositeSet() {
-        simple_sets->clear();
+        if (simple_sets.container()) {
+            simple_sets.container()->clear();
+        }
     }
 
     /**
     * @return True if this is empty.
     */
-    bool is_empty();
+    virtual bool is_empty();
 
     /**
      * @return True if the composite set is disjoint union of simple sets.
@@ -183,9 +440,121 @@ public:
      */
     std::string *to_string();
 
-    bool operator==(const AbstractCompositeSet &other) const;
+    virtual bool operator==(const AbstractCompositeSet &other) const;
     bool operator!=(const AbstractCompositeSet &other) const;
-    bool operator<(const AbstractCompositeSet &other) const;
+
+    /**
+     * Hash this composite set by value (see compute_hash).
+     * Equal composite sets have equal hashes.
+     * Only frozen composite sets cache their hash, since everything else may be modified in place.
+     *
+     * @return The hash of this composite set.
+     */
+    std::size_t hash() const;
+
+    /**
+     * Mark this composite set as immutable, e.g. because an InternTable shares it.
+     */
+    void freeze() {
+        frozen.set();
+    }
+
+    /**
+     * @return True if this composite set is frozen (see freeze).
+     */
+    bool is_frozen() const {
+        return frozen.get();
+    }
+
+    /**
+     * Check that this composite set may be modified in place.
+     *
+     * @throws std::invalid_argument If this is frozen.
+     */
+    void check_mutable() const;
+
+    /**
+     * Compute the hash of this composite set from the hashes of its simple sets in their order.
+     *
+     * @return The hash of this composite set.
+     */
+    virtual std::size_t compute_hash() const;
+
+    virtual bool operator<(const AbstractCompositeSet &other) const;
+
+    /**
+    * Compute the range that encloses all simple sets of this, if they are one dimensional.
+    *
+    * @param range The range to write to.
+    * @return True if every simple set has a one dimensional bounding box and this is not empty.
+    */
+    virtual bool bounding_range(std::pair<double, double> &range) const;
+
+    /**
+    * Check if the bounding boxes of all simple sets in this refer to the same axes.
+    * This is true for one dimensional sets and has to be overwritten by products, where the axes are variables.
+    *
+    * @return True if the bounding boxes are comparable.
+    */
+    virtual bool has_aligned_axes() const {
+        return true;
+    }
+
+    /**
+    * Check if the bounding boxes of all simple sets in this and in another collection refer to the same axes.
+    *
+    * This is true for one dimensional sets and has to be overwritten by products, where the axes are variables.
+    *
+    * @param other The other simple sets, which have to be of the same kind as the simple sets of this.
+    * @return True if the bounding boxes of both sides are comparable.
+    */
+    virtual bool has_aligned_axes_with(const SimpleSetSetPtr_t & /*other*/) const {
+        return has_aligned_axes();
+    }
+
+    /**
+    * Copy this composite set and everything it owns (see AbstractSimpleSet::deep_copy).
+    *
+    * @return The copy.
+    */
+    virtual AbstractCompositeSetPtr_t deep_copy() const;
+
+    /**
+    * Copy the parts of this composite set that are allocated in an operation arena to the heap and share the others
+    * (see AbstractSimpleSet::promote). This promotes results of operations out of their arena.
+    *
+    * @param arena The arena.
+    * @return This if no part of it is allocated in the arena, else a copy without such parts.
+    */
+    AbstractCompositeSetPtr_t promote(const OperationArena &arena) const;
+
+    /**
+    * Copy this composite set, sharing its simple sets.
+    *
+    * @return The copy.
+    */
+    virtual AbstractCompositeSetPtr_t shallow_copy() const;
+
+    /**
+    * Add the bytes of this composite set and of everything it references to an accountant.
+    *
+    * @param accountant The accountant.
+    * @param owned True if this composite set is uniquely owned.
+    */
+    virtual void account_memory(MemoryAccountant &accountant, bool owned) const= 0;
+
+    /**
+    * Add the bytes of the container of simple sets and of the simple sets to an accountant.
+    *
+    * @param accountant The accountant.
+    * @param owned True if this composite set is uniquely owned.
+    */
+    void account_simple_sets(MemoryAccountant &accountant, bool owned) const;
+
+    /**
+    * @return The heap footprint of this composite set and everything it references.
+    */
+    MemoryUsage memory_usage() const;
 
     /**
     * Split this composite set into disjoint and non-disjoint parts.
@@ -200,6 +569,11 @@ public:
     *  - the difference of a simple set (A) and another simple set (B) that is completely contained in A (B ⊆ A).
     *      The result of that difference has to be a composite set with only one simple set in it.
     *
+    * Only pairs whose bounding boxes overlap are intersected (see overlapping_pairs). If the simple sets provide no
+    * bounding boxes, all pairs are candidates.
+    * If the thread count (see set_thread_count) is larger than one, the intersections of the candidates are computed
+    * in parallel. The result is identical to the sequential one.
+    *
     * @return A tuple of disjoint and non-disjoint composite sets.
     */
     std::tuple<AbstractCompositeSetPtr_t, AbstractCompositeSetPtr_t> split_into_disjoint_and_non_disjoint() const;
@@ -217,48 +591,83 @@ public:
      * @param simple_set The simple event to intersect with.
      * @return The intersection.
      */
-    AbstractCompositeSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &simple_set);
+    virtual AbstractCompositeSetPtr_t intersection_with(const AbstractSimpleSetPtr_t &simple_set);
 
-    AbstractCompositeSetPtr_t intersection_with(const SimpleSetSetPtr_t &other);
+    /**
+     * Form the intersection with a collection of simple sets.
+     * If the bounding boxes of both sides refer to the same axes, only the pairs of simple sets whose boxes overlap
+     * are intersected (see overlapping_pairs), otherwise all pairs are.
+     * @param other The simple sets to intersect with.
+     * @return The intersection.
+     */
+    virtual AbstractCompositeSetPtr_t intersection_with(const SimpleSetSetPtr_t &other);
 
     /**
     * Form the intersection with another composite set.
     *
     * The intersection is only disjoint if both composite sets are disjoint.
     *
+    * Results are memoized if the operation cache is enabled (see set_operation_cache_capacity).
+    *
     * @param other The other composite set.
     * @return The intersection as composite set.
     */
     AbstractCompositeSetPtr_t intersection_with(const AbstractCompositeSetPtr_t &other);
 
     /**
+    * Form the intersection with another composite set without the operation cache.
+    *
+    * @param other The other composite set.
+    * @return The intersection as composite set.
+    */
+    virtual AbstractCompositeSetPtr_t intersection_with_impl(const AbstractCompositeSetPtr_t &other);
+
+    /**
+     * Results are memoized if the operation cache is enabled (see set_operation_cache_capacity).
+     *
      * @return the complement of a composite set as disjoint composite set.
      */
     AbstractCompositeSetPtr_t complement() const;
 
+    /**
+     * Compute the complement without the operation cache.
+     *
+     * @return the complement of a composite set as disjoint composite set.
+     */
+    virtual AbstractCompositeSetPtr_t complement_impl() const;
+
     /**
     * Form the union with a simple set.
     *
     * @param other The other simple set.
     * @return The union as disjoint composite set.
     */
-    AbstractCompositeSetPtr_t union_with(const AbstractSimpleSetPtr_t &other);
+    virtual AbstractCompositeSetPtr_t union_with(const AbstractSimpleSetPtr_t &other);
 
     /**
     * Form the union with another composite set.
+    * Results are memoized if the operation cache is enabled (see set_operation_cache_capacity).
     *
     * @param other The other composite set.
     * @return The union as disjoint composite set.
     */
     AbstractCompositeSetPtr_t union_with(const AbstractCompositeSetPtr_t &other);
 
+    /**
+    * Form the union with another composite set without the operation cache.
+    *
+    * @param other The other composite set.
+    * @return The union as disjoint composite set.
+    */
+    virtual AbstractCompositeSetPtr_t union_with_impl(const AbstractCompositeSetPtr_t &other);
+
     /**
      * Form the difference with a simple set.
      *
      * @param other the simple set
      * @return The difference as disjoint composite set.
      */
-    AbstractCompositeSetPtr_t difference_with(const AbstractSimpleSetPtr_t &other);
+    virtual AbstractCompositeSetPtr_t difference_with(const AbstractSimpleSetPtr_t &other);
 
     /**
      * Form the difference with another composite set.
@@ -266,10 +675,33 @@ public:
      * @param other The other composite set.
      * @return The difference as disjoint composite set.
      */
-    AbstractCompositeSetPtr_t difference_with(const AbstractCompositeSetPtr_t &other);
+    virtual AbstractCompositeSetPtr_t difference_with(const AbstractCompositeSetPtr_t &other);
 
     bool contains(const AbstractCompositeSetPtr_t &other);
 
+    /**
+     * Insert a simple set into this.
+     *
+     * @param simple_set The simple set.
+     * @throws std::invalid_argument If this is frozen.
+     */
     void add_new_simple_set(const AbstractSimpleSetPtr_t& simple_set) const;
 
+protected:
+
+    /**
+    * Create the container of a composite set that deferred it (see SimpleSetSetHandle::defer).
+    * This is called once, outside of any operation arena.
+    *
+    * @return The filled container.
+    */
+    virtual SimpleSetSetPtr_t make_simple_sets() const {
+        return make_shared_simple_set_set();
+    }
+
+private:
+    CachedHash cached_hash;
+    FrozenFlag frozen;
+
+    friend class SimpleSetSetHandle;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sigma_algebra.h"
+#include <vector>
+
+// TYPEDEFS
+using AssignmentRow_t = std::vector<AbstractCompositeSetPtr_t>;
+using AssignmentRows_t = std::vector<AssignmentRow_t>;
+
+/**
+ * Simplify a union of products by merging rows that differ in exactly one column.
+ *
+ * Every row is a product of composite sets (e.g. the assignments of a simple event) and all rows have the same
+ * columns (e.g. the same variables in the same order).
+ * For every column, each row is hashed by its cells with that column left out (its signature).
+ * Rows that share a signature and are equal in all other columns are merged in one pass by forming the union of
+ * their cells in the left out column.
+ * This is repeated for all columns until no rows can be merged anymore.
+ *
+ * Per pass this costs O(n * v) hash operations instead of the O(n^2 * v) comparisons of a pairwise search.
+ *
+ * @param rows The rows, modified in place.
+ * @return True if any rows were merged.
+ */
+bool simplify_by_signature(AssignmentRows_t &rows);
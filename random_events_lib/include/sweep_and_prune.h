@@ -0,0 +1,44 @@
+#pragma once
+
+#include "sigma_algebra.h"
+#include <utility>
+#include <vector>
+
+// TYPEDEFS
+using IndexPairs_t = std::vector<std::pair<std::size_t, std::size_t>>;
+
+/**
+ * Check if two bounding boxes over the same axes overlap on every axis. Ranges are treated as closed.
+ *
+ * @param lhs The first box.
+ * @param rhs The second box.
+ * @return True if the boxes overlap.
+ */
+bool boxes_overlap(const BoundingBox_t &lhs, const BoundingBox_t &rhs);
+
+/**
+ * Find all pairs of overlapping bounding boxes with a sort-and-sweep.
+ *
+ * The boxes are sorted by their lower bound on the sweep axis and every box is only tested against the boxes that
+ * start before it ends on that axis. The sweep axis is the one where the fewest pairs overlap, which is counted
+ * in O(n log n) per axis before sweeping.
+ * For sparse collections this is near-linear instead of the O(n^2) of testing all pairs.
+ *
+ * @param boxes The boxes. All boxes need to have the same axes.
+ * @return The pairs (i, j) with i < j of overlapping boxes in lexicographical order.
+ */
+IndexPairs_t overlapping_pairs(const std::vector<BoundingBox_t> &boxes);
+
+/**
+ * Find all pairs of overlapping bounding boxes between two collections with a sort-and-sweep.
+ *
+ * Both collections are sorted by their lower bound on the sweep axis. Every box is then only tested against the boxes
+ * of the other collection that start at or after it and before it ends on that axis, which finds every overlapping
+ * pair exactly once. The sweep axis is the one where the fewest pairs overlap.
+ * For sparse collections this is near-linear instead of the O(n m) of testing all pairs.
+ *
+ * @param lhs The first boxes.
+ * @param rhs The second boxes. All boxes of both collections need to have the same axes.
+ * @return The pairs (i, j) of overlapping boxes lhs[i] and rhs[j] in lexicographical order.
+ */
+IndexPairs_t overlapping_pairs(const std::vector<BoundingBox_t> &lhs, const std::vector<BoundingBox_t> &rhs);
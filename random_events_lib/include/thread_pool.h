@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// FORWARD DECLARATIONS
+class ThreadPool;
+
+// TYPEDEFS
+using ThreadPoolPtr_t = std::shared_ptr<ThreadPool>;
+using RangeFunction_t = std::function<void(std::size_t, std::size_t)>;
+
+/**
+ * Class that represents a pool of worker threads with work stealing.
+ *
+ * Every worker owns a queue of tasks. Workers take tasks from the back of their own queue and, once it is empty,
+ * steal tasks from the front of the queues of other workers. The thread that waits for a parallel_for also
+ * executes tasks instead of blocking.
+ */
+class ThreadPool {
+public:
+
+    /**
+     * Create a pool.
+     * @param thread_count The number of worker threads.
+     */
+    explicit ThreadPool(std::size_t thread_count);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @return The number of worker threads.
+     */
+    std::size_t thread_count() const {
+        return threads_.size();
+    }
+
+    /**
+     * Call a function on chunks of [begin, end) in parallel and wait for all chunks to finish.
+     * The first exception thrown by a chunk is rethrown after all chunks finished.
+     *
+     * Calls from within a worker thread run sequentially in the calling thread.
+     *
+     * @param begin The first index.
+     * @param end The index after the last index.
+     * @param function The function that is called with the bounds [chunk_begin, chunk_end) of each chunk.
+     * @param grain The minimal number of indices per chunk.
+     */
+    void parallel_for(std::size_t begin, std::size_t end, const RangeFunction_t &function, std::size_t grain = 1);
+
+private:
+
+    using Task_t = std::function<void()>;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> queued_{0};
+    bool stopping_ = false;
+
+    void run_worker(std::size_t index);
+
+    /**
+     * Take a task, preferring the back of the queue with the given index and stealing from the front of the others.
+     */
+    bool take_task(std::size_t preferred, Task_t &task);
+};
+
+/**
+ * Set the number of threads used by parallel algorithms such as AbstractCompositeSet::make_disjoint.
+ * A value of 1 (the default) runs everything in the calling thread, 0 uses all hardware threads.
+ * Must not be called while a parallel algorithm is running in another thread.
+ *
+ * @param thread_count The number of threads.
+ */
+void set_thread_count(std::size_t thread_count);
+
+/**
+ * @return The number of threads used by parallel algorithms.
+ */
+std::size_t get_thread_count();
+
+/**
+ * Call a function on chunks of [begin, end) with the shared pool, or sequentially if the thread count is 1.
+ *
+ * @param begin The first index.
+ * @param end The index after the last index.
+ * @param function The function that is called with the bounds [chunk_begin, chunk_end) of each chunk.
+ * @param grain The minimal number of indices per chunk.
+ */
+void parallel_for(std::size_t begin, std::size_t end, const RangeFunction_t &function, std::size_t grain = 1);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * Start recording spans. The spans are written to the given file in the Chrome trace-event JSON format
+ * (readable by chrome://tracing and Perfetto) when tracing is stopped. A running trace is stopped first.
+ *
+ * @param path The path of the trace file.
+ * @throws std::runtime_error if the file cannot be opened.
+ */
+void start_tracing(const std::string &path);
+
+/**
+ * Stop recording spans and write the trace file. Does nothing if tracing is not running.
+ */
+void stop_tracing();
+
+/**
+ * @return True if spans are recorded.
+ */
+bool tracing_enabled();
+
+/**
+ * Class that records the wall-clock time of a scope as a complete event, if tracing is enabled when it is created.
+ * Every span records the number of simple sets of its input and output as arguments.
+ * Spans on the same thread nest by their time ranges.
+ */
+class TraceSpan {
+public:
+
+    /**
+     * Start a span.
+     * @param name The name of the span. Has to outlive the span, e.g. a string literal.
+     * @param input_simple_sets The number of simple sets of the input.
+     */
+    TraceSpan(const char *name, std::size_t input_simple_sets);
+
+    TraceSpan(const TraceSpan &) = delete;
+
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /**
+     * End the span and record it.
+     */
+    ~TraceSpan();
+
+    /**
+     * @return True if this span is recorded.
+     */
+    bool active() const {
+        return active_;
+    }
+
+    /**
+     * Set the number of simple sets of the output.
+     * @param output_simple_sets The number.
+     */
+    void set_output(std::size_t output_simple_sets) {
+        output_simple_sets_ = output_simple_sets;
+    }
+
+private:
+    const char *name_;
+    bool active_;
+    std::size_t input_simple_sets_;
+    std::size_t output_simple_sets_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
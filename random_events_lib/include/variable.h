@@ -16,6 +16,26 @@ public:
 
     virtual AbstractCompositeSetPtr_t get_domain() const = 0;
 
+    /**
+     * Add the bytes of this variable, its name and its domain to an accountant.
+     *
+     * @param accountant The accountant.
+     * @param owned True if this variable is uniquely owned.
+     */
+    virtual void account_memory(MemoryAccountant &accountant, bool owned) const = 0;
+
+    /**
+     * @return The heap footprint of this variable, its name and its domain.
+     */
+    MemoryUsage memory_usage() const {
+        MemoryAccountant accountant;
+        do {
+            accountant.enter(this);
+            account_memory(accountant, true);
+        } while (accountant.next_pass());
+        return accountant.usage();
+    }
+
     bool operator==(const AbstractVariable &other) const {
         return *name == *other.name;
     }
@@ -35,6 +55,29 @@ public:
     bool operator<(const AbstractVariable &other) const {
         return *name < *other.name;
     }
+
+protected:
+
+    /**
+     * Add the bytes of the name to an accountant.
+     */
+    void account_name(MemoryAccountant &accountant, bool owned) const {
+        bool name_owned;
+        if (accountant.enter(name, owned, name_owned)) {
+            accountant.add(sizeof(std::string) + string_heap_bytes(*name), name_owned);
+        }
+    }
+
+    /**
+     * Add the bytes of a domain to an accountant.
+     */
+    template<typename Domain>
+    static void account_domain(MemoryAccountant &accountant, const std::shared_ptr<Domain> &domain, bool owned) {
+        bool domain_owned;
+        if (accountant.enter(domain, owned, domain_owned)) {
+            domain->account_memory(accountant, domain_owned);
+        }
+    }
 };
 
 using AbstractVariablePtr_t = std::shared_ptr<AbstractVariable>;
@@ -55,17 +98,19 @@ public:
 
     Symbolic(const NamePtr_t& name, const AllSetElementsPtr_t& all_set_elements) {
         this->name = name;
-        auto domain_ = make_shared_set(all_set_elements);
-        for (const auto& element: *all_set_elements) {
-            auto set_element = make_shared_set_element(element, all_set_elements);
-            domain_->simple_sets->insert(set_element);
-        }
-        this->domain = domain_;
+        // the domain contains every element of the universe
+        this->domain = make_shared_set(DynamicBitset(all_set_elements->size()).flip(), all_set_elements);
     }
 
     AbstractCompositeSetPtr_t get_domain() const override {
         return domain;
     }
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override {
+        accountant.add(sizeof(Symbolic), owned);
+        account_name(accountant, owned);
+        account_domain(accountant, domain, owned);
+    }
 };
 
 class Continuous : public AbstractVariable {
@@ -83,6 +128,12 @@ public:
     AbstractCompositeSetPtr_t get_domain() const override {
         return domain;
     }
+
+    void account_memory(MemoryAccountant &accountant, bool owned) const override {
+        accountant.add(sizeof(Continuous), owned);
+        account_name(accountant, owned);
+        account_domain(accountant, domain, owned);
+    }
 };
 
 class Integer : public AbstractVariable {
@@ -101,6 +152,12 @@ public:
         return domain;
     }
 
+    void account_memory(MemoryAccountant &accountant, bool owned) const override {
+        accountant.add(sizeof(Integer), owned);
+        account_name(accountant, owned);
+        account_domain(accountant, domain, owned);
+    }
+
 };
 
 
@@ -123,3 +180,18 @@ ContinuousPtr_t make_shared_continuous(Args &&... args) {
     return std::make_shared<Continuous>(std::forward<Args>(args)...);
 }
 
+/**
+ * Add the bytes of a variable that is referenced by a shared pointer to an accountant.
+ *
+ * @param accountant The accountant.
+ * @param variable The variable.
+ * @param owner_owned True if the owner of the pointer is uniquely owned.
+ */
+inline void account_variable(MemoryAccountant &accountant, const std::shared_ptr<AbstractVariable> &variable,
+                             bool owner_owned) {
+    bool owned;
+    if (accountant.enter(variable, owner_owned, owned)) {
+        variable->account_memory(accountant, owned);
+    }
+}
+
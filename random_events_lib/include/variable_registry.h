@@ -0,0 +1,96 @@
+#pragma once
+
+#include "product_algebra.h"
+#include "variable.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// FORWARD DECLARATIONS
+class VariableRegistry;
+
+// TYPEDEFS
+using VariableRegistryPtr_t = std::shared_ptr<VariableRegistry>;
+
+template<typename... Args>
+VariableRegistryPtr_t make_shared_variable_registry(Args &&... args) {
+    return std::make_shared<VariableRegistry>(std::forward<Args>(args)...);
+}
+
+/**
+ * Class that assigns every variable a small, dense integer ID.
+ *
+ * Variables are identified by their name, as in the comparison operators of AbstractVariable.
+ * IDs are handed out in registration order and never change, so data structures can store per-variable
+ * information in flat vectors indexed by ID.
+ */
+class VariableRegistry {
+public:
+
+    VariableRegistry() = default;
+
+    /**
+     * Create a registry that contains the given variables.
+     * The variables are registered in their (name) order, hence the order of IDs agrees with the order of variables.
+     *
+     * @param variables The variables.
+     */
+    explicit VariableRegistry(const VariableSetPtr_t &variables);
+
+    /**
+     * Register a variable.
+     *
+     * @param variable The variable.
+     * @return The ID of the variable. If a variable with the same name is already registered, its ID is returned.
+     */
+    std::size_t register_variable(const AbstractVariablePtr_t &variable);
+
+    /**
+     * @param variable The variable.
+     * @return True if a variable with the same name is registered.
+     */
+    bool contains(const AbstractVariablePtr_t &variable) const;
+
+    /**
+     * Get the ID of a registered variable.
+     *
+     * @param variable The variable.
+     * @return The ID of the variable.
+     * @throws std::out_of_range if the variable is not registered.
+     */
+    std::size_t id_of(const AbstractVariablePtr_t &variable) const;
+
+    /**
+     * @param id The ID.
+     * @return The variable with the given ID.
+     */
+    const AbstractVariablePtr_t &variable(std::size_t id) const {
+        return variables_.at(id);
+    }
+
+    /**
+     * @return All registered variables, indexed by their ID.
+     */
+    const std::vector<AbstractVariablePtr_t> &variables() const {
+        return variables_;
+    }
+
+    /**
+     * @return The number of registered variables.
+     */
+    std::size_t size() const {
+        return variables_.size();
+    }
+
+    /**
+     * Add the bytes of this registry, its index and its variables to an accountant.
+     *
+     * @param accountant The accountant.
+     * @param owned True if this registry is uniquely owned.
+     */
+    void account_memory(MemoryAccountant &accountant, bool owned) const;
+
+private:
+    std::vector<AbstractVariablePtr_t> variables_;
+    std::unordered_map<std::string, std::size_t> ids_;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "interval.h"
+#include "product_algebra.h"
+#include "set.h"
+#include "variable.h"
+#include <cstdint>
+#include <random>
+
+/**
+ * Parameters of a WorkloadGenerator.
+ */
+struct WorkloadConfig {
+
+    /**
+     * The seed. Equal configurations produce equal workloads on every platform.
+     */
+    std::uint64_t seed = 0;
+
+    /**
+     * The number of continuous variables, named x0, x1, ...
+     */
+    std::size_t continuous_variables = 2;
+
+    /**
+     * The number of symbolic variables, named s0, s1, ...
+     */
+    std::size_t symbolic_variables = 0;
+
+    /**
+     * The number of integer variables, named i0, i1, ...
+     */
+    std::size_t integer_variables = 0;
+
+    /**
+     * The number of elements of the universe of every symbolic variable.
+     */
+    std::size_t universe_size = 8;
+
+    /**
+     * The number of disjoint pieces of every generated interval.
+     */
+    std::size_t pieces_per_interval = 1;
+
+    /**
+     * The probability that two generated simple events (or intervals, or sets) intersect, in [0, 1].
+     * It is exact for single piece intervals and sets; with more pieces it is the probability that the hulls intersect.
+     */
+    double overlap_density = 0.5;
+
+    /**
+     * The number of simple events of a generated event.
+     */
+    std::size_t event_count = 16;
+
+    /**
+     * The width of the range [0, domain_width] in which intervals of continuous and integer variables are placed.
+     */
+    double domain_width = 100;
+};
+
+/**
+ * Class that produces seeded, parameterized intervals, sets, simple events and events for benchmarks and stress tests.
+ *
+ * The variables are created once per generator. Every call draws the next object from the same random stream, so a
+ * generator that is constructed with the same configuration reproduces the same sequence of objects.
+ */
+class WorkloadGenerator {
+public:
+
+    explicit WorkloadGenerator(const WorkloadConfig &config = WorkloadConfig());
+
+    /**
+     * @return The configuration.
+     */
+    const WorkloadConfig &config() const {
+        return config_;
+    }
+
+    /**
+     * @return The variables of the generated events, i.e. the continuous, symbolic and integer variables.
+     */
+    const VariableSetPtr_t &variables() const {
+        return variables_;
+    }
+
+    /**
+     * @return The universe of the symbolic variables.
+     */
+    const AllSetElementsPtr_t &all_elements() const {
+        return all_elements_;
+    }
+
+    /**
+     * @return A continuous interval with pieces_per_interval pieces.
+     * Two such intervals intersect with probability overlap_density.
+     */
+    IntervalPtr_t interval();
+
+    /**
+     * @return A non-empty set over the universe.
+     * Two such sets intersect with (at least) probability overlap_density.
+     */
+    SetPtr_t set();
+
+    /**
+     * @return A simple event that assigns every variable.
+     * Two such simple events intersect with probability overlap_density.
+     */
+    SimpleEventPtr_t simple_event();
+
+    /**
+     * @return An event of event_count simple events (fewer if equal simple events were drawn).
+     * The simple events are in general not disjoint.
+     */
+    EventPtr_t event();
+
+private:
+    WorkloadConfig config_;
+    std::mt19937_64 engine_;
+    VariableSetPtr_t variables_;
+    AllSetElementsPtr_t all_elements_;
+
+    /**
+     * @return A uniform sample from [lower, upper).
+     */
+    double uniform(double lower, double upper);
+
+    /**
+     * Generate an interval within [0, domain_width], such that two of them intersect with the given probability.
+     * @param probability The probability.
+     * @param integral True if all bounds are integers.
+     * @return The interval.
+     */
+    IntervalPtr_t interval(double probability, bool integral);
+
+    /**
+     * Generate a set, such that two of them intersect with at least the given probability.
+     * @param probability The probability.
+     * @return The set.
+     */
+    SetPtr_t set(double probability);
+};
@@ -0,0 +1,48 @@
+#include "arena.h"
+#include <atomic>
+
+namespace {
+    thread_local OperationArena *current_arena = nullptr;
+    std::atomic<bool> arenas_enabled{true};
+}
+
+OperationArena *OperationArena::current() {
+    return current_arena;
+}
+
+OperationScope::OperationScope() {
+    outermost_ = !current_arena && arenas_enabled.load(std::memory_order_relaxed);
+    if (outermost_) {
+        current_arena = new OperationArena();
+        current_arena->acquire();
+    }
+}
+
+OperationScope::~OperationScope() {
+    close();
+}
+
+void OperationScope::close() {
+    if (outermost_) {
+        auto arena = current_arena;
+        current_arena = nullptr;
+        outermost_ = false;
+        arena->release();
+    }
+}
+
+ArenaSuspension::ArenaSuspension() : suspended_(current_arena) {
+    current_arena = nullptr;
+}
+
+ArenaSuspension::~ArenaSuspension() {
+    current_arena = suspended_;
+}
+
+void set_arenas_enabled(bool enabled) {
+    arenas_enabled = enabled;
+}
+
+bool get_arenas_enabled() {
+    return arenas_enabled;
+}
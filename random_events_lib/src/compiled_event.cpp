@@ -0,0 +1,221 @@
+#include "compiled_event.h"
+#include "flat_interval.h"
+#include "set.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    inline bool piece_contains(const double value, const double lower, const double upper,
+                               const std::uint8_t borders) {
+        return (value > lower || (value == lower && (borders & LEFT_CLOSED_BIT))) &&
+               (value < upper || (value == upper && (borders & RIGHT_CLOSED_BIT)));
+    }
+}
+
+CompiledEvent::CompiledEvent(const Event &event) {
+    registry_ = make_shared_variable_registry(make_shared_variable_set(event.get_variables_from_simple_events()));
+    const auto variable_count = registry_->size();
+
+    box_offsets_.push_back(0);
+    for (const auto &simple_set: *event.simple_sets) {
+        const auto &variable_map = *static_cast<SimpleEvent *>(simple_set.get())->variable_map;
+        // a simple event without variables is empty, not the box of all rows
+        if (variable_map.empty()) {
+            continue;
+        }
+        const auto box_begin = lowers_.size();
+        bool empty = false;
+        for (const auto &variable: registry_->variables()) {
+            const auto assignment = variable_map.find(variable);
+            if (assignment == variable_map.end()) {
+                lowers_.push_back(-std::numeric_limits<double>::infinity());
+                uppers_.push_back(std::numeric_limits<double>::infinity());
+                borders_.push_back(0);
+            } else if (const auto interval = dynamic_cast<Interval *>(assignment->second.get())) {
+                const FlatInterval flat(*interval);
+                lowers_.insert(lowers_.end(), flat.lowers().begin(), flat.lowers().end());
+                uppers_.insert(uppers_.end(), flat.uppers().begin(), flat.uppers().end());
+                borders_.insert(borders_.end(), flat.borders().begin(), flat.borders().end());
+            } else if (const auto set = dynamic_cast<Set *>(assignment->second.get())) {
+                // consecutive element indices form one piece
+                std::vector<long long> indices(set->cardinality());
+                set->to_indices(indices.data());
+                for (std::size_t index = 0; index < indices.size(); ++index) {
+                    if (index > 0 && indices[index] == indices[index - 1] + 1) {
+                        uppers_.back() = static_cast<double>(indices[index]);
+                        continue;
+                    }
+                    lowers_.push_back(static_cast<double>(indices[index]));
+                    uppers_.push_back(static_cast<double>(indices[index]));
+                    borders_.push_back(LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT);
+                }
+            } else {
+                throw std::invalid_argument("variable " + *variable->name +
+                                            " is neither assigned an Interval nor a Set");
+            }
+            if (lowers_.size() == box_offsets_.back()) {
+                empty = true;
+                break;
+            }
+            box_offsets_.push_back(static_cast<std::uint32_t>(lowers_.size()));
+        }
+
+        // an empty simple event contains no row, hence it is dropped
+        if (empty) {
+            box_offsets_.resize(box_count_ * variable_count + 1);
+            lowers_.resize(box_begin);
+            uppers_.resize(box_begin);
+            borders_.resize(box_begin);
+            continue;
+        }
+        ++box_count_;
+    }
+
+    std::vector<std::uint32_t> boxes(box_count_);
+    for (std::uint32_t box = 0; box < box_count_; ++box) {
+        boxes[box] = box;
+    }
+    duplication_budget_ = COMPILED_EVENT_DUPLICATION * box_count_;
+    root_ = build(std::move(boxes), 0);
+}
+
+bool CompiledEvent::reaches_below(const std::uint32_t box, const std::uint32_t variable,
+                                  const double threshold) const {
+    // the pieces are sorted by their lower bound
+    return lowers_[box_offsets_[box * registry_->size() + variable]] < threshold;
+}
+
+bool CompiledEvent::reaches_above(const std::uint32_t box, const std::uint32_t variable,
+                                  const double threshold) const {
+    const auto last = box_offsets_[box * registry_->size() + variable + 1] - 1;
+    return uppers_[last] > threshold || (uppers_[last] == threshold && (borders_[last] & RIGHT_CLOSED_BIT));
+}
+
+std::int32_t CompiledEvent::make_leaf(const std::vector<std::uint32_t> &boxes) {
+    leaf_boxes_.insert(leaf_boxes_.end(), boxes.begin(), boxes.end());
+    leaf_offsets_.push_back(static_cast<std::uint32_t>(leaf_boxes_.size()));
+    return ~static_cast<std::int32_t>(leaf_offsets_.size() - 2);
+}
+
+std::int32_t CompiledEvent::build(std::vector<std::uint32_t> boxes, const std::size_t depth) {
+    depth_ = std::max(depth_, depth);
+    if (boxes.size() <= COMPILED_EVENT_LEAF_SIZE || depth >= COMPILED_EVENT_MAX_DEPTH) {
+        return make_leaf(boxes);
+    }
+
+    // Try the quartiles of the finite bounds of every variable and keep the threshold whose larger side is smallest.
+    const auto variable_count = static_cast<std::uint32_t>(registry_->size());
+    std::size_t best_larger = boxes.size(), best_total = 2 * boxes.size();
+    std::uint32_t best_variable = 0;
+    double best_threshold = 0;
+    std::vector<double> bounds;
+    for (std::uint32_t variable = 0; variable < variable_count; ++variable) {
+        bounds.clear();
+        for (const auto box: boxes) {
+            const auto begin = box_offsets_[box * variable_count + variable];
+            const auto end = box_offsets_[box * variable_count + variable + 1];
+            for (auto piece = begin; piece < end; ++piece) {
+                for (const auto bound: {lowers_[piece], uppers_[piece]}) {
+                    if (std::isfinite(bound)) {
+                        bounds.push_back(bound);
+                    }
+                }
+            }
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+        if (bounds.empty()) {
+            continue;
+        }
+
+        for (const auto quantile: {2, 1, 3}) {
+            const double threshold = bounds[bounds.size() * quantile / 4];
+            std::size_t below = 0, above = 0;
+            for (const auto box: boxes) {
+                below += reaches_below(box, variable, threshold);
+                above += reaches_above(box, variable, threshold);
+            }
+            const auto larger = std::max(below, above);
+            if (larger < best_larger || (larger == best_larger && below + above < best_total)) {
+                best_larger = larger;
+                best_total = below + above;
+                best_variable = variable;
+                best_threshold = threshold;
+            }
+        }
+    }
+
+    // no threshold separates any simple event from the others, or the split duplicates too many
+    const auto duplicated = best_total - boxes.size();
+    if (best_larger == boxes.size() || duplicated > duplication_budget_) {
+        return make_leaf(boxes);
+    }
+    duplication_budget_ -= duplicated;
+
+    std::vector<std::uint32_t> below, above;
+    for (const auto box: boxes) {
+        if (reaches_below(box, best_variable, best_threshold)) {
+            below.push_back(box);
+        }
+        if (reaches_above(box, best_variable, best_threshold)) {
+            above.push_back(box);
+        }
+    }
+    boxes.clear();
+    boxes.shrink_to_fit();
+
+    const auto index = static_cast<std::int32_t>(nodes_.size());
+    nodes_.push_back(Node{best_threshold, best_variable, {0, 0}});
+    const auto left = build(std::move(below), depth + 1);
+    const auto right = build(std::move(above), depth + 1);
+    nodes_[index].children[0] = left;
+    nodes_[index].children[1] = right;
+    return index;
+}
+
+template<typename Value>
+bool CompiledEvent::contains_values(const Value &value) const {
+    auto reference = root_;
+    while (reference >= 0) {
+        const auto &node = nodes_[reference];
+        reference = node.children[value(node.variable) >= node.threshold];
+    }
+
+    const auto leaf = static_cast<std::size_t>(~reference);
+    const auto variable_count = registry_->size();
+    for (auto position = leaf_offsets_[leaf]; position < leaf_offsets_[leaf + 1]; ++position) {
+        const auto offsets = box_offsets_.data() + leaf_boxes_[position] * variable_count;
+        bool contained = true;
+        for (std::size_t variable = 0; variable < variable_count && contained; ++variable) {
+            const double x = value(variable);
+            const auto begin = offsets[variable], end = offsets[variable + 1];
+
+            // the last piece whose lower bound is not greater than the value is the only candidate
+            const auto candidate = std::upper_bound(lowers_.data() + begin, lowers_.data() + end, x) -
+                                   lowers_.data();
+            contained = candidate > begin &&
+                        piece_contains(x, lowers_[candidate - 1], uppers_[candidate - 1], borders_[candidate - 1]);
+        }
+        if (contained) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CompiledEvent::contains(const double *row) const {
+    return contains_values([row](const std::size_t variable) { return row[variable]; });
+}
+
+void CompiledEvent::contains(const double *const *columns, const std::size_t rows, std::uint8_t *mask) const {
+    parallel_for(0, rows, [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t row = begin; row < end; ++row) {
+            mask[row] = contains_values([columns, row](const std::size_t variable) {
+                return columns[variable][row];
+            });
+        }
+    }, COMPILED_EVENT_GRAIN);
+}
@@ -0,0 +1,280 @@
+#include "dense_product_algebra.h"
+#include "signature_simplification.h"
+#include <algorithm>
+
+//
+// ===============================
+//  —— DenseSimpleEvent (atomic) ——
+// ===============================
+//
+
+DenseSimpleEvent::DenseSimpleEvent(const VariableRegistryPtr_t &registry_) {
+    registry = registry_;
+    assignments.reserve(registry->size());
+    for (auto const &variable : registry->variables()) {
+        assignments.push_back(variable->get_domain());
+    }
+}
+
+DenseSimpleEvent::DenseSimpleEvent(const VariableRegistryPtr_t &registry_, Assignments_t assignments_) {
+    registry = registry_;
+    assignments = std::move(assignments_);
+}
+
+DenseSimpleEvent::DenseSimpleEvent(const VariableRegistryPtr_t &registry_, const SimpleEvent &simple_event) {
+    registry = registry_;
+    for (auto const &kv : *simple_event.variable_map) {
+        registry->register_variable(kv.first);
+    }
+
+    // every slot starts as domain; the variables of the simple event overwrite theirs
+    assignments.reserve(registry->size());
+    for (auto const &variable : registry->variables()) {
+        assignments.push_back(variable->get_domain());
+    }
+    for (auto const &kv : *simple_event.variable_map) {
+        assignments[registry->id_of(kv.first)] = kv.second;
+    }
+}
+
+AbstractCompositeSetPtr_t DenseSimpleEvent::assignment(const std::size_t id) const {
+    if (id < assignments.size()) {
+        return assignments[id];
+    }
+    return registry->variable(id)->get_domain();
+}
+
+SimpleEventPtr_t DenseSimpleEvent::to_simple_event() const {
+    auto result = make_shared_simple_event();
+    for (std::size_t id = 0; id < registry->size(); ++id) {
+        result->variable_map->insert({registry->variable(id), assignment(id)});
+    }
+    return result;
+}
+
+AbstractSimpleSetPtr_t DenseSimpleEvent::intersection_with_impl(const AbstractSimpleSetPtr_t &other) {
+    const auto &rhs = static_cast<const DenseSimpleEvent &>(*other);
+    const std::size_t slots = std::max(assignments.size(), rhs.assignments.size());
+
+    // aligned slots: one intersection per variable, no key merging
+    Assignments_t result;
+    result.reserve(slots);
+    for (std::size_t id = 0; id < slots; ++id) {
+        auto lhs_assignment = assignment(id);
+        auto rhs_assignment = rhs.assignment(id);
+        if (lhs_assignment == rhs_assignment) {
+            result.push_back(lhs_assignment);
+        } else {
+            result.push_back(lhs_assignment->intersection_with(rhs_assignment));
+        }
+    }
+    return make_shared_dense_simple_event(registry, std::move(result));
+}
+
+SimpleSetSetPtr_t DenseSimpleEvent::complement_impl() {
+    // Same construction as SimpleEvent::complement: slot i is complemented, earlier slots keep their assignment and
+    // later slots are set to their domain. Every candidate is a copy of one vector instead of a map built by inserts.
+    auto result = make_shared_simple_set_set();
+    const std::size_t slots = assignments.size();
+
+    Assignments_t current;
+    current.reserve(slots);
+    for (std::size_t id = 0; id < slots; ++id) {
+        current.push_back(registry->variable(id)->get_domain());
+    }
+
+    for (std::size_t id = 0; id < slots; ++id) {
+        auto candidate = current;
+        candidate[id] = assignments[id]->complement();
+        auto complement_event = make_shared_dense_simple_event(registry, std::move(candidate));
+        if (!complement_event->is_empty()) {
+            result->insert(complement_event);
+        }
+        current[id] = assignments[id];
+    }
+    return result;
+}
+
+bool DenseSimpleEvent::contains(const ElementaryVariant * /*element*/) {
+    return false;
+}
+
+bool DenseSimpleEvent::is_empty() {
+    if (assignments.empty()) {
+        return true;
+    }
+    return std::any_of(assignments.begin(), assignments.end(),
+                       [](const AbstractCompositeSetPtr_t &assignment) { return assignment->is_empty(); });
+}
+
+std::string *DenseSimpleEvent::non_empty_to_string() {
+    return to_simple_event()->non_empty_to_string();
+}
+
+bool DenseSimpleEvent::operator==(const AbstractSimpleSet &other) {
+    const auto &rhs = static_cast<const DenseSimpleEvent &>(other);
+    const std::size_t slots = std::max(assignments.size(), rhs.assignments.size());
+    for (std::size_t id = 0; id < slots; ++id) {
+        auto lhs_assignment = assignment(id);
+        auto rhs_assignment = rhs.assignment(id);
+        if (lhs_assignment != rhs_assignment && *lhs_assignment != *rhs_assignment) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DenseSimpleEvent::operator<(const AbstractSimpleSet &other) {
+    const auto &rhs = static_cast<const DenseSimpleEvent &>(other);
+    const std::size_t slots = std::max(assignments.size(), rhs.assignments.size());
+    for (std::size_t id = 0; id < slots; ++id) {
+        auto lhs_assignment = assignment(id);
+        auto rhs_assignment = rhs.assignment(id);
+        if (lhs_assignment == rhs_assignment) {
+            continue;
+        }
+        if (*lhs_assignment < *rhs_assignment) {
+            return true;
+        }
+        if (*rhs_assignment < *lhs_assignment) {
+            return false;
+        }
+    }
+    return false;
+}
+
+std::size_t DenseSimpleEvent::compute_hash() const {
+    std::size_t seed = 0;
+    for (std::size_t id = 0; id < assignments.size(); ++id) {
+        const auto domain = registry->variable(id)->get_domain();
+        if (assignments[id] == domain || *assignments[id] == *domain) {
+            continue;
+        }
+        seed = hash_combine(seed, hash_combine(hash_integer(id), assignments[id]->hash()));
+    }
+    return seed;
+}
+
+AbstractSimpleSetPtr_t DenseSimpleEvent::deep_copy() {
+    Assignments_t copied;
+    copied.reserve(assignments.size());
+    for (auto const &assignment : assignments) {
+        copied.push_back(assignment->deep_copy());
+    }
+    return make_shared_dense_simple_event(registry, std::move(copied));
+}
+
+AbstractSimpleSetPtr_t DenseSimpleEvent::shallow_copy() {
+    return make_shared_dense_simple_event(registry, assignments);
+}
+
+AbstractSimpleSetPtr_t DenseSimpleEvent::promote(const OperationArena &arena) {
+    bool changed = arena.owns(this);
+    Assignments_t promoted;
+    promoted.reserve(assignments.size());
+    for (auto const &assignment : assignments) {
+        promoted.push_back(assignment->promote(arena));
+        changed = changed || promoted.back() != assignment;
+    }
+    if (!changed) {
+        return shared_from_this();
+    }
+    return make_shared_dense_simple_event(registry, std::move(promoted));
+}
+
+namespace {
+    void account_registry(MemoryAccountant &accountant, const VariableRegistryPtr_t &registry, bool owned) {
+        bool registry_owned;
+        if (accountant.enter(registry, owned, registry_owned)) {
+            registry->account_memory(accountant, registry_owned);
+        }
+    }
+}
+
+void DenseSimpleEvent::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(DenseSimpleEvent) + assignments.capacity() * sizeof(AbstractCompositeSetPtr_t), owned);
+    account_registry(accountant, registry, owned);
+    for (auto const &assignment: assignments) {
+        bool assignment_owned;
+        if (accountant.enter(assignment, owned, assignment_owned)) {
+            assignment->account_memory(accountant, assignment_owned);
+        }
+    }
+}
+
+bool DenseSimpleEvent::bounding_box(BoundingBox_t &box) {
+    std::pair<double, double> range;
+    for (std::size_t id = 0; id < registry->size(); ++id) {
+        if (!assignment(id)->bounding_range(range)) {
+            return false;
+        }
+        box.push_back(range);
+    }
+    return true;
+}
+
+//
+// ===============================
+//  —— DenseEvent (composite of DenseSimpleEvent) ——
+// ===============================
+//
+
+DenseEvent::DenseEvent(const VariableRegistryPtr_t &registry_) {
+    registry = registry_;
+    simple_sets = make_shared_simple_set_set();
+}
+
+DenseEvent::DenseEvent(const VariableRegistryPtr_t &registry_, const SimpleSetSetPtr_t &dense_simple_events) {
+    registry = registry_;
+    simple_sets = dense_simple_events;
+}
+
+DenseEvent::DenseEvent(const VariableRegistryPtr_t &registry_, const Event &event) {
+    registry = registry_;
+    simple_sets = make_shared_simple_set_set();
+    for (auto const &simple_event : *event.simple_sets) {
+        simple_sets->insert(make_shared_dense_simple_event(registry, static_cast<const SimpleEvent &>(*simple_event)));
+    }
+}
+
+EventPtr_t DenseEvent::to_event() const {
+    auto result = make_shared_event();
+    for (auto const &simple_set : *simple_sets) {
+        result->simple_sets->insert(static_cast<DenseSimpleEvent *>(simple_set.get())->to_simple_event());
+    }
+    return result;
+}
+
+AbstractCompositeSetPtr_t DenseEvent::simplify() {
+    // pad every event to the full registry, such that all rows are aligned
+    AssignmentRows_t rows;
+    rows.reserve(simple_sets->size());
+    for (auto const &simple_set : *simple_sets) {
+        auto dense_simple_event = static_cast<DenseSimpleEvent *>(simple_set.get());
+        AssignmentRow_t row;
+        row.reserve(registry->size());
+        for (std::size_t id = 0; id < registry->size(); ++id) {
+            row.push_back(dense_simple_event->assignment(id));
+        }
+        rows.push_back(std::move(row));
+    }
+
+    simplify_by_signature(rows);
+
+    auto result = make_shared_simple_set_set();
+    for (auto &row : rows) {
+        result->insert(make_shared_dense_simple_event(registry, std::move(row)));
+    }
+    return make_shared_dense_event(registry, result);
+}
+
+AbstractCompositeSetPtr_t DenseEvent::make_new_empty() const {
+    RANDOM_EVENTS_COUNT(empty_allocations);
+    return make_shared_dense_event(registry);
+}
+
+void DenseEvent::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(DenseEvent), owned);
+    account_simple_sets(accountant, owned);
+    account_registry(accountant, registry, owned);
+}
@@ -0,0 +1,86 @@
+#include "event_builder.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+EventBuilder::EventBuilder(const std::size_t rows) : rows_(rows) {}
+
+void EventBuilder::insert_column(Column column) {
+    const auto position = std::lower_bound(columns_.begin(), columns_.end(), column,
+                                           [](const Column &lhs, const Column &rhs) {
+                                               return *lhs.variable < *rhs.variable;
+                                           });
+    if (position != columns_.end() && !(*column.variable < *position->variable)) {
+        throw std::invalid_argument("variable " + *column.variable->name + " already has a column");
+    }
+    columns_.insert(position, std::move(column));
+}
+
+void EventBuilder::add_interval_column(const AbstractVariablePtr_t &variable, const double *lowers,
+                                       const double *uppers, const std::uint8_t *left_closed,
+                                       const std::uint8_t *right_closed) {
+    if (dynamic_cast<Symbolic *>(variable.get())) {
+        throw std::invalid_argument("variable " + *variable->name + " is symbolic and needs a set column");
+    }
+    Column column;
+    column.variable = variable;
+    column.lowers = lowers;
+    column.uppers = uppers;
+    column.left_closed = left_closed;
+    column.right_closed = right_closed;
+    insert_column(std::move(column));
+}
+
+void EventBuilder::add_set_column(const AbstractVariablePtr_t &variable, const long long *indices) {
+    const auto symbolic = dynamic_cast<Symbolic *>(variable.get());
+    if (!symbolic) {
+        throw std::invalid_argument("variable " + *variable->name + " is not symbolic and needs interval columns");
+    }
+    Column column;
+    column.variable = variable;
+    column.indices = indices;
+    column.all_elements = symbolic->domain->all_elements;
+    insert_column(std::move(column));
+}
+
+AbstractCompositeSetPtr_t EventBuilder::assignment(const Column &column, const std::size_t row) const {
+    if (column.indices) {
+        const auto index = column.indices[row];
+        if (index < 0 || index >= static_cast<long long>(column.all_elements->size())) {
+            throw std::invalid_argument("element index " + std::to_string(index) + " of variable " +
+                                        *column.variable->name + " in row " + std::to_string(row) +
+                                        " is not in its universe");
+        }
+        return make_shared_set(make_shared_set_element(static_cast<int>(index), column.all_elements),
+                               column.all_elements);
+    }
+    const auto left = !column.left_closed || column.left_closed[row] ? BorderType::CLOSED : BorderType::OPEN;
+    const auto right = !column.right_closed || column.right_closed[row] ? BorderType::CLOSED : BorderType::OPEN;
+    auto simple_interval = SimpleInterval::make_shared(column.lowers[row], column.uppers[row], left, right);
+    if (simple_interval->is_empty()) {
+        return nullptr;
+    }
+    return Interval::make_shared(simple_interval);
+}
+
+EventPtr_t EventBuilder::build() const {
+    auto result = make_shared_event();
+    for (std::size_t row = 0; row < rows_; ++row) {
+        auto simple_event = make_shared_simple_event();
+        auto &variable_map = *simple_event->variable_map;
+        bool empty = false;
+        for (const auto &column: columns_) {
+            auto value = assignment(column, row);
+            if (!value) {
+                empty = true;
+                break;
+            }
+            // the columns are sorted, hence every hinted insert is O(1)
+            variable_map.emplace_hint(variable_map.end(), column.variable, std::move(value));
+        }
+        if (!empty && !columns_.empty()) {
+            result->simple_sets->insert(simple_event);
+        }
+    }
+    return result;
+}
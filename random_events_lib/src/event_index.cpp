@@ -0,0 +1,236 @@
+#include "event_index.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @return True if two pieces with packed borders (see FlatInterval) have a common value.
+     */
+    inline bool pieces_intersect(const double lower_a, const double upper_a, const std::uint8_t borders_a,
+                                 const double lower_b, const double upper_b, const std::uint8_t borders_b) {
+        const double lower = std::max(lower_a, lower_b);
+        const double upper = std::min(upper_a, upper_b);
+        if (lower < upper) {
+            return true;
+        }
+        if (lower > upper) {
+            return false;
+        }
+        // a single common value has to be closed on every side where it is a border
+        const bool closed_a = (lower_a < lower || (borders_a & LEFT_CLOSED_BIT)) &&
+                              (upper_a > upper || (borders_a & RIGHT_CLOSED_BIT));
+        const bool closed_b = (lower_b < lower || (borders_b & LEFT_CLOSED_BIT)) &&
+                              (upper_b > upper || (borders_b & RIGHT_CLOSED_BIT));
+        return closed_a && closed_b;
+    }
+}
+
+EventIndex::EventIndex(const Event &event) {
+    registry_ = make_shared_variable_registry(make_shared_variable_set(event.get_variables_from_simple_events()));
+    const auto simple_event_count = event.simple_sets->size();
+    simple_events_.reserve(simple_event_count);
+    for (const auto &simple_set: *event.simple_sets) {
+        simple_events_.push_back(std::static_pointer_cast<SimpleEvent>(simple_set));
+    }
+
+    non_empty_ = DynamicBitset(simple_event_count);
+    indices_.resize(registry_->size());
+    for (std::size_t id = 0; id < registry_->size(); ++id) {
+        auto &index = indices_[id];
+        index.unconstrained = DynamicBitset(simple_event_count);
+        if (const auto symbolic = dynamic_cast<Symbolic *>(registry_->variable(id).get())) {
+            index.is_symbolic = true;
+            index.elements.assign(symbolic->domain->all_elements->size(), DynamicBitset(simple_event_count));
+        }
+    }
+
+    for (std::size_t position = 0; position < simple_event_count; ++position) {
+        const auto &variable_map = *simple_events_[position]->variable_map;
+        bool empty = variable_map.empty();
+        auto assignment = variable_map.begin();
+        // the variable maps and the registry are both ordered by variable
+        for (std::size_t id = 0; id < registry_->size(); ++id) {
+            auto &index = indices_[id];
+            if (assignment == variable_map.end() || *registry_->variable(id) < *assignment->first) {
+                index.unconstrained.set(position);
+                continue;
+            }
+            const auto &variable = assignment->first;
+            const auto &value = assignment->second;
+            ++assignment;
+
+            if (const auto set = dynamic_cast<Set *>(value.get())) {
+                if (!index.is_symbolic) {
+                    throw std::invalid_argument("variable " + *variable->name + " is assigned a Set but not symbolic");
+                }
+                const auto bitset = set->to_bitset();
+                if (bitset.size() > index.elements.size()) {
+                    index.elements.resize(bitset.size(), DynamicBitset(simple_event_count));
+                }
+                bitset.for_each_set_bit([&index, position](const std::size_t element) {
+                    index.elements[element].set(position);
+                });
+                empty |= bitset.none();
+            } else if (const auto interval = dynamic_cast<Interval *>(value.get())) {
+                if (index.is_symbolic) {
+                    throw std::invalid_argument("variable " + *variable->name + " is symbolic but assigned an Interval");
+                }
+                const FlatInterval flat(*interval);
+                index.lowers.insert(index.lowers.end(), flat.lowers().begin(), flat.lowers().end());
+                index.uppers.insert(index.uppers.end(), flat.uppers().begin(), flat.uppers().end());
+                index.borders.insert(index.borders.end(), flat.borders().begin(), flat.borders().end());
+                index.owners.insert(index.owners.end(), flat.size(), static_cast<std::uint32_t>(position));
+                empty |= flat.is_empty();
+            } else {
+                throw std::invalid_argument("variable " + *variable->name +
+                                            " is neither assigned an Interval nor a Set");
+            }
+        }
+        if (!empty) {
+            non_empty_.set(position);
+        }
+    }
+
+    for (auto &index: indices_) {
+        if (!index.is_symbolic) {
+            build_tree(index);
+        }
+    }
+}
+
+void EventIndex::build_tree(VariableIndex &index) {
+    std::vector<std::size_t> order(index.lowers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&index](const std::size_t lhs, const std::size_t rhs) {
+        return index.lowers[lhs] < index.lowers[rhs];
+    });
+
+    auto permute = [&order](auto &values) {
+        auto permuted = values;
+        for (std::size_t position = 0; position < order.size(); ++position) {
+            permuted[position] = values[order[position]];
+        }
+        values = std::move(permuted);
+    };
+    permute(index.lowers);
+    permute(index.uppers);
+    permute(index.borders);
+    permute(index.owners);
+
+    index.max_uppers.resize(index.lowers.size());
+    build_max_uppers(index, 0, index.lowers.size());
+}
+
+double EventIndex::build_max_uppers(VariableIndex &index, const std::size_t begin, const std::size_t end) {
+    if (begin >= end) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    const auto mid = begin + (end - begin) / 2;
+    const auto left = build_max_uppers(index, begin, mid);
+    const auto right = build_max_uppers(index, mid + 1, end);
+    index.max_uppers[mid] = std::max({index.uppers[mid], left, right});
+    return index.max_uppers[mid];
+}
+
+void EventIndex::query_tree(const VariableIndex &index, const std::size_t begin, const std::size_t end,
+                            const double lower, const double upper, const std::uint8_t borders,
+                            DynamicBitset &result) {
+    if (begin >= end) {
+        return;
+    }
+    const auto mid = begin + (end - begin) / 2;
+    // no piece of this subtree reaches the query
+    if (index.max_uppers[mid] < lower) {
+        return;
+    }
+    query_tree(index, begin, mid, lower, upper, borders, result);
+    if (pieces_intersect(index.lowers[mid], index.uppers[mid], index.borders[mid], lower, upper, borders)) {
+        result.set(index.owners[mid]);
+    }
+    // the pieces of the right subtree start at or after this one
+    if (index.lowers[mid] > upper) {
+        return;
+    }
+    query_tree(index, mid + 1, end, lower, upper, borders, result);
+}
+
+DynamicBitset EventIndex::matching_assignment(const VariableIndex &index,
+                                              const AbstractCompositeSet &assignment) const {
+    auto result = index.unconstrained;
+    if (const auto set = dynamic_cast<const Set *>(&assignment)) {
+        if (!index.is_symbolic) {
+            throw std::invalid_argument("a Set can only be matched against a symbolic variable");
+        }
+        set->to_bitset().for_each_set_bit([&index, &result](const std::size_t element) {
+            if (element < index.elements.size()) {
+                result |= index.elements[element];
+            }
+        });
+    } else if (const auto interval = dynamic_cast<const Interval *>(&assignment)) {
+        if (index.is_symbolic) {
+            throw std::invalid_argument("an Interval can only be matched against a continuous or integer variable");
+        }
+        const FlatInterval flat(*interval);
+        for (std::size_t piece = 0; piece < flat.size(); ++piece) {
+            query_tree(index, 0, index.lowers.size(), flat.lowers()[piece], flat.uppers()[piece],
+                       flat.borders()[piece], result);
+        }
+    } else {
+        throw std::invalid_argument("the assignment is neither an Interval nor a Set");
+    }
+    return result;
+}
+
+DynamicBitset EventIndex::matching(const AbstractVariablePtr_t &variable, const long long element) const {
+    // no simple event assigns the variable, hence all are unconstrained in it
+    if (!registry_->contains(variable)) {
+        return DynamicBitset(size()).flip();
+    }
+    const auto &index = indices_[registry_->id_of(variable)];
+    if (!index.is_symbolic) {
+        throw std::invalid_argument("variable " + *variable->name + " is not symbolic");
+    }
+    auto result = index.unconstrained;
+    if (element >= 0 && static_cast<std::size_t>(element) < index.elements.size()) {
+        result |= index.elements[element];
+    }
+    return result;
+}
+
+DynamicBitset EventIndex::matching(const AbstractVariablePtr_t &variable, const Interval &range) const {
+    if (!registry_->contains(variable)) {
+        return DynamicBitset(size()).flip();
+    }
+    return matching_assignment(indices_[registry_->id_of(variable)], range);
+}
+
+DynamicBitset EventIndex::compatible(const SimpleEvent &partial_assignment) const {
+    auto result = non_empty_;
+    for (const auto &[variable, assignment]: *partial_assignment.variable_map) {
+        if (result.none()) {
+            break;
+        }
+        // an empty assignment is compatible with nothing, even where the simple events are unconstrained
+        if (assignment->is_empty()) {
+            return DynamicBitset(size());
+        }
+        if (!registry_->contains(variable)) {
+            continue;
+        }
+        result &= matching_assignment(indices_[registry_->id_of(variable)], *assignment);
+    }
+    return result;
+}
+
+EventPtr_t EventIndex::select(const DynamicBitset &simple_events) const {
+    auto result = make_shared_event();
+    // the simple events are numbered in the order of the set, hence every hinted insert is O(1)
+    simple_events.for_each_set_bit([this, &result](const std::size_t position) {
+        if (position < simple_events_.size()) {
+            result->simple_sets->emplace_hint(result->simple_sets->end(), simple_events_[position]);
+        }
+    });
+    return result;
+}
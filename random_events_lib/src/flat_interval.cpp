@@ -0,0 +1,453 @@
+#include "flat_interval.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+//
+// ===============================
+//  —— FlatInterval (struct of arrays) ——
+// ===============================
+//
+
+// Helper: A piece is empty if its bounds are inverted or if it is a point with at least one open border.
+static bool is_empty_piece(const double lower, const double upper, const std::uint8_t borders) {
+    return lower > upper or
+           (lower == upper and (borders & (LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT)) != (LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT));
+}
+
+FlatInterval::FlatInterval(std::vector<double> lowers, std::vector<double> uppers,
+                           std::vector<std::uint8_t> borders) {
+    const auto n = lowers.size();
+    if (uppers.size() != n || borders.size() != n) {
+        throw std::invalid_argument("lowers, uppers and borders must have the same length");
+    }
+
+    // Sort a permutation instead of the three arrays, so that each array is touched only once afterward.
+    // Pieces with equal lower bounds are ordered closed-left first, such that merge_back only has to widen.
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) {
+        if (lowers[a] != lowers[b]) {
+            return lowers[a] < lowers[b];
+        }
+        return (borders[a] & LEFT_CLOSED_BIT) > (borders[b] & LEFT_CLOSED_BIT);
+    });
+
+    lowers_.reserve(n);
+    uppers_.reserve(n);
+    borders_.reserve(n);
+    for (const auto index: order) {
+        merge_back(lowers[index], uppers[index], borders[index]);
+    }
+}
+
+FlatInterval::FlatInterval(const SimpleSetSet_t &simple_sets) {
+    // The simple sets are already sorted by their lower bound, hence a single merge sweep suffices.
+    lowers_.reserve(simple_sets.size());
+    uppers_.reserve(simple_sets.size());
+    borders_.reserve(simple_sets.size());
+    for (const auto &simple_set: simple_sets) {
+        const auto simple_interval = static_cast<SimpleInterval *>(simple_set.get());
+        merge_back(simple_interval->lower, simple_interval->upper,
+                   pack_borders(simple_interval->left, simple_interval->right));
+    }
+}
+
+FlatInterval::FlatInterval(const SimpleInterval &simple_interval) {
+    merge_back(simple_interval.lower, simple_interval.upper, pack_borders(simple_interval.left, simple_interval.right));
+}
+
+FlatInterval::FlatInterval(const Interval &interval) : FlatInterval(*interval.simple_sets) {
+}
+
+void FlatInterval::push_back(const double lower, const double upper, const std::uint8_t borders) {
+    lowers_.push_back(lower);
+    uppers_.push_back(upper);
+    borders_.push_back(borders);
+}
+
+void FlatInterval::merge_back(const double lower, const double upper, const std::uint8_t borders) {
+    if (is_empty_piece(lower, upper, borders)) {
+        return;
+    }
+
+    if (lowers_.empty()) {
+        push_back(lower, upper, borders);
+        return;
+    }
+
+    auto &last_lower = lowers_.back();
+    auto &last_upper = uppers_.back();
+    auto &last_borders = borders_.back();
+
+    // the new piece starts behind the last one or they only share a point that neither contains
+    if (lower > last_upper or
+        (lower == last_upper and !(last_borders & RIGHT_CLOSED_BIT) and !(borders & LEFT_CLOSED_BIT))) {
+        push_back(lower, upper, borders);
+        return;
+    }
+
+    // equal lower bounds: the merged piece is closed if one of them is
+    if (lower == last_lower) {
+        last_borders |= borders & LEFT_CLOSED_BIT;
+    }
+
+    // extend to the right if the new piece reaches further, otherwise it is swallowed
+    if (upper > last_upper) {
+        last_upper = upper;
+        last_borders = static_cast<std::uint8_t>((last_borders & LEFT_CLOSED_BIT) | (borders & RIGHT_CLOSED_BIT));
+    } else if (upper == last_upper) {
+        last_borders |= borders & RIGHT_CLOSED_BIT;
+    }
+}
+
+bool FlatInterval::contains(const double element) const {
+    // find the first piece that starts behind the element; only its predecessor can contain the element
+    const auto it = std::upper_bound(lowers_.begin(), lowers_.end(), element);
+    if (it == lowers_.begin()) {
+        return false;
+    }
+    const auto index = static_cast<std::size_t>(std::distance(lowers_.begin(), it)) - 1;
+    return simple_interval(index).contains(element);
+}
+
+//
+// ——— Batch membership kernels ———
+//
+// A value x is contained in a piece iff
+//      (x > lower or (x == lower and left closed)) and (x < upper or (x == upper and right closed)).
+// The kernels evaluate this branch free, with the closed flags expanded to all-ones / all-zeros lane masks.
+
+// Pieces up to this count are tested against all values one after another, above it binary search is cheaper.
+static constexpr std::size_t LINEAR_SCAN_MAX_PIECES = 8;
+
+static inline bool piece_contains(const double element, const double lower, const double upper,
+                                  const std::uint8_t borders) {
+    const bool left_ok = element > lower or (element == lower and (borders & LEFT_CLOSED_BIT));
+    const bool right_ok = element < upper or (element == upper and (borders & RIGHT_CLOSED_BIT));
+    return left_ok and right_ok;
+}
+
+#if defined(__AVX2__)
+
+static inline __m256d closed_lane_mask(const bool closed) {
+    return _mm256_castsi256_pd(_mm256_set1_epi64x(closed ? -1 : 0));
+}
+
+static inline __m256d piece_contains_4(const __m256d x, const __m256d lower, const __m256d upper,
+                                       const __m256d left_closed, const __m256d right_closed) {
+    const __m256d left_ok = _mm256_or_pd(_mm256_cmp_pd(x, lower, _CMP_GT_OQ),
+                                         _mm256_and_pd(_mm256_cmp_pd(x, lower, _CMP_EQ_OQ), left_closed));
+    const __m256d right_ok = _mm256_or_pd(_mm256_cmp_pd(x, upper, _CMP_LT_OQ),
+                                          _mm256_and_pd(_mm256_cmp_pd(x, upper, _CMP_EQ_OQ), right_closed));
+    return _mm256_and_pd(left_ok, right_ok);
+}
+
+#elif defined(__SSE2__)
+
+static inline __m128d closed_lane_mask(const bool closed) {
+    return _mm_castsi128_pd(_mm_set1_epi64x(closed ? -1 : 0));
+}
+
+static inline __m128d piece_contains_2(const __m128d x, const __m128d lower, const __m128d upper,
+                                       const __m128d left_closed, const __m128d right_closed) {
+    const __m128d left_ok = _mm_or_pd(_mm_cmpgt_pd(x, lower), _mm_and_pd(_mm_cmpeq_pd(x, lower), left_closed));
+    const __m128d right_ok = _mm_or_pd(_mm_cmplt_pd(x, upper), _mm_and_pd(_mm_cmpeq_pd(x, upper), right_closed));
+    return _mm_and_pd(left_ok, right_ok);
+}
+
+#endif
+
+// Helper: OR the membership of all values in one piece into the mask.
+static void scan_piece(const double *elements, const std::size_t count, std::uint8_t *mask, const double lower,
+                       const double upper, const std::uint8_t borders) {
+    std::size_t index = 0;
+#if defined(__AVX2__)
+    const __m256d lower_v = _mm256_set1_pd(lower);
+    const __m256d upper_v = _mm256_set1_pd(upper);
+    const __m256d left_closed = closed_lane_mask(borders & LEFT_CLOSED_BIT);
+    const __m256d right_closed = closed_lane_mask(borders & RIGHT_CLOSED_BIT);
+    for (; index + 4 <= count; index += 4) {
+        const __m256d x = _mm256_loadu_pd(elements + index);
+        const int bits = _mm256_movemask_pd(piece_contains_4(x, lower_v, upper_v, left_closed, right_closed));
+        mask[index] |= bits & 1;
+        mask[index + 1] |= (bits >> 1) & 1;
+        mask[index + 2] |= (bits >> 2) & 1;
+        mask[index + 3] |= (bits >> 3) & 1;
+    }
+#elif defined(__SSE2__)
+    const __m128d lower_v = _mm_set1_pd(lower);
+    const __m128d upper_v = _mm_set1_pd(upper);
+    const __m128d left_closed = closed_lane_mask(borders & LEFT_CLOSED_BIT);
+    const __m128d right_closed = closed_lane_mask(borders & RIGHT_CLOSED_BIT);
+    for (; index + 2 <= count; index += 2) {
+        const __m128d x = _mm_loadu_pd(elements + index);
+        const int bits = _mm_movemask_pd(piece_contains_2(x, lower_v, upper_v, left_closed, right_closed));
+        mask[index] |= bits & 1;
+        mask[index + 1] |= (bits >> 1) & 1;
+    }
+#endif
+    for (; index < count; ++index) {
+        mask[index] |= piece_contains(elements[index], lower, upper, borders);
+    }
+}
+
+// Helper: Branch free upper bound; returns the index of the piece that may contain the element or `size` if none.
+static inline std::size_t candidate_piece(const double *lowers, const std::size_t size, const double element) {
+    // find the number of lower bounds that are <= element
+    const double *base = lowers;
+    std::size_t length = size;
+    while (length > 1) {
+        const std::size_t half = length / 2;
+        base = (base[half] <= element) ? base + half : base;
+        length -= half;
+    }
+    const std::size_t not_greater = static_cast<std::size_t>(base - lowers) + (*base <= element);
+    return not_greater == 0 ? size : not_greater - 1;
+}
+
+void FlatInterval::contains(const double *elements, const std::size_t count, std::uint8_t *mask) const {
+    std::fill(mask, mask + count, 0);
+    if (is_empty()) {
+        return;
+    }
+
+    if (size() <= LINEAR_SCAN_MAX_PIECES) {
+        for (std::size_t piece = 0; piece < size(); ++piece) {
+            scan_piece(elements, count, mask, lowers_[piece], uppers_[piece], borders_[piece]);
+        }
+        return;
+    }
+
+    // Many pieces: locate the candidate piece of every value, then compare against its borders.
+    // Values left of the first piece are compared against an empty dummy piece.
+    const double *lowers = lowers_.data();
+    const std::size_t n = size();
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    auto load = [&](const std::size_t piece, double &lower, double &upper, std::uint8_t &borders) {
+        if (piece == n) {
+            lower = infinity;
+            upper = -infinity;
+            borders = 0;
+        } else {
+            lower = lowers_[piece];
+            upper = uppers_[piece];
+            borders = borders_[piece];
+        }
+    };
+
+    std::size_t index = 0;
+#if defined(__AVX2__)
+    for (; index + 4 <= count; index += 4) {
+        double lower[4], upper[4];
+        std::uint8_t borders[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            load(candidate_piece(lowers, n, elements[index + lane]), lower[lane], upper[lane], borders[lane]);
+        }
+        const __m256d left_closed = _mm256_castsi256_pd(_mm256_set_epi64x(
+                -(borders[3] & LEFT_CLOSED_BIT), -(borders[2] & LEFT_CLOSED_BIT),
+                -(borders[1] & LEFT_CLOSED_BIT), -(borders[0] & LEFT_CLOSED_BIT)));
+        const __m256d right_closed = _mm256_castsi256_pd(_mm256_set_epi64x(
+                -((borders[3] & RIGHT_CLOSED_BIT) >> 1), -((borders[2] & RIGHT_CLOSED_BIT) >> 1),
+                -((borders[1] & RIGHT_CLOSED_BIT) >> 1), -((borders[0] & RIGHT_CLOSED_BIT) >> 1)));
+        const int bits = _mm256_movemask_pd(piece_contains_4(_mm256_loadu_pd(elements + index),
+                                                             _mm256_loadu_pd(lower), _mm256_loadu_pd(upper),
+                                                             left_closed, right_closed));
+        mask[index] = bits & 1;
+        mask[index + 1] = (bits >> 1) & 1;
+        mask[index + 2] = (bits >> 2) & 1;
+        mask[index + 3] = (bits >> 3) & 1;
+    }
+#elif defined(__SSE2__)
+    for (; index + 2 <= count; index += 2) {
+        double lower[2], upper[2];
+        std::uint8_t borders[2];
+        for (int lane = 0; lane < 2; ++lane) {
+            load(candidate_piece(lowers, n, elements[index + lane]), lower[lane], upper[lane], borders[lane]);
+        }
+        const __m128d left_closed = _mm_castsi128_pd(_mm_set_epi64x(
+                -(borders[1] & LEFT_CLOSED_BIT), -(borders[0] & LEFT_CLOSED_BIT)));
+        const __m128d right_closed = _mm_castsi128_pd(_mm_set_epi64x(
+                -((borders[1] & RIGHT_CLOSED_BIT) >> 1), -((borders[0] & RIGHT_CLOSED_BIT) >> 1)));
+        const int bits = _mm_movemask_pd(piece_contains_2(_mm_loadu_pd(elements + index), _mm_loadu_pd(lower),
+                                                          _mm_loadu_pd(upper), left_closed, right_closed));
+        mask[index] = bits & 1;
+        mask[index + 1] = (bits >> 1) & 1;
+    }
+#endif
+    for (; index < count; ++index) {
+        double lower, upper;
+        std::uint8_t borders;
+        load(candidate_piece(lowers, n, elements[index]), lower, upper, borders);
+        mask[index] = piece_contains(elements[index], lower, upper, borders);
+    }
+}
+
+void FlatInterval::contains_bitmask(const double *elements, const std::size_t count, std::uint64_t *bits) const {
+    // evaluate blocks of 64 values into a byte mask on the stack and pack each block into one word
+    std::uint8_t block[64];
+    for (std::size_t offset = 0; offset < count; offset += 64) {
+        const std::size_t length = std::min<std::size_t>(64, count - offset);
+        contains(elements + offset, length, block);
+        std::uint64_t word = 0;
+        for (std::size_t index = 0; index < length; ++index) {
+            word |= static_cast<std::uint64_t>(block[index]) << index;
+        }
+        bits[offset / 64] = word;
+    }
+}
+
+FlatInterval FlatInterval::union_with(const FlatInterval &other) const {
+    // Merge both sorted piece lists by lower bound (closed left borders first on ties) and coalesce on the fly.
+    FlatInterval result;
+    result.lowers_.reserve(size() + other.size());
+    result.uppers_.reserve(size() + other.size());
+    result.borders_.reserve(size() + other.size());
+
+    std::size_t i = 0, j = 0;
+    while (i < size() or j < other.size()) {
+        bool take_this;
+        if (j == other.size()) {
+            take_this = true;
+        } else if (i == size()) {
+            take_this = false;
+        } else if (lowers_[i] != other.lowers_[j]) {
+            take_this = lowers_[i] < other.lowers_[j];
+        } else {
+            take_this = (borders_[i] & LEFT_CLOSED_BIT) >= (other.borders_[j] & LEFT_CLOSED_BIT);
+        }
+
+        if (take_this) {
+            result.merge_back(lowers_[i], uppers_[i], borders_[i]);
+            ++i;
+        } else {
+            result.merge_back(other.lowers_[j], other.uppers_[j], other.borders_[j]);
+            ++j;
+        }
+    }
+    return result;
+}
+
+FlatInterval FlatInterval::intersection_with(const FlatInterval &other) const {
+    // Both operands are disjoint and sorted, so every pair of overlapping pieces is visited by a two pointer sweep.
+    FlatInterval result;
+    std::size_t i = 0, j = 0;
+    while (i < size() and j < other.size()) {
+        const double new_lower = std::max(lowers_[i], other.lowers_[j]);
+        const double new_upper = std::min(uppers_[i], other.uppers_[j]);
+
+        // the border of the piece that defines a bound wins, on equal bounds both have to be closed
+        std::uint8_t new_left;
+        if (lowers_[i] == other.lowers_[j]) {
+            new_left = borders_[i] & other.borders_[j] & LEFT_CLOSED_BIT;
+        } else {
+            new_left = (lowers_[i] > other.lowers_[j] ? borders_[i] : other.borders_[j]) & LEFT_CLOSED_BIT;
+        }
+        std::uint8_t new_right;
+        if (uppers_[i] == other.uppers_[j]) {
+            new_right = borders_[i] & other.borders_[j] & RIGHT_CLOSED_BIT;
+        } else {
+            new_right = (uppers_[i] < other.uppers_[j] ? borders_[i] : other.borders_[j]) & RIGHT_CLOSED_BIT;
+        }
+
+        // merge_back drops empty intersections
+        result.merge_back(new_lower, new_upper, new_left | new_right);
+
+        // advance the piece that ends first; the next piece of the other operand cannot overlap it anymore
+        if (uppers_[i] < other.uppers_[j]) {
+            ++i;
+        } else if (other.uppers_[j] < uppers_[i]) {
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+FlatInterval FlatInterval::difference_with(const FlatInterval &other) const {
+    // A \ B = A ∩ B^c, both steps are linear sweeps.
+    return intersection_with(other.complement());
+}
+
+FlatInterval FlatInterval::complement() const {
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    FlatInterval result;
+
+    if (is_empty()) {
+        result.push_back(-infinity, infinity, 0);
+        return result;
+    }
+
+    result.lowers_.reserve(size() + 1);
+    result.uppers_.reserve(size() + 1);
+    result.borders_.reserve(size() + 1);
+
+    // everything left of the first piece
+    if (lowers_.front() > -infinity) {
+        result.merge_back(-infinity, lowers_.front(), (borders_.front() & LEFT_CLOSED_BIT) ? 0 : RIGHT_CLOSED_BIT);
+    }
+
+    // the gaps between consecutive pieces with inverted borders; a gap may be a single point
+    for (std::size_t index = 0; index + 1 < size(); ++index) {
+        const std::uint8_t gap_left = (borders_[index] & RIGHT_CLOSED_BIT) ? 0 : LEFT_CLOSED_BIT;
+        const std::uint8_t gap_right = (borders_[index + 1] & LEFT_CLOSED_BIT) ? 0 : RIGHT_CLOSED_BIT;
+        result.merge_back(uppers_[index], lowers_[index + 1], gap_left | gap_right);
+    }
+
+    // everything right of the last piece
+    if (uppers_.back() < infinity) {
+        result.merge_back(uppers_.back(), infinity, (borders_.back() & RIGHT_CLOSED_BIT) ? 0 : LEFT_CLOSED_BIT);
+    }
+    return result;
+}
+
+IntervalPtr_t FlatInterval::to_interval() const {
+    // The pieces are already sorted, so hinting the end makes every insert amortized constant.
+    auto result = make_shared_simple_set_set();
+    for (std::size_t index = 0; index < size(); ++index) {
+        result->insert(result->end(),
+                       SimpleInterval::make_shared(lowers_[index], uppers_[index], left(index), right(index)));
+    }
+    return Interval::make_shared(result);
+}
+
+bool FlatInterval::operator==(const FlatInterval &other) const {
+    return lowers_ == other.lowers_ and uppers_ == other.uppers_ and borders_ == other.borders_;
+}
+
+FlatInterval FlatInterval::single_piece(const double lower, const double upper, const std::uint8_t borders) {
+    FlatInterval result;
+    result.merge_back(lower, upper, borders);
+    return result;
+}
+
+FlatInterval FlatInterval::closed(const double lower, const double upper) {
+    return single_piece(lower, upper, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT);
+}
+
+FlatInterval FlatInterval::open(const double lower, const double upper) {
+    return single_piece(lower, upper, 0);
+}
+
+FlatInterval FlatInterval::closed_open(const double lower, const double upper) {
+    return single_piece(lower, upper, LEFT_CLOSED_BIT);
+}
+
+FlatInterval FlatInterval::open_closed(const double lower, const double upper) {
+    return single_piece(lower, upper, RIGHT_CLOSED_BIT);
+}
+
+FlatInterval FlatInterval::singleton(const double value) {
+    return single_piece(value, value, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT);
+}
+
+FlatInterval FlatInterval::reals() {
+    return single_piece(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 0);
+}
@@ -0,0 +1,181 @@
+#include "intern_table.h"
+#include "dense_product_algebra.h"
+#include "product_algebra.h"
+#include <algorithm>
+#include <typeinfo>
+
+namespace {
+
+    /**
+     * Find the live entry that is equal to a value and erase released entries on the way.
+     */
+    template<typename T, typename Entries>
+    std::shared_ptr<T> find_equal(Entries &entries, std::size_t hash, T &value) {
+        auto [it, end] = entries.equal_range(hash);
+        while (it != end) {
+            auto candidate = it->second.lock();
+            if (!candidate) {
+                it = entries.erase(it);
+                continue;
+            }
+            if (typeid(*candidate) == typeid(value) && *candidate == value) {
+                return candidate;
+            }
+            ++it;
+        }
+        return nullptr;
+    }
+
+    template<typename Shards>
+    std::size_t purge_shards(Shards &shards) {
+        std::size_t removed = 0;
+        for (auto &shard: shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto it = shard->entries.begin(); it != shard->entries.end();) {
+                if (it->second.expired()) {
+                    it = shard->entries.erase(it);
+                    ++removed;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return removed;
+    }
+}
+
+//
+// ===============================
+//  —— InternTable ——
+// ===============================
+//
+
+InternTable::InternTable(std::size_t shard_count) {
+    shard_count = std::max<std::size_t>(shard_count, 1);
+    simple_shards_.reserve(shard_count);
+    composite_shards_.reserve(shard_count);
+    for (std::size_t index = 0; index < shard_count; ++index) {
+        simple_shards_.push_back(std::make_unique<Shard<AbstractSimpleSet>>());
+        composite_shards_.push_back(std::make_unique<Shard<AbstractCompositeSet>>());
+    }
+}
+
+AbstractSimpleSetPtr_t InternTable::intern(const AbstractSimpleSetPtr_t &simple_set) {
+    if (!simple_set) {
+        return simple_set;
+    }
+    const auto hash = simple_set->hash();
+    auto &shard = *simple_shards_[hash % simple_shards_.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (auto found = find_equal(shard.entries, hash, *simple_set)) {
+            ++hits_;
+            return found;
+        }
+    }
+
+    // built without holding the lock, since interning the parts locks other shards
+    auto canonical = make_canonical(simple_set);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (auto found = find_equal(shard.entries, hash, *simple_set)) {
+        ++hits_;
+        return found;
+    }
+    shard.entries.emplace(hash, canonical);
+    ++misses_;
+    return canonical;
+}
+
+AbstractCompositeSetPtr_t InternTable::intern(const AbstractCompositeSetPtr_t &composite_set) {
+    if (!composite_set) {
+        return composite_set;
+    }
+    const auto hash = composite_set->hash();
+    auto &shard = *composite_shards_[hash % composite_shards_.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (auto found = find_equal(shard.entries, hash, *composite_set)) {
+            ++hits_;
+            return found;
+        }
+    }
+
+    auto canonical = make_canonical(composite_set);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (auto found = find_equal(shard.entries, hash, *composite_set)) {
+        ++hits_;
+        return found;
+    }
+    shard.entries.emplace(hash, canonical);
+    ++misses_;
+    return canonical;
+}
+
+AbstractSimpleSetPtr_t InternTable::make_canonical(const AbstractSimpleSetPtr_t &simple_set) {
+    ArenaSuspension suspension;
+
+    AbstractSimpleSetPtr_t result;
+    if (auto simple_event = dynamic_cast<SimpleEvent *>(simple_set.get())) {
+        auto canonical = make_shared_simple_event();
+        for (auto const &kv: *simple_event->variable_map) {
+            canonical->variable_map->emplace_hint(canonical->variable_map->end(), kv.first, intern(kv.second));
+        }
+        result = canonical;
+    } else if (auto dense_simple_event = dynamic_cast<DenseSimpleEvent *>(simple_set.get())) {
+        Assignments_t assignments;
+        assignments.reserve(dense_simple_event->assignments.size());
+        for (auto const &assignment: dense_simple_event->assignments) {
+            assignments.push_back(intern(assignment));
+        }
+        result = make_shared_dense_simple_event(dense_simple_event->registry, std::move(assignments));
+    } else {
+        result = simple_set->deep_copy();
+    }
+    result->freeze();
+    return result;
+}
+
+AbstractCompositeSetPtr_t InternTable::make_canonical(const AbstractCompositeSetPtr_t &composite_set) {
+    ArenaSuspension suspension;
+    auto result = composite_set->make_new_empty();
+    for (auto const &simple_set: *composite_set->simple_sets) {
+        result->simple_sets->emplace_hint(result->simple_sets->end(), intern(simple_set));
+    }
+    result->freeze();
+    return result;
+}
+
+std::size_t InternTable::size() const {
+    std::size_t result = 0;
+    for (auto const &shard: simple_shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        result += shard->entries.size();
+    }
+    for (auto const &shard: composite_shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        result += shard->entries.size();
+    }
+    return result;
+}
+
+std::size_t InternTable::purge() {
+    return purge_shards(simple_shards_) + purge_shards(composite_shards_);
+}
+
+void InternTable::clear() {
+    for (auto &shard: simple_shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->entries.clear();
+    }
+    for (auto &shard: composite_shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->entries.clear();
+    }
+}
+
+InternTable &InternTable::global() {
+    static InternTable table;
+    return table;
+}
@@ -0,0 +1,84 @@
+#include "interval.h"
+#include "flat_interval.h"
+
+//
+// ===============================
+//  —— Interval (composite of SimpleInterval) ——
+// ===============================
+//
+
+AbstractCompositeSetPtr_t Interval::simplify() {
+    // One linear merge sweep over contiguous arrays, then a single conversion back to shared simple intervals.
+    return FlatInterval(*simple_sets).to_interval();
+}
+
+// Helper: Flatten the simple interval behind an abstract pointer.
+static FlatInterval flatten(const AbstractSimpleSetPtr_t &simple_set) {
+    return FlatInterval(*static_cast<SimpleInterval *>(simple_set.get()));
+}
+
+AbstractCompositeSetPtr_t Interval::intersection_with(const AbstractSimpleSetPtr_t &simple_set) {
+    return FlatInterval(*simple_sets).intersection_with(flatten(simple_set)).to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::intersection_with(const SimpleSetSetPtr_t &other) {
+    return FlatInterval(*simple_sets).intersection_with(FlatInterval(*other)).to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::intersection_with_impl(const AbstractCompositeSetPtr_t &other) {
+    return intersection_with(other->simple_sets);
+}
+
+void Interval::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(Interval), owned);
+    account_simple_sets(accountant, owned);
+}
+
+AbstractCompositeSetPtr_t Interval::complement_impl() const {
+    return FlatInterval(*simple_sets).complement().to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::union_with(const AbstractSimpleSetPtr_t &other) {
+    return FlatInterval(*simple_sets).union_with(flatten(other)).to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::union_with_impl(const AbstractCompositeSetPtr_t &other) {
+    return FlatInterval(*simple_sets).union_with(FlatInterval(*other->simple_sets)).to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::difference_with(const AbstractSimpleSetPtr_t &other) {
+    return FlatInterval(*simple_sets).difference_with(flatten(other)).to_interval();
+}
+
+AbstractCompositeSetPtr_t Interval::difference_with(const AbstractCompositeSetPtr_t &other) {
+    return FlatInterval(*simple_sets).difference_with(FlatInterval(*other->simple_sets)).to_interval();
+}
+
+void Interval::contains(const double *elements, const std::size_t count, std::uint8_t *mask) const {
+    // flatten once, then every value costs a binary search at most
+    FlatInterval(*simple_sets).contains(elements, count, mask);
+}
+
+IntervalPtr_t Interval::from_arrays(const double *lowers, const double *uppers, const std::uint8_t *left_closed,
+                                    const std::uint8_t *right_closed, const std::size_t count) {
+    std::vector<std::uint8_t> borders(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        borders[index] = static_cast<std::uint8_t>((left_closed[index] ? LEFT_CLOSED_BIT : 0) |
+                                                   (right_closed[index] ? RIGHT_CLOSED_BIT : 0));
+    }
+    return FlatInterval(std::vector<double>(lowers, lowers + count), std::vector<double>(uppers, uppers + count),
+                        std::move(borders)).to_interval();
+}
+
+void Interval::to_arrays(double *lowers, double *uppers, std::uint8_t *left_closed,
+                         std::uint8_t *right_closed) const {
+    std::size_t index = 0;
+    for (const auto &simple_set: *simple_sets) {
+        const auto simple_interval = static_cast<SimpleInterval *>(simple_set.get());
+        lowers[index] = simple_interval->lower;
+        uppers[index] = simple_interval->upper;
+        left_closed[index] = simple_interval->left == BorderType::CLOSED;
+        right_closed[index] = simple_interval->right == BorderType::CLOSED;
+        ++index;
+    }
+}
@@ -0,0 +1,153 @@
+#include "operation_cache.h"
+#include <typeinfo>
+#include <vector>
+
+//
+// ===============================
+//  —— OperationCache ——
+// ===============================
+//
+
+OperationCache::OperationCache(std::size_t capacity) : capacity_(capacity) {
+    statistics_.capacity = capacity;
+}
+
+void OperationCache::set_capacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    statistics_.capacity = capacity;
+    evict(simple_level_, capacity);
+    evict(composite_level_, capacity);
+}
+
+template<typename Operand, typename Queried>
+std::shared_ptr<void> OperationCache::find_in(Level<Operand> &level, SetOperation operation, std::size_t hash,
+                                              Queried &lhs, Queried *rhs) {
+    // copy the candidates, such that the (possibly expensive) comparisons run without the lock
+    std::vector<Entry<Operand>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, end] = level.index.equal_range(hash);
+        for (; it != end; ++it) {
+            if (it->second->operation == operation) {
+                candidates.push_back(*it->second);
+            }
+        }
+    }
+
+    for (auto const &entry : candidates) {
+        if (entry.lhs.get() != &lhs && (typeid(*entry.lhs) != typeid(lhs) || !(*entry.lhs == lhs))) {
+            continue;
+        }
+        if (rhs && entry.rhs.get() != rhs && (typeid(*entry.rhs) != typeid(*rhs) || !(*entry.rhs == *rhs))) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        touch(level, hash, entry.id);
+        ++statistics_.hits;
+        return entry.result;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.misses;
+    return nullptr;
+}
+
+template<typename Operand>
+void OperationCache::touch(Level<Operand> &level, std::size_t hash, std::uint64_t id) {
+    auto [it, end] = level.index.equal_range(hash);
+    for (; it != end; ++it) {
+        if (it->second->id == id) {
+            level.entries.splice(level.entries.begin(), level.entries, it->second);
+            return;
+        }
+    }
+}
+
+template<typename Operand>
+void OperationCache::insert_into(Level<Operand> &level, Entry<Operand> entry) {
+    const auto hash = entry.hash;
+    level.entries.push_front(std::move(entry));
+    level.index.emplace(hash, level.entries.begin());
+    evict(level, capacity_);
+}
+
+template<typename Operand>
+void OperationCache::evict(Level<Operand> &level, std::size_t capacity) {
+    while (level.entries.size() > capacity) {
+        auto last = std::prev(level.entries.end());
+        auto [it, end] = level.index.equal_range(last->hash);
+        for (; it != end; ++it) {
+            if (it->second == last) {
+                level.index.erase(it);
+                break;
+            }
+        }
+        level.entries.erase(last);
+        ++statistics_.evictions;
+    }
+}
+
+std::shared_ptr<void> OperationCache::find(SetOperation operation, std::size_t hash, AbstractSimpleSet &lhs,
+                                           AbstractSimpleSet *rhs) {
+    return find_in(simple_level_, operation, hash, lhs, rhs);
+}
+
+std::shared_ptr<void> OperationCache::find(SetOperation operation, std::size_t hash, const AbstractCompositeSet &lhs,
+                                           const AbstractCompositeSet *rhs) {
+    return find_in(composite_level_, operation, hash, lhs, rhs);
+}
+
+void OperationCache::insert(SetOperation operation, std::size_t hash, AbstractSimpleSetPtr_t lhs,
+                            AbstractSimpleSetPtr_t rhs, std::shared_ptr<void> result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+    insert_into(simple_level_, Entry<AbstractSimpleSet>{next_id_++, operation, hash, std::move(lhs), std::move(rhs),
+                                                        std::move(result)});
+}
+
+void OperationCache::insert(SetOperation operation, std::size_t hash, AbstractCompositeSetPtr_t lhs,
+                            AbstractCompositeSetPtr_t rhs, std::shared_ptr<void> result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+    insert_into(composite_level_, Entry<AbstractCompositeSet>{next_id_++, operation, hash, std::move(lhs),
+                                                              std::move(rhs), std::move(result)});
+}
+
+void OperationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    simple_level_.entries.clear();
+    simple_level_.index.clear();
+    composite_level_.entries.clear();
+    composite_level_.index.clear();
+    statistics_ = OperationCacheStatistics();
+    statistics_.capacity = capacity_;
+}
+
+OperationCacheStatistics OperationCache::statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto result = statistics_;
+    result.size = simple_level_.entries.size() + composite_level_.entries.size();
+    return result;
+}
+
+OperationCache &OperationCache::global() {
+    static OperationCache cache;
+    return cache;
+}
+
+void set_operation_cache_capacity(std::size_t capacity) {
+    OperationCache::global().set_capacity(capacity);
+}
+
+OperationCacheStatistics get_operation_cache_statistics() {
+    return OperationCache::global().statistics();
+}
+
+void clear_operation_cache() {
+    OperationCache::global().clear();
+}
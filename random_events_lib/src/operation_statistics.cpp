@@ -0,0 +1,72 @@
+#include "operation_statistics.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    /**
+     * The counters of all live threads and the totals of finished threads.
+     */
+    struct CounterRegistry {
+        std::mutex mutex;
+        std::vector<ThreadOperationCounters *> live;
+        OperationStatistics finished;
+    };
+
+    CounterRegistry &registry() {
+        // never destroyed, such that threads that finish during static destruction can still unregister
+        static auto *registry = new CounterRegistry();
+        return *registry;
+    }
+}
+
+ThreadOperationCounters::ThreadOperationCounters() {
+    auto &counters = registry();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    counters.live.push_back(this);
+}
+
+ThreadOperationCounters::~ThreadOperationCounters() {
+    auto &counters = registry();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    add_to(counters.finished);
+    counters.live.erase(std::remove(counters.live.begin(), counters.live.end(), this), counters.live.end());
+}
+
+void ThreadOperationCounters::add_to(OperationStatistics &statistics) const {
+    statistics.simple_intersections += simple_intersections.get();
+    statistics.simple_complements += simple_complements.get();
+    statistics.empty_allocations += empty_allocations.get();
+    statistics.split_rounds += split_rounds.get();
+    statistics.simplify_passes += simplify_passes.get();
+    statistics.peak_simple_sets = std::max(statistics.peak_simple_sets, peak_simple_sets.get());
+}
+
+void ThreadOperationCounters::reset() {
+    simple_intersections.reset();
+    simple_complements.reset();
+    empty_allocations.reset();
+    split_rounds.reset();
+    simplify_passes.reset();
+    peak_simple_sets.reset();
+}
+
+OperationStatistics get_operation_statistics() {
+    auto &counters = registry();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    auto result = counters.finished;
+    for (auto const *thread_counters: counters.live) {
+        thread_counters->add_to(result);
+    }
+    return result;
+}
+
+void reset_operation_statistics() {
+    auto &counters = registry();
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    counters.finished = OperationStatistics();
+    for (auto *thread_counters: counters.live) {
+        thread_counters->reset();
+    }
+}
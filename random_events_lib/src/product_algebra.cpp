@@ -1,8 +1,14 @@
+#include <algorithm>
 #include <stdexcept>
 #include <iterator>
 #include <vector>
 #include <sstream>
 #include "product_algebra.h"
+#include "flat_interval.h"
+#include "signature_simplification.h"
+#include "thread_pool.h"
+#include "tracing.h"
+#include "variable_registry.h"
 
 //
 // ===============================
@@ -24,7 +30,7 @@ map_keys_to_vector(const VariableMapPtr_t &varmap) {
 }
 
 
-AbstractSimpleSetPtr_t SimpleEvent::intersection_with(const AbstractSimpleSetPtr_t &other) {
+AbstractSimpleSetPtr_t SimpleEvent::intersection_with_impl(const AbstractSimpleSetPtr_t &other) {
     // We want to build: ∀ v in (vars_self ∪ vars_other), the appropriate assignment intersection.
     //
     // 1) Extract maps and keys
@@ -90,6 +96,7 @@ void SimpleEvent::fill_missing_variables(const VariableSetPtr_t &variables) cons
     // We expect 'variables' is a sorted std::set, so iterating is O(|variables|)
     for (auto const &var : *variables) {
         if (variable_map->find(var) == variable_map->end()) {
+            check_mutable();
             variable_map->insert({var, var->get_domain()});
         }
     }
@@ -145,7 +152,7 @@ SimpleEvent::SimpleEvent(VariableMapPtr_t &variable_map_ptr) {
     variable_map = variable_map_ptr;
 }
 
-SimpleSetSetPtr_t SimpleEvent::complement() {
+SimpleSetSetPtr_t SimpleEvent::complement_impl() {
     // We want to generate, for each variable key v_i, a new SimpleEvent in which:
     //   - v_i is assigned 'assignment->complement()'
     //   - every variable processed earlier is assigned value from this->variable_map
@@ -158,6 +165,7 @@ SimpleSetSetPtr_t SimpleEvent::complement() {
     //   4) Append to result only if non‐empty
     //
     // This eliminates repeated calls to get_variables() inside the loop.
+    TraceSpan span("SimpleEvent::complement", 1);
 
     auto result = make_shared_simple_set_set();
 
@@ -193,6 +201,7 @@ SimpleSetSetPtr_t SimpleEvent::complement() {
         }
     }
 
+    span.set_output(result->size());
     return result;
 }
 
@@ -273,6 +282,9 @@ std::string *SimpleEvent::non_empty_to_string() {
 bool SimpleEvent::operator==(const AbstractSimpleSet &other) {
     // Compare two SimpleEvents for equality of variable_map
     const auto &rhs = static_cast<const SimpleEvent &>(other);
+    if (this == &rhs || variable_map == rhs.variable_map) {
+        return true;
+    }
 
     // 1) Quick size check
     if (variable_map->size() != rhs.variable_map->size()) {
@@ -286,8 +298,8 @@ bool SimpleEvent::operator==(const AbstractSimpleSet &other) {
         if (*(it1->first) != *(it2->first)) {
             return false; // different variable pointer or name
         }
-        // Compare the composite assignments
-        if (!(*(it1->second) == *(it2->second))) {
+        // Compare the composite assignments, interned assignments are identical
+        if (it1->second != it2->second && !(*(it1->second) == *(it2->second))) {
             return false;
         }
         ++it1; ++it2;
@@ -295,6 +307,74 @@ bool SimpleEvent::operator==(const AbstractSimpleSet &other) {
     return true;
 }
 
+std::size_t SimpleEvent::compute_hash() const {
+    return VariableMapHash{}(*variable_map);
+}
+
+AbstractSimpleSetPtr_t SimpleEvent::deep_copy() {
+    auto result = make_shared_simple_event();
+    for (auto const &kv : *variable_map) {
+        result->variable_map->emplace_hint(result->variable_map->end(), kv.first, kv.second->deep_copy());
+    }
+    return result;
+}
+
+AbstractSimpleSetPtr_t SimpleEvent::shallow_copy() {
+    auto result = make_shared_simple_event();
+    result->variable_map->insert(variable_map->begin(), variable_map->end());
+    return result;
+}
+
+AbstractSimpleSetPtr_t SimpleEvent::promote(const OperationArena &arena) {
+    SimpleEventPtr_t result;
+    if (arena.owns(this) || arena.owns(variable_map.get())) {
+        result = make_shared_simple_event();
+    }
+    for (auto it = variable_map->begin(); it != variable_map->end(); ++it) {
+        auto assignment = it->second->promote(arena);
+        if (!result && assignment != it->second) {
+            // the assignments before are shared
+            result = make_shared_simple_event();
+            result->variable_map->insert(variable_map->begin(), it);
+        }
+        if (result) {
+            result->variable_map->emplace_hint(result->variable_map->end(), it->first, std::move(assignment));
+        }
+    }
+    if (!result) {
+        return shared_from_this();
+    }
+    return result;
+}
+
+void SimpleEvent::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(SimpleEvent), owned);
+    bool map_owned;
+    if (!accountant.enter(variable_map, owned, map_owned)) {
+        return;
+    }
+    accountant.add(sizeof(VariableMap) + variable_map->size() * (TREE_NODE_BYTES + sizeof(VariableMap::value_type)),
+                   map_owned);
+    for (auto const &[variable, assignment]: *variable_map) {
+        account_variable(accountant, variable, map_owned);
+        bool assignment_owned;
+        if (accountant.enter(assignment, map_owned, assignment_owned)) {
+            assignment->account_memory(accountant, assignment_owned);
+        }
+    }
+}
+
+bool SimpleEvent::bounding_box(BoundingBox_t &box) {
+    std::pair<double, double> range;
+    for (auto const &kv : *variable_map) {
+        if (!kv.second->bounding_range(range)) {
+            return false;
+        }
+        box.push_back(range);
+    }
+    return true;
+}
+
 bool SimpleEvent::operator<(const AbstractSimpleSet &other) {
     // Lexicographical compare on (var → assignment) maps
     const auto &rhs = static_cast<const SimpleEvent &>(other);
@@ -331,7 +411,7 @@ bool SimpleEvent::operator<(const AbstractSimpleSet &other) {
 }
 
 SimpleEvent::SimpleEvent(const VariableSetPtr_t &variables) {
-    variable_map = std::make_shared<VariableMap>();
+    variable_map = make_shared_in_scope<VariableMap>();
     // Build the entire map in one go
     for (auto const &var : *variables) {
         variable_map->insert({var, var->get_domain()});
@@ -339,7 +419,7 @@ SimpleEvent::SimpleEvent(const VariableSetPtr_t &variables) {
 }
 
 SimpleEvent::SimpleEvent() {
-    variable_map = std::make_shared<VariableMap>();
+    variable_map = make_shared_in_scope<VariableMap>();
 }
 
 AbstractSimpleSetPtr_t SimpleEvent::marginal(const VariableSetPtr_t &variables) const {
@@ -379,14 +459,38 @@ Event::Event(const SimpleEventPtr_t &simple_event) {
     fill_missing_variables();
 }
 
-void Event::fill_missing_variables(const VariableSetPtr_t &variable_set) const {
-    // For each SimpleEvent in this composite, call its fill_missing_variables
-    for (auto const &simple_event : *simple_sets) {
-        auto casted = static_cast<SimpleEvent *>(simple_event.get());
-        casted->fill_missing_variables(variable_set);
+namespace {
+    /**
+     * Fill the missing variables of the simple events of an event in place, except for frozen simple events that
+     * miss a variable, which are replaced by filled copies.
+     */
+    void fill_simple_events(const Event &event, const VariableSetPtr_t &variables) {
+        std::vector<AbstractSimpleSetPtr_t> copies;
+        auto &simple_sets = *event.simple_sets;
+        for (auto it = simple_sets.begin(); it != simple_sets.end();) {
+            auto casted = static_cast<SimpleEvent *>(it->get());
+            auto assigned = [casted](auto const &variable) {
+                return casted->variable_map->find(variable) != casted->variable_map->end();
+            };
+            if (!casted->is_frozen() || std::all_of(variables->begin(), variables->end(), assigned)) {
+                casted->fill_missing_variables(variables);
+                ++it;
+                continue;
+            }
+            event.check_mutable();
+            auto copy = casted->shallow_copy();
+            static_cast<SimpleEvent *>(copy.get())->fill_missing_variables(variables);
+            copies.push_back(std::move(copy));
+            it = simple_sets.erase(it);
+        }
+        simple_sets.insert(copies.begin(), copies.end());
     }
 }
 
+void Event::fill_missing_variables(const VariableSetPtr_t &variable_set) const {
+    fill_simple_events(*this, variable_set);
+}
+
 void Event::fill_missing_variables() const {
     // 1) Gather all variables from each SimpleEvent in simple_sets, but avoid rebuilding a separate map for each Event.
     // We will collect them into a single VariableSet.
@@ -401,12 +505,9 @@ void Event::fill_missing_variables() const {
         }
     }
 
-    // 2) Now call the overload for every SimpleEvent
+    // 2) Now fill every SimpleEvent
     auto shared_vars = std::make_shared<VariableSet>(all_vars.begin(), all_vars.end());
-    for (auto const &simple_event_ptr : *simple_sets) {
-        auto casted = static_cast<SimpleEvent *>(simple_event_ptr.get());
-        casted->fill_missing_variables(shared_vars);
-    }
+    fill_simple_events(*this, shared_vars);
 }
 
 VariableSet Event::get_variables_from_simple_events() const {
@@ -425,6 +526,8 @@ VariableSet Event::get_variables_from_simple_events() const {
 }
 
 std::tuple<EventPtr_t, bool> Event::simplify_once() {
+    RANDOM_EVENTS_COUNT(simplify_passes);
+
     // We want to find any two SimpleEvents that differ in exactly one variable,
     // merge their assignments on that variable, and rebuild the composite.
     //
@@ -554,23 +657,220 @@ std::tuple<EventPtr_t, bool> Event::simplify_once() {
     }
 }
 
+// Helper: Check if two variable maps are defined over the same variables.
+static bool same_variables(const VariableMapPtr_t &lhs, const VariableMapPtr_t &rhs) {
+    return lhs == rhs ||
+           (lhs->size() == rhs->size() &&
+            std::equal(lhs->begin(), lhs->end(), rhs->begin(),
+                       [](const VariableMap::value_type &left, const VariableMap::value_type &right) {
+                           return *left.first == *right.first;
+                       }));
+}
+
+// Helper: Check if all simple events of a collection are defined over the variables of a variable map.
+static bool all_over_variables(const SimpleSetSet_t &simple_sets, const VariableMapPtr_t &variables) {
+    return std::all_of(simple_sets.begin(), simple_sets.end(), [&variables](const AbstractSimpleSetPtr_t &simple_set) {
+        return same_variables(static_cast<SimpleEvent *>(simple_set.get())->variable_map, variables);
+    });
+}
+
+bool Event::has_aligned_axes() const {
+    if (simple_sets->empty()) {
+        return true;
+    }
+    return all_over_variables(*simple_sets, static_cast<SimpleEvent *>(simple_sets->begin()->get())->variable_map);
+}
+
+bool Event::has_aligned_axes_with(const SimpleSetSetPtr_t &other) const {
+    const auto &reference = simple_sets->empty() ? *other : *simple_sets;
+    if (reference.empty()) {
+        return true;
+    }
+    const auto &variables = static_cast<SimpleEvent *>(reference.begin()->get())->variable_map;
+    return all_over_variables(*simple_sets, variables) && all_over_variables(*other, variables);
+}
+
 AbstractCompositeSetPtr_t Event::simplify() {
+    TraceSpan span("Event::simplify", simple_sets->size());
+
+    // The signature engine needs aligned rows, i.e. all simple events have to share their variables.
+    // Events where that is not the case keep the pairwise search, which also merges events over mismatching keys.
+    if (!simple_sets->empty() && has_aligned_axes()) {
+        auto variables = map_keys_to_vector(static_cast<SimpleEvent *>(simple_sets->begin()->get())->variable_map);
+        AssignmentRows_t rows;
+        rows.reserve(simple_sets->size());
+        for (auto const &simple_set : *simple_sets) {
+            AssignmentRow_t row;
+            row.reserve(variables.size());
+            for (auto const &kv : *static_cast<SimpleEvent *>(simple_set.get())->variable_map) {
+                row.push_back(kv.second);
+            }
+            rows.push_back(std::move(row));
+        }
+
+        simplify_by_signature(rows);
+
+        auto result = make_shared_event();
+        for (auto &row : rows) {
+            auto simple_event = make_shared_simple_event();
+            for (std::size_t index = 0; index < variables.size(); ++index) {
+                simple_event->variable_map->emplace_hint(simple_event->variable_map->end(), variables[index],
+                                                         std::move(row[index]));
+            }
+            result->simple_sets->insert(simple_event);
+        }
+        span.set_output(result->simple_sets->size());
+        return result;
+    }
+
     auto [current, changed] = simplify_once();
     while (changed) {
         auto [next, next_changed] = current->simplify_once();
         current = next;
         changed = next_changed;
     }
+    span.set_output(current->simple_sets->size());
     return current;
 }
 
 AbstractCompositeSetPtr_t Event::make_new_empty() const {
+    RANDOM_EVENTS_COUNT(empty_allocations);
     return make_shared_event();
 }
 
+namespace {
+    /**
+     * The assignment of one variable of a simple event, resolved to its column and a flat representation.
+     */
+    struct ColumnConstraint {
+        const PointColumn *column;
+        bool is_set;
+        FlatInterval interval;
+        DynamicBitset elements;
+    };
+
+    // Helper: Resolve the assignments of every simple event of an event against the columns.
+    std::vector<std::vector<ColumnConstraint>> column_constraints(const Event &event, const VariableRegistry &registry,
+                                                                  const PointColumn *columns) {
+        std::vector<std::vector<ColumnConstraint>> result;
+        result.reserve(event.simple_sets->size());
+        for (const auto &simple_set: *event.simple_sets) {
+            const auto &variable_map = *static_cast<SimpleEvent *>(simple_set.get())->variable_map;
+            // a simple event without variables is empty
+            if (variable_map.empty()) {
+                continue;
+            }
+            auto &constraints = result.emplace_back();
+            for (const auto &[variable, assignment]: variable_map) {
+                if (!registry.contains(variable)) {
+                    throw std::invalid_argument("variable " + *variable->name + " has no column");
+                }
+                const auto column = columns + registry.id_of(variable);
+                if (const auto set = dynamic_cast<Set *>(assignment.get())) {
+                    if (!column->indices) {
+                        throw std::invalid_argument("variable " + *variable->name + " needs a column of indices");
+                    }
+                    constraints.push_back({column, true, FlatInterval(), set->to_bitset()});
+                } else if (const auto interval = dynamic_cast<Interval *>(assignment.get())) {
+                    if (!column->values) {
+                        throw std::invalid_argument("variable " + *variable->name + " needs a column of values");
+                    }
+                    constraints.push_back({column, false, FlatInterval(*interval), DynamicBitset()});
+                } else {
+                    throw std::invalid_argument("variable " + *variable->name +
+                                                " is neither assigned an Interval nor a Set");
+                }
+            }
+        }
+        return result;
+    }
+
+    // Helper: Clear the bits of `alive` whose rows violate a constraint. Bit `j` of word `w` is row `first + 64w + j`.
+    // Returns true if any bit is still set.
+    bool filter_rows(const ColumnConstraint &constraint, const std::size_t first, const std::size_t rows,
+                     std::uint64_t *alive, const std::size_t words) {
+        bool any = false;
+        for (std::size_t word = 0; word < words; ++word) {
+            if (!alive[word]) {
+                continue;
+            }
+            const auto offset = first + word * 64;
+            if (constraint.is_set) {
+                std::uint64_t remaining = alive[word];
+                while (remaining) {
+                    const auto bit = lowest_bit64(remaining);
+                    remaining &= remaining - 1;
+                    const auto index = constraint.column->indices[offset + bit];
+                    if (index < 0 || static_cast<std::size_t>(index) >= constraint.elements.size() ||
+                        !constraint.elements.test(static_cast<std::size_t>(index))) {
+                        alive[word] &= ~(std::uint64_t{1} << bit);
+                    }
+                }
+            } else {
+                std::uint64_t bits;
+                constraint.interval.contains_bitmask(constraint.column->values + offset,
+                                                     std::min<std::size_t>(64, rows - word * 64), &bits);
+                alive[word] &= bits;
+            }
+            any |= alive[word] != 0;
+        }
+        return any;
+    }
+}
+
+void Event::contains(const VariableRegistry &registry, const PointColumn *columns, const std::size_t rows,
+                     std::uint8_t *mask) const {
+    TraceSpan span("Event::contains", simple_sets->size());
+    const auto constraints = column_constraints(*this, registry, columns);
+
+    const auto word_count = (rows + 63) / 64;
+    parallel_for(0, word_count, [&](const std::size_t begin, const std::size_t end) {
+        const auto first = begin * 64;
+        const auto chunk_rows = std::min(rows, end * 64) - first;
+        const auto words = end - begin;
+        std::vector<std::uint64_t> accepted(words, 0), alive(words);
+        const auto tail = chunk_rows % 64 ? (std::uint64_t{1} << (chunk_rows % 64)) - 1 : ~std::uint64_t{0};
+
+        std::size_t remaining = chunk_rows;
+        for (const auto &simple_event: constraints) {
+            if (remaining == 0) {
+                break;
+            }
+            for (std::size_t word = 0; word < words; ++word) {
+                alive[word] = ~accepted[word];
+            }
+            alive[words - 1] &= tail;
+
+            bool any = true;
+            for (const auto &constraint: simple_event) {
+                if (!(any = filter_rows(constraint, first, chunk_rows, alive.data(), words))) {
+                    break;
+                }
+            }
+            if (!any) {
+                continue;
+            }
+            for (std::size_t word = 0; word < words; ++word) {
+                accepted[word] |= alive[word];
+                remaining -= popcount64(alive[word]);
+            }
+        }
+
+        for (std::size_t row = 0; row < chunk_rows; ++row) {
+            mask[first + row] = (accepted[row / 64] >> (row % 64)) & 1;
+        }
+    }, EVENT_CONTAINS_GRAIN);
+}
+
+void Event::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(Event), owned);
+    account_simple_sets(accountant, owned);
+}
+
 AbstractCompositeSetPtr_t Event::marginal(const VariableSetPtr_t &variables) const {
     // Build { E_i.marginal(variables) : for each E_i in simple_sets }, then make_disjoint()
     // Instead of inserting one‐by‐one, we gather them first and do a single bulk‐insert.
+    TraceSpan span("Event::marginal", simple_sets->size());
 
     std::vector<AbstractSimpleSetPtr_t> scratch;
     scratch.reserve(simple_sets->size());
@@ -585,5 +885,7 @@ AbstractCompositeSetPtr_t Event::marginal(const VariableSetPtr_t &variables) con
     if (!scratch.empty()) {
         result->simple_sets->insert(scratch.begin(), scratch.end());
     }
-    return result->make_disjoint();
+    auto disjoint_result = result->make_disjoint();
+    span.set_output(disjoint_result->simple_sets->size());
+    return disjoint_result;
 }
@@ -22,6 +22,35 @@
 // ================================
 //
 
+namespace {
+    /**
+     * Two universes are the same if they are the same object or contain the same elements.
+     */
+    bool same_universe(const AllSetElementsPtr_t &lhs, const AllSetElementsPtr_t &rhs) {
+        if (lhs == rhs) {
+            return true;
+        }
+        return lhs != nullptr && rhs != nullptr && *lhs == *rhs;
+    }
+
+    /**
+     * Order universes by their elements, such that sets over different universes are never equivalent.
+     */
+    bool universe_less(const AllSetElementsPtr_t &lhs, const AllSetElementsPtr_t &rhs) {
+        if (lhs == rhs || rhs == nullptr) {
+            return false;
+        }
+        return lhs == nullptr || *lhs < *rhs;
+    }
+
+    /**
+     * The hash of a universe, which agrees for universes with the same elements.
+     */
+    std::size_t hash_universe(const AllSetElementsPtr_t &all_elements) {
+        return all_elements == nullptr ? 0 : hash_integer(all_elements->size());
+    }
+}
+
 SetElement::SetElement(const AllSetElementsPtr_t &all_elements_) {
     this->all_elements = all_elements_;
     this->element_index = -1;   // “empty” sentinel
@@ -40,7 +69,7 @@ SetElement::SetElement(int element_index, const AllSetElementsPtr_t &all_element
 
 SetElement::~SetElement() = default;
 
-AbstractSimpleSetPtr_t SetElement::intersection_with(const AbstractSimpleSetPtr_t &other) {
+AbstractSimpleSetPtr_t SetElement::intersection_with_impl(const AbstractSimpleSetPtr_t &other) {
     // If the other is the same index, return a single‐element set; else return empty.
     // We avoid any temporary C‐cast by checking the dynamic type with a direct static_cast
     // (We trust callers to pass only SetElement pointers for “simple” operations.)
@@ -52,7 +81,7 @@ AbstractSimpleSetPtr_t SetElement::intersection_with(const AbstractSimpleSetPtr_
     return result;
 }
 
-SimpleSetSetPtr_t SetElement::complement() {
+SimpleSetSetPtr_t SetElement::complement_impl() {
     // Build one global composite that contains every index except “this->element_index”.
     // We will insert pointers into a local std::set and return it.  To avoid O(N log N)
     // on every insert, we do a trick: collect a vector of new shared_ptrs, then insert
@@ -80,7 +109,7 @@ SimpleSetSetPtr_t SetElement::complement() {
             continue;
         }
         // We know the constructor throws if i < 0 or i >= U, but here i is valid.
-        scratch.push_back(std::make_shared<SetElement>(i, all_elements));
+        scratch.push_back(make_shared_set_element(i, all_elements));
     }
 
     auto result = make_shared_simple_set_set();
@@ -104,24 +133,58 @@ bool SetElement::is_empty() {
 bool SetElement::operator==(const AbstractSimpleSet &other) {
     // We trust that “other” is actually a SetElement (safe up‐cast).
     const auto &o = static_cast<const SetElement &>(other);
-    return (this->element_index == o.element_index);
+    return *this == o;
 }
 
 bool SetElement::operator==(const SetElement &other) {
-    return (this->element_index == other.element_index);
+    return this->element_index == other.element_index && same_universe(all_elements, other.all_elements);
+}
+
+std::size_t SetElement::compute_hash() const {
+    return hash_combine(hash_integer(static_cast<std::uint64_t>(element_index)), hash_universe(all_elements));
+}
+
+AbstractSimpleSetPtr_t SetElement::deep_copy() {
+    return make_shared_set_element(element_index, all_elements);
+}
+
+namespace {
+    void account_all_elements(MemoryAccountant &accountant, const AllSetElementsPtr_t &all_elements, bool owned) {
+        bool universe_owned;
+        if (accountant.enter(all_elements, owned, universe_owned)) {
+            accountant.add(sizeof(std::set<long long>) + all_elements->size() * (TREE_NODE_BYTES + sizeof(long long)),
+                           universe_owned);
+        }
+    }
+}
+
+void SetElement::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(SetElement), owned);
+    account_all_elements(accountant, all_elements, owned);
+}
+
+bool SetElement::bounding_box(BoundingBox_t &box) {
+    box.emplace_back(element_index, element_index);
+    return true;
 }
 
 bool SetElement::operator<(const AbstractSimpleSet &other) {
     const auto &o = static_cast<const SetElement &>(other);
-    return (this->element_index < o.element_index);
+    return *this < o;
 }
 
 bool SetElement::operator<(const SetElement &other) {
-    return (this->element_index < other.element_index);
+    if (this->element_index != other.element_index) {
+        return this->element_index < other.element_index;
+    }
+    return universe_less(all_elements, other.all_elements);
 }
 
 bool SetElement::operator<=(const SetElement &other) {
-    return (this->element_index <= other.element_index);
+    if (this->element_index != other.element_index) {
+        return this->element_index < other.element_index;
+    }
+    return !universe_less(other.all_elements, all_elements);
 }
 
 std::string *SetElement::non_empty_to_string() {
@@ -150,8 +213,8 @@ Set::Set(const SetElementPtr_t &element_, const AllSetElementsPtr_t &all_element
 }
 
 Set::Set(const AllSetElementsPtr_t &all_elements_) {
-    // Start out empty
-    this->simple_sets = make_shared_simple_set_set();
+    // Start out empty; an empty bitset holds no element of any universe
+    this->simple_sets.defer();
     this->all_elements = all_elements_;
 }
 
@@ -163,21 +226,69 @@ Set::Set(const SimpleSetSetPtr_t &elements_, const AllSetElementsPtr_t &all_elem
     this->simple_sets->insert(elements_->begin(), elements_->end());
 }
 
-Set::~Set() {
-    // Clearing an std::set is O(M).  We can simply let the shared_ptr go out of scope
-    // (default destructor does that).  But to match original semantics we call clear().
-    this->simple_sets->clear();
+Set::Set(DynamicBitset bits, const AllSetElementsPtr_t &all_elements_) : bits_(std::move(bits)) {
+    this->all_elements = all_elements_;
+    // the set elements are only created if simple_sets is accessed
+    this->simple_sets.defer();
 }
 
+SimpleSetSetPtr_t Set::make_simple_sets() const {
+    auto result = make_shared_simple_set_set();
+    // Set bits are visited in ascending order, which is the order of the std::set, so every hinted insert is O(1).
+    bits_.for_each_set_bit([this, &result](const std::size_t index) {
+        result->emplace_hint(result->end(), make_shared_set_element(static_cast<int>(index), all_elements));
+    });
+    return result;
+}
+
+SetPtr_t Set::from_indices(const long long *indices, const std::size_t count,
+                           const AllSetElementsPtr_t &all_elements_) {
+    // the bitset sorts and deduplicates in linear time
+    const auto universe_size = static_cast<long long>(all_elements_->size());
+    DynamicBitset bits(all_elements_->size());
+    for (std::size_t index = 0; index < count; ++index) {
+        if (indices[index] < 0 || indices[index] >= universe_size) {
+            throw std::invalid_argument("element index " + std::to_string(indices[index]) +
+                                        " is not in the universe of " + std::to_string(universe_size) + " elements");
+        }
+        bits.set(static_cast<std::size_t>(indices[index]));
+    }
+    return make_shared_set(std::move(bits), all_elements_);
+}
+
+void Set::to_indices(long long *indices) const {
+    if (simple_sets.observed()) {
+        for (const auto &simple_set: *simple_sets.container()) {
+            *indices++ = static_cast<SetElement *>(simple_set.get())->element_index;
+        }
+        return;
+    }
+    bits_.for_each_set_bit([&indices](const std::size_t index) {
+        *indices++ = static_cast<long long>(index);
+    });
+}
+
+Set::~Set() = default;
+
 AbstractCompositeSetPtr_t Set::make_new_empty() const {
     // Strictly the same as original—produce a brand‐new empty Set (with the same universe).
-    return std::make_shared<Set>(all_elements);
+    RANDOM_EVENTS_COUNT(empty_allocations);
+    return make_shared_set(all_elements);
+}
+
+void Set::account_memory(MemoryAccountant &accountant, bool owned) const {
+    accountant.add(sizeof(Set) + bits_.words().capacity() * sizeof(std::uint64_t), owned);
+    account_simple_sets(accountant, owned);
+    account_all_elements(accountant, all_elements, owned);
 }
 
 AbstractCompositeSetPtr_t Set::simplify() {
+    if (!simple_sets.observed()) {
+        return make_shared_set(bits_, all_elements);
+    }
     // “Simplify” used to reinsert every pointer.  We do exactly the same bulk‐insert at once,
     // so we have only *one* insert operation per element, instead of a loop of M calls.
-    return std::make_shared<Set>(simple_sets, all_elements);
+    return make_shared_set(simple_sets.container(), all_elements);
 }
 
 std::string *Set::to_string() {
@@ -186,50 +297,241 @@ std::string *Set::to_string() {
         return &EMPTY_SET_SYMBOL;
     }
 
-    //
-    // 1) Estimate total length of the final string so we can reserve() once.
-    //    Format:  “{E1, E2, E3, …, Ek}”
-    //    Let M = number of simple elements in *simple_sets.
-    //
-    //   We know each simple_set->to_string() returns a new heap string.  We must call it
-    //   anyway, but we can at least avoid repeated re‐alloc of our result buffer.
-    //
-    size_t M = simple_sets->size();
+    // Format:  “{E1, E2, E3, …, Ek}”, where each element is written as its index (see SetElement::to_string)
+    auto result = new std::string("{");
+    bool first_flag = true;
+    bits().for_each_set_bit([&result, &first_flag](const std::size_t index) {
+        if (!first_flag) {
+            result->append(", ");
+        }
+        first_flag = false;
+        result->append(std::to_string(index));
+    });
+    result->push_back('}');
+    return result;
+}
 
-    // Gather each single‐element string into a small vector of std::string objects:
-    //   This costs "M calls to to_string() & a new std::string".
-    //   But then we can measure their sizes and do one single reserve() for the final.
-    std::vector<std::string> fragments;
-    fragments.reserve(M);
+bool Set::is_empty() {
+    if (simple_sets.observed()) {
+        return AbstractCompositeSet::is_empty();
+    }
+    return bits_.none();
+}
 
-    size_t total_chars = 2;       // account for “{” and “}”
-    size_t comma_chars = (M > 1) ? ((M - 1) * 2) : 0;  
-    total_chars += comma_chars;
+namespace {
+    /**
+     * Drop the bits beyond a universe.
+     * @throws std::invalid_argument If one of them is set.
+     */
+    void restrict_to_universe(DynamicBitset &bits, const std::size_t universe_size) {
+        const auto foreign = bits.find_next(universe_size);
+        if (foreign < bits.size()) {
+            throw std::invalid_argument("element index " + std::to_string(foreign) + " is not in the universe of " +
+                                        std::to_string(universe_size) + " elements");
+        }
+        bits.resize(universe_size);
+    }
 
-    for (auto const &simple_ptr : *simple_sets) {
-        // Each simple_ptr->to_string() returns a brand‐new std::string* on the heap.
-        // We immediately copy it into our local std::string, then delete the original ptr.
-        std::string *raw = simple_ptr->to_string();
-        fragments.emplace_back(std::move(*raw));
-        size_t len = fragments.back().size();
-        total_chars += len;
-        delete raw;
+    /**
+     * Resize two bitsets to the larger of their sizes, such that they can be compared word by word.
+     */
+    void align_sizes(DynamicBitset &lhs, DynamicBitset &rhs) {
+        const auto size = std::max(lhs.size(), rhs.size());
+        lhs.resize(size);
+        rhs.resize(size);
     }
+}
 
-    // 2) Build one final string, reserving exactly what we need.
-    auto result = new std::string();
-    result->reserve(total_chars);
-    result->push_back('{');
+bool Set::operator==(const AbstractCompositeSet &other) const {
+    if (this == &other) {
+        return true;
+    }
+    const auto set = dynamic_cast<const Set *>(&other);
+    if (set == nullptr) {
+        return false;
+    }
+    if (!same_universe(all_elements, set->all_elements)) {
+        return false;
+    }
+    auto lhs = bits();
+    auto rhs = set->bits();
+    align_sizes(lhs, rhs);
+    return lhs == rhs;
+}
 
-    bool first_flag = true;
-    for (size_t i = 0; i < M; ++i) {
-        if (! first_flag) {
-            result->append(", ");
+bool Set::operator<(const AbstractCompositeSet &other) const {
+    const auto set = dynamic_cast<const Set *>(&other);
+    if (set == nullptr) {
+        return AbstractCompositeSet::operator<(other);
+    }
+    auto lhs = bits();
+    auto rhs = set->bits();
+    align_sizes(lhs, rhs);
+    auto difference = lhs;
+    difference ^= rhs;
+    const auto first = difference.find_next(0);
+    if (first == difference.size()) {
+        return universe_less(all_elements, set->all_elements);
+    }
+    // Both agree below the first difference. The side that contains it is smaller, unless the other side ends there.
+    if (lhs.test(first)) {
+        return rhs.find_next(first + 1) < rhs.size();
+    }
+    return lhs.find_next(first + 1) == lhs.size();
+}
+
+std::size_t Set::compute_hash() const {
+    // the same hash as the one of the simple sets (see AbstractCompositeSet::compute_hash)
+    const auto bits = this->bits();
+    const auto universe_hash = hash_universe(all_elements);
+    std::size_t seed = hash_integer(bits.count());
+    bits.for_each_set_bit([&seed, universe_hash](const std::size_t index) {
+        seed = hash_combine(seed, hash_combine(hash_integer(static_cast<std::uint64_t>(index)), universe_hash));
+    });
+    return seed;
+}
+
+bool Set::bounding_range(std::pair<double, double> &range) const {
+    const auto bits = this->bits();
+    const auto first = bits.find_next(0);
+    if (first == bits.size()) {
+        return false;
+    }
+    range = {static_cast<double>(first), static_cast<double>(bits.find_last())};
+    return true;
+}
+
+AbstractCompositeSetPtr_t Set::deep_copy() const {
+    if (simple_sets.observed()) {
+        return AbstractCompositeSet::deep_copy();
+    }
+    return make_shared_set(bits_, all_elements);
+}
+
+AbstractCompositeSetPtr_t Set::shallow_copy() const {
+    if (simple_sets.observed()) {
+        return AbstractCompositeSet::shallow_copy();
+    }
+    return make_shared_set(bits_, all_elements);
+}
+
+DynamicBitset Set::bits() const {
+    if (simple_sets.observed()) {
+        return bits_of(*simple_sets.container());
+    }
+    auto result = bits_;
+    if (result.size() < all_elements->size()) {
+        result.resize(all_elements->size());
+    }
+    return result;
+}
+
+DynamicBitset Set::bits_of(const SimpleSetSet_t &elements) const {
+    // set elements are ordered by index, hence the last one has the largest
+    std::size_t size = all_elements->size();
+    if (!elements.empty()) {
+        const auto last = static_cast<SetElement *>(elements.rbegin()->get())->element_index;
+        size = std::max(size, static_cast<std::size_t>(std::max(last, -1) + 1));
+    }
+    DynamicBitset result(size);
+    for (auto const &simple_set : elements) {
+        // empty elements (index -1) contain nothing
+        const auto index = static_cast<SetElement *>(simple_set.get())->element_index;
+        if (index >= 0) {
+            result.set(static_cast<std::size_t>(index));
         }
-        first_flag = false;
-        result->append(fragments[i]);
     }
-    result->push_back('}');
+    return result;
+}
 
+DynamicBitset Set::bits_of(const AbstractSimpleSetPtr_t &element) const {
+    const auto index = static_cast<SetElement *>(element.get())->element_index;
+    DynamicBitset result(std::max(all_elements->size(), static_cast<std::size_t>(std::max(index, -1) + 1)));
+    if (index >= 0) {
+        result.set(static_cast<std::size_t>(index));
+    }
     return result;
 }
+
+DynamicBitset Set::bits_of(const AbstractCompositeSet &other) const {
+    if (const auto set = dynamic_cast<const Set *>(&other)) {
+        auto result = set->bits();
+        if (result.size() < all_elements->size()) {
+            result.resize(all_elements->size());
+        }
+        return result;
+    }
+    return bits_of(*other.simple_sets);
+}
+
+SetPtr_t Set::make_result(DynamicBitset bits) const {
+    restrict_to_universe(bits, all_elements->size());
+    return make_shared_set(std::move(bits), all_elements);
+}
+
+DynamicBitset Set::to_bitset() const {
+    auto result = bits();
+    restrict_to_universe(result, all_elements->size());
+    return result;
+}
+
+std::size_t Set::cardinality() const {
+    if (simple_sets.observed()) {
+        return simple_sets.container()->size();
+    }
+    return bits_.count();
+}
+
+AbstractCompositeSetPtr_t Set::intersection_with(const AbstractSimpleSetPtr_t &simple_set) {
+    auto bits = this->bits();
+    bits &= bits_of(simple_set);
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::intersection_with(const SimpleSetSetPtr_t &other) {
+    auto bits = this->bits();
+    bits &= bits_of(*other);
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::intersection_with_impl(const AbstractCompositeSetPtr_t &other) {
+    auto bits = this->bits();
+    bits &= bits_of(*other);
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::complement_impl() const {
+    // One pass over the universe instead of intersecting |this| complements of size |universe| - 1 each.
+    auto bits = this->bits();
+    bits.resize(all_elements->size());
+    bits.flip();
+    return make_shared_set(std::move(bits), all_elements);
+}
+
+AbstractCompositeSetPtr_t Set::union_with(const AbstractSimpleSetPtr_t &other) {
+    auto bits = this->bits();
+    auto other_bits = bits_of(other);
+    align_sizes(bits, other_bits);
+    bits |= other_bits;
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::union_with_impl(const AbstractCompositeSetPtr_t &other) {
+    auto bits = this->bits();
+    auto other_bits = bits_of(*other);
+    align_sizes(bits, other_bits);
+    bits |= other_bits;
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::difference_with(const AbstractSimpleSetPtr_t &other) {
+    auto bits = this->bits();
+    bits -= bits_of(other);
+    return make_result(std::move(bits));
+}
+
+AbstractCompositeSetPtr_t Set::difference_with(const AbstractCompositeSetPtr_t &other) {
+    auto bits = this->bits();
+    bits -= bits_of(*other);
+    return make_result(std::move(bits));
+}
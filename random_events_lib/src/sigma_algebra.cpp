@@ -1,5 +1,11 @@
 #include "sigma_algebra.h"
+#include "sweep_and_prune.h"
+#include "thread_pool.h"
+#include "operation_cache.h"
+#include "tracing.h"
 #include <algorithm>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
 #include <iterator>
 #include <vector>
@@ -60,6 +66,70 @@ SimpleSetSetPtr_t AbstractSimpleSet::difference_with(const AbstractSimpleSetPtr_
     return difference;
 }
 
+namespace {
+
+    /**
+     * Look up a simple set operation in the operation cache or compute and store it.
+     * The cache stores deep copies of the operands and the result on the heap and hands out deep copies of its
+     * results, such that neither the caller nor the operation arena share any object with an entry.
+     */
+    template<typename Result, typename Copy, typename Compute>
+    Result cached_simple_operation(SetOperation operation, AbstractSimpleSet &lhs, const AbstractSimpleSetPtr_t &rhs,
+                                   Copy &&copy, Compute &&compute) {
+        auto &cache = OperationCache::global();
+        if (!cache.enabled()) {
+            return compute();
+        }
+
+        const auto hash = operation_hash(operation, lhs.hash(), rhs ? rhs->hash() : 0);
+        if (auto cached = cache.find(operation, hash, lhs, rhs.get())) {
+            ArenaSuspension suspension;
+            return copy(std::static_pointer_cast<typename Result::element_type>(cached));
+        }
+        auto result = compute();
+        {
+            ArenaSuspension suspension;
+            cache.insert(operation, hash, lhs.deep_copy(), rhs ? rhs->deep_copy() : nullptr, copy(result));
+        }
+        return result;
+    }
+
+    SimpleSetSetPtr_t copy_simple_set_set(const SimpleSetSetPtr_t &simple_sets) {
+        auto result = make_shared_simple_set_set();
+        for (auto const &simple_set : *simple_sets) {
+            result->emplace_hint(result->end(), simple_set->deep_copy());
+        }
+        return result;
+    }
+}
+
+AbstractSimpleSetPtr_t AbstractSimpleSet::intersection_with(const AbstractSimpleSetPtr_t &other) {
+    RANDOM_EVENTS_COUNT(simple_intersections);
+    return cached_simple_operation<AbstractSimpleSetPtr_t>(
+            SetOperation::SIMPLE_INTERSECTION, *this, other,
+            [](const AbstractSimpleSetPtr_t &result) { return result->deep_copy(); },
+            [&] { return intersection_with_impl(other); });
+}
+
+SimpleSetSetPtr_t AbstractSimpleSet::complement() {
+    RANDOM_EVENTS_COUNT(simple_complements);
+    return cached_simple_operation<SimpleSetSetPtr_t>(
+            SetOperation::SIMPLE_COMPLEMENT, *this, nullptr, copy_simple_set_set,
+            [&] { return complement_impl(); });
+}
+
+MemoryUsage AbstractSimpleSet::memory_usage() const {
+    MemoryAccountant accountant;
+    do {
+        accountant.enter(this);
+        if (!weak_from_this().expired()) {
+            accountant.add(SHARED_CONTROL_BLOCK_BYTES, true);
+        }
+        account_memory(accountant, true);
+    } while (accountant.next_pass());
+    return accountant.usage();
+}
+
 std::string *AbstractSimpleSet::to_string() {
     if (is_empty()) {
         return &EMPTY_SET_SYMBOL;
@@ -78,6 +148,19 @@ bool AbstractSimpleSet::operator!=(const AbstractSimpleSet &other) {
     return !(*this == other);
 }
 
+AbstractSimpleSetPtr_t AbstractSimpleSet::promote(const OperationArena &arena) {
+    if (arena.owns(this)) {
+        return deep_copy();
+    }
+    return shared_from_this();
+}
+
+void AbstractSimpleSet::check_mutable() const {
+    if (is_frozen()) {
+        throw std::invalid_argument("cannot modify a frozen simple set in place; modify a copy of it instead");
+    }
+}
+
 
 // =============================================================
 //  —— AbstractCompositeSet (composite of "atomic" SimpleSets) ——
@@ -162,6 +245,12 @@ std::string *AbstractCompositeSet::to_string() {
 }
 
 bool AbstractCompositeSet::operator==(const AbstractCompositeSet &other) const {
+    // Identical (e.g. interned) sets are equal without looking at their contents
+    const auto &container = simple_sets.container();
+    if (this == &other || (container && container == other.simple_sets.container())) {
+        return true;
+    }
+
     // Quick size check first
     if (simple_sets->size() != other.simple_sets->size()) {
         return false;
@@ -171,7 +260,7 @@ bool AbstractCompositeSet::operator==(const AbstractCompositeSet &other) const {
     auto it2 = other.simple_sets->begin();
     while (it1 != simple_sets->end()) {
         // Each *it1 is an AbstractSimpleSetPtr_t → deref and call operator==
-        if (!(**it1 == **it2)) {
+        if (*it1 != *it2 && !(**it1 == **it2)) {
             return false;
         }
         ++it1; ++it2;
@@ -179,10 +268,199 @@ bool AbstractCompositeSet::operator==(const AbstractCompositeSet &other) const {
     return true;
 }
 
+std::size_t AbstractCompositeSet::hash() const {
+    if (is_frozen()) {
+        return cached_hash.get([this] { return compute_hash(); });
+    }
+    return compute_hash();
+}
+
+std::size_t AbstractCompositeSet::compute_hash() const {
+    std::size_t seed = hash_integer(simple_sets->size());
+    for (auto const &simple_set: *simple_sets) {
+        seed = hash_combine(seed, simple_set->hash());
+    }
+    return seed;
+}
+
+void SimpleSetSetHandle::fill() const {
+    // concurrent readers of a shared composite set fill it once
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!deferred_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // the container lives as long as the composite set, not as long as the current operation
+    ArenaSuspension suspension;
+    pointer_ = owner_->make_simple_sets();
+    deferred_.store(false, std::memory_order_release);
+}
+
+namespace {
+    /**
+     * Run a set operation in a trace span with its temporaries in an operation arena (see OperationScope).
+     * The outermost operation promotes its result to the heap, such that the arena is released with the temporaries.
+     *
+     * @param name The name of the trace span.
+     * @param input_simple_sets The number of simple sets of the operands.
+     * @param operation The operation.
+     */
+    template<typename Operation>
+    AbstractCompositeSetPtr_t run_in_arena(const char *name, std::size_t input_simple_sets, Operation &&operation) {
+        TraceSpan span(name, input_simple_sets);
+        OperationScope scope;
+        auto result = operation();
+        span.set_output(result->simple_sets->size());
+        if (!scope.is_outermost()) {
+            return result;
+        }
+        const auto &arena = *OperationArena::current();
+        ArenaSuspension suspension;
+        return result->promote(arena);
+    }
+}
+
+namespace {
+
+    /**
+     * Look up a composite set operation in the operation cache or compute and store it (see cached_simple_operation).
+     */
+    template<typename Compute>
+    AbstractCompositeSetPtr_t cached_composite_operation(SetOperation operation, const AbstractCompositeSet &lhs,
+                                                         const AbstractCompositeSetPtr_t &rhs, Compute &&compute) {
+        auto &cache = OperationCache::global();
+        if (!cache.enabled()) {
+            return compute();
+        }
+
+        const auto hash = operation_hash(operation, lhs.hash(), rhs ? rhs->hash() : 0);
+        if (auto cached = cache.find(operation, hash, lhs, rhs.get())) {
+            ArenaSuspension suspension;
+            return std::static_pointer_cast<AbstractCompositeSet>(cached)->deep_copy();
+        }
+        auto result = compute();
+        {
+            ArenaSuspension suspension;
+            cache.insert(operation, hash, lhs.deep_copy(), rhs ? rhs->deep_copy() : nullptr, result->deep_copy());
+        }
+        return result;
+    }
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with(const AbstractCompositeSetPtr_t &other) {
+    return cached_composite_operation(SetOperation::INTERSECTION, *this, other,
+                                      [&] { return intersection_with_impl(other); });
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::complement() const {
+    return cached_composite_operation(SetOperation::COMPLEMENT, *this, nullptr,
+                                      [&] { return complement_impl(); });
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::union_with(const AbstractCompositeSetPtr_t &other) {
+    return cached_composite_operation(SetOperation::UNION, *this, other,
+                                      [&] { return union_with_impl(other); });
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::promote(const OperationArena &arena) const {
+    auto self = std::const_pointer_cast<AbstractCompositeSet>(shared_from_this());
+    // a deferred container does not exist yet, hence the composite set owns all its state
+    const auto &container = simple_sets.container();
+    if (!container) {
+        return arena.owns(this) ? deep_copy() : self;
+    }
+
+    AbstractCompositeSetPtr_t result;
+    if (arena.owns(this) || arena.owns(container.get())) {
+        result = make_new_empty();
+    }
+    for (auto it = container->begin(); it != container->end(); ++it) {
+        auto simple_set = (*it)->promote(arena);
+        if (!result && simple_set != *it) {
+            // the simple sets before are shared
+            result = make_new_empty();
+            result->simple_sets->insert(container->begin(), it);
+        }
+        if (result) {
+            result->simple_sets->emplace_hint(result->simple_sets->end(), std::move(simple_set));
+        }
+    }
+    if (!result) {
+        return self;
+    }
+    return result;
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::shallow_copy() const {
+    auto result = make_new_empty();
+    result->simple_sets = make_shared_simple_set_set(*simple_sets);
+    return result;
+}
+
+void AbstractCompositeSet::account_simple_sets(MemoryAccountant &accountant, bool owned) const {
+    // a deferred container does not exist yet
+    const auto &container = simple_sets.container();
+    bool container_owned;
+    if (!accountant.enter(container, owned, container_owned)) {
+        return;
+    }
+    accountant.add(sizeof(SimpleSetSet_t) + container->size() * (TREE_NODE_BYTES + sizeof(AbstractSimpleSetPtr_t)),
+                   container_owned);
+    for (auto const &simple_set: *container) {
+        bool simple_set_owned;
+        if (accountant.enter(simple_set, container_owned, simple_set_owned)) {
+            simple_set->account_memory(accountant, simple_set_owned);
+        }
+    }
+}
+
+MemoryUsage AbstractCompositeSet::memory_usage() const {
+    MemoryAccountant accountant;
+    do {
+        accountant.enter(this);
+        if (!weak_from_this().expired()) {
+            accountant.add(SHARED_CONTROL_BLOCK_BYTES, true);
+        }
+        account_memory(accountant, true);
+    } while (accountant.next_pass());
+    return accountant.usage();
+}
+
+AbstractCompositeSetPtr_t AbstractCompositeSet::deep_copy() const {
+    auto result = make_new_empty();
+    for (auto const &simple_set: *simple_sets) {
+        result->simple_sets->emplace_hint(result->simple_sets->end(), simple_set->deep_copy());
+    }
+    return result;
+}
+
+bool AbstractCompositeSet::bounding_range(std::pair<double, double> &range) const {
+    if (simple_sets->empty()) {
+        return false;
+    }
+    range = {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+    BoundingBox_t box;
+    for (auto const &simple_set: *simple_sets) {
+        box.clear();
+        if (!simple_set->bounding_box(box) || box.size() != 1) {
+            return false;
+        }
+        range.first = std::min(range.first, box.front().first);
+        range.second = std::max(range.second, box.front().second);
+    }
+    return true;
+}
+
 bool AbstractCompositeSet::operator!=(const AbstractCompositeSet &other) const {
     return !(*this == other);
 }
 
+void AbstractCompositeSet::check_mutable() const {
+    if (is_frozen()) {
+        throw std::invalid_argument("cannot modify a frozen composite set in place; modify a copy of it instead");
+    }
+}
+
 bool AbstractCompositeSet::operator<(const AbstractCompositeSet &other) const {
     // We implement a standard "lexicographical_compare" by walking both sets in lock‐step.
 
@@ -214,6 +492,10 @@ bool AbstractCompositeSet::operator<(const AbstractCompositeSet &other) const {
 
 std::tuple<AbstractCompositeSetPtr_t, AbstractCompositeSetPtr_t>
 AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
+    RANDOM_EVENTS_COUNT(split_rounds);
+    RANDOM_EVENTS_PEAK(peak_simple_sets, simple_sets->size());
+    TraceSpan span("split_into_disjoint_and_non_disjoint", simple_sets->size());
+
     // Early exit for empty or singleton sets - they are already disjoint
     if (simple_sets->size() <= 1) {
         auto disjoint = make_new_empty();
@@ -223,6 +505,7 @@ AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
             disjoint->simple_sets->insert(simple_sets->begin(), simple_sets->end());
         }
 
+        span.set_output(disjoint->simple_sets->size());
         return std::make_tuple(disjoint, non_disjoint);
     }
 
@@ -233,22 +516,32 @@ AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
     std::vector<AbstractSimpleSetPtr_t> vec;
     vec.reserve(simple_sets->size());
 
-    // Use a vector of pairs to track which elements need to be processed
-    // This avoids unnecessary comparisons
-    std::vector<std::pair<size_t, size_t>> pairs_to_check;
-
-    // 1) Turn the current std::set into a vector for indexed loops (O(n))
+    // 1) Turn the current std::set into a vector for indexed loops (O(n)) and collect the bounding boxes
+    std::vector<BoundingBox_t> boxes;
+    boxes.reserve(simple_sets->size());
+    bool has_boxes = has_aligned_axes();
     for (auto const &p : *simple_sets) {
         vec.push_back(p);
+        if (has_boxes) {
+            BoundingBox_t box;
+            has_boxes = p->bounding_box(box) && (boxes.empty() || box.size() == boxes.front().size());
+            boxes.push_back(std::move(box));
+        }
     }
-
-    // Generate all pairs (i,j) where i < j
-    // This avoids redundant comparisons (comparing A with B and then B with A)
     size_t n = vec.size();
-    pairs_to_check.reserve(n * (n - 1) / 2);
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = i + 1; j < n; ++j) {
-            pairs_to_check.emplace_back(i, j);
+
+    // 2) Collect the pairs (i,j) with i < j that can intersect.
+    // Pairs whose bounding boxes are apart have an empty intersection and would not change anything below,
+    // hence skipping them keeps the result identical. The candidates are processed in the same (i, j) order.
+    std::vector<std::pair<size_t, size_t>> pairs_to_check;
+    if (has_boxes) {
+        pairs_to_check = overlapping_pairs(boxes);
+    } else {
+        pairs_to_check.reserve(n * (n - 1) / 2);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                pairs_to_check.emplace_back(i, j);
+            }
         }
     }
 
@@ -262,8 +555,27 @@ AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
         remaining_parts[i]->simple_sets->insert(vec[i]);
     }
 
+    // With more than one thread, all candidate intersections are computed in parallel up front.
+    // Empty intersections are stored as nullptr. The loop below then only looks them up, which keeps the
+    // order dependent bookkeeping (skipping removed elements, remainders) sequential and the result identical.
+    std::vector<AbstractSimpleSetPtr_t> intersections;
+    const bool parallel = pairs_to_check.size() >= PARALLEL_MIN_PAIRS && get_thread_count() > 1;
+    if (parallel) {
+        intersections.resize(pairs_to_check.size());
+        parallel_for(0, pairs_to_check.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                auto I = vec[pairs_to_check[k].first]->intersection_with(vec[pairs_to_check[k].second]);
+                if (!I->is_empty()) {
+                    intersections[k] = std::move(I);
+                }
+            }
+        }, PARALLEL_GRAIN);
+    }
+
     // Process all pairs
-    for (const auto& [i, j] : pairs_to_check) {
+    for (size_t k = 0; k < pairs_to_check.size(); ++k) {
+        const auto [i, j] = pairs_to_check[k];
+
         // Skip if either element has been completely removed
         if (completely_removed[i] || completely_removed[j]) continue;
 
@@ -271,9 +583,17 @@ AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
         auto &B = vec[j];
 
         // Compute intersection I = A ∩ B
-        auto I = A->intersection_with(B);
+        AbstractSimpleSetPtr_t I;
+        if (parallel) {
+            I = intersections[k];
+        } else {
+            I = A->intersection_with(B);
+            if (I->is_empty()) {
+                I = nullptr;
+            }
+        }
 
-        if (!I->is_empty()) {
+        if (I) {
             // Collect I into "non_disjoint" once
             non_disjoint->simple_sets->insert(I);
 
@@ -308,35 +628,40 @@ AbstractCompositeSet::split_into_disjoint_and_non_disjoint() const {
         }
     }
 
+    span.set_output(disjoint->simple_sets->size() + non_disjoint->simple_sets->size());
     return std::make_tuple(disjoint, non_disjoint);
 }
 
 AbstractCompositeSetPtr_t AbstractCompositeSet::make_disjoint() const {
-    // Early exit for empty or singleton sets - they are already disjoint
-    if (simple_sets->size() <= 1) {
-        auto result = make_new_empty();
-        if (!simple_sets->empty()) {
-            result->simple_sets->insert(simple_sets->begin(), simple_sets->end());
+    return run_in_arena("make_disjoint", simple_sets->size(), [&]() -> AbstractCompositeSetPtr_t {
+        // Early exit for empty or singleton sets - they are already disjoint
+        if (simple_sets->size() <= 1) {
+            auto result = make_new_empty();
+            if (!simple_sets->empty()) {
+                result->simple_sets->insert(simple_sets->begin(), simple_sets->end());
+            }
+            return result;
         }
-        return result;
-    }
 
-    // 1) First split current composite into (disjoint_0, non_disjoint_0)
-    auto [disjoint_acc, non_disjoint] = split_into_disjoint_and_non_disjoint();
+        RANDOM_EVENTS_PEAK(peak_simple_sets, simple_sets->size());
 
-    // 2) As long as there remain "intersecting pieces," keep splitting them
-    while (!non_disjoint->is_empty()) {
-        auto [newDisjoint, remainder] = non_disjoint->split_into_disjoint_and_non_disjoint();
-        // accumulate newDisjoint into disjoint_acc
-        disjoint_acc->simple_sets->insert(
-            newDisjoint->simple_sets->begin(),
-            newDisjoint->simple_sets->end());
-        non_disjoint = remainder;
-    }
+        // 1) First split current composite into (disjoint_0, non_disjoint_0)
+        auto [disjoint_acc, non_disjoint] = split_into_disjoint_and_non_disjoint();
+
+        // 2) As long as there remain "intersecting pieces," keep splitting them
+        while (!non_disjoint->is_empty()) {
+            auto [newDisjoint, remainder] = non_disjoint->split_into_disjoint_and_non_disjoint();
+            // accumulate newDisjoint into disjoint_acc
+            disjoint_acc->simple_sets->insert(
+                newDisjoint->simple_sets->begin(),
+                newDisjoint->simple_sets->end());
+            non_disjoint = remainder;
+        }
 
-    // 3) We have now collected every disjoint piece.  We simply return "disjoint_acc->simplify()"
-    //    which under the assumption that "disjoint_acc" is already pairwise‐disjoint, will be O(n log n)
-    return disjoint_acc->simplify();
+        // 3) We have now collected every disjoint piece.  We simply return "disjoint_acc->simplify()"
+        //    which under the assumption that "disjoint_acc" is already pairwise‐disjoint, will be O(n log n)
+        return disjoint_acc->simplify();
+    });
 }
 
 AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with(
@@ -373,30 +698,74 @@ AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with(
         return make_new_empty();
     }
 
-    // We want ∪_{B ∈ other} (this ∩ B).  We'll accumulate all those atomic pieces into one vector,
-    // then bulk‐insert.
-
-    std::vector<AbstractSimpleSetPtr_t> scratch;
-    scratch.reserve(simple_sets->size() + other->size());
-
-    for (auto const &B : *other) {
-        // "temp" is (this ∩ B), itself a small composite
-        auto temp = intersection_with(B);  // from above
-
-        // Insert all of temp→simple_sets into scratch
-        for (auto const &p : *temp->simple_sets) {
-            scratch.push_back(p);
+    // We want ∪_{A ∈ this, B ∈ other} (A ∩ B).  Only pairs whose bounding boxes overlap can intersect, so if the
+    // boxes of both sides refer to the same axes, the candidate pairs are joined by a sort-and-sweep instead of
+    // testing all n·m pairs. Skipped pairs have an empty intersection, hence the result is identical.
+    std::vector<AbstractSimpleSetPtr_t> lhs(simple_sets->begin(), simple_sets->end());
+    std::vector<AbstractSimpleSetPtr_t> rhs(other->begin(), other->end());
+
+    std::vector<BoundingBox_t> lhs_boxes, rhs_boxes;
+    bool has_boxes = has_aligned_axes_with(other);
+    auto collect_boxes = [&has_boxes](const std::vector<AbstractSimpleSetPtr_t> &simple_sets,
+                                      std::vector<BoundingBox_t> &boxes, std::size_t axes) {
+        boxes.reserve(simple_sets.size());
+        for (auto const &p : simple_sets) {
+            BoundingBox_t box;
+            has_boxes = has_boxes && p->bounding_box(box) && box.size() == axes;
+            if (!has_boxes) {
+                return;
+            }
+            boxes.push_back(std::move(box));
+        }
+    };
+    if (has_boxes) {
+        BoundingBox_t first;
+        has_boxes = lhs.front()->bounding_box(first);
+        collect_boxes(lhs, lhs_boxes, first.size());
+        collect_boxes(rhs, rhs_boxes, first.size());
+    }
+
+    // Without boxes, the n·m pairs are enumerated on the fly as k = i·m + j instead of being materialized.
+    IndexPairs_t pairs;
+    if (has_boxes) {
+        pairs = overlapping_pairs(lhs_boxes, rhs_boxes);
+    }
+    const std::size_t pair_count = has_boxes ? pairs.size() : lhs.size() * rhs.size();
+
+    // The pairs are split into chunks that each collect their non-empty intersections, such that the memory grows
+    // with the result and not with the number of pairs. The chunks are merged in order.
+    std::size_t chunk_count = 1;
+    if (pair_count >= PARALLEL_MIN_PAIRS && get_thread_count() > 1) {
+        chunk_count = std::min((pair_count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN, get_thread_count() * 4);
+    }
+    const std::size_t chunk_size = (pair_count + chunk_count - 1) / chunk_count;
+    std::vector<std::vector<AbstractSimpleSetPtr_t>> chunk_intersections(chunk_count);
+    auto intersect = [&](std::size_t chunks_begin, std::size_t chunks_end) {
+        for (std::size_t chunk = chunks_begin; chunk < chunks_end; ++chunk) {
+            const std::size_t end = std::min(pair_count, (chunk + 1) * chunk_size);
+            for (std::size_t k = chunk * chunk_size; k < end; ++k) {
+                const auto [i, j] = has_boxes ? pairs[k] : std::make_pair(k / rhs.size(), k % rhs.size());
+                auto I = lhs[i]->intersection_with(rhs[j]);  // cost = T_cap
+                if (!I->is_empty()) {
+                    chunk_intersections[chunk].push_back(std::move(I));
+                }
+            }
         }
+    };
+    if (chunk_count > 1) {
+        parallel_for(0, chunk_count, intersect);
+    } else {
+        intersect(0, chunk_count);
     }
 
     auto result = make_new_empty();
-    if (!scratch.empty()) {
-        result->simple_sets->insert(scratch.begin(), scratch.end());
+    for (auto const &intersections : chunk_intersections) {
+        result->simple_sets->insert(intersections.begin(), intersections.end());
     }
     return result;
 }
 
-AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with(
+AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with_impl(
     const AbstractCompositeSetPtr_t &other) {
     // Early exit for empty sets
     if (simple_sets->empty() || other->simple_sets->empty()) {
@@ -407,31 +776,33 @@ AbstractCompositeSetPtr_t AbstractCompositeSet::intersection_with(
     return intersection_with(other->simple_sets);
 }
 
-AbstractCompositeSetPtr_t AbstractCompositeSet::complement() const {
-    // Early exit for empty sets - complement of empty set is the universal set
-    if (simple_sets->empty()) {
-        return make_new_empty();
-    }
-
-    // We know "(∪ A_i)^c = ∩ (A_i^c)."
-    // So we iterate over each atomic piece, compute A_i^c (a set of pieces), then intersect them in turn.
-
-    AbstractCompositeSetPtr_t result = nullptr;
-    bool first = true;
+AbstractCompositeSetPtr_t AbstractCompositeSet::complement_impl() const {
+    return run_in_arena("complement", simple_sets->size(), [&]() -> AbstractCompositeSetPtr_t {
+        // Early exit for empty sets - complement of empty set is the universal set
+        if (simple_sets->empty()) {
+            return make_new_empty();
+        }
 
-    for (auto const &A : *simple_sets) {
-        auto compA = A->complement();  // cost ≈ O(k_i log k_i)
-        if (first) {
-            // Initialize result to "all pieces from A^c"
-            result = make_new_empty();
-            result->simple_sets->insert(compA->begin(), compA->end());
-            first = false;
-        } else {
-            // Intersect the running result with compA
-            result = result->intersection_with(compA);  // each intersection is expensive
+        // We know "(∪ A_i)^c = ∩ (A_i^c)."
+        // So we iterate over each atomic piece, compute A_i^c (a set of pieces), then intersect them in turn.
+
+        AbstractCompositeSetPtr_t result = nullptr;
+        bool first = true;
+
+        for (auto const &A : *simple_sets) {
+            auto compA = A->complement();  // cost ≈ O(k_i log k_i)
+            if (first) {
+                // Initialize result to "all pieces from A^c"
+                result = make_new_empty();
+                result->simple_sets->insert(compA->begin(), compA->end());
+                first = false;
+            } else {
+                // Intersect the running result with compA
+                result = result->intersection_with(compA);  // each intersection is expensive
+            }
         }
-    }
-    return (result == nullptr) ? make_new_empty() : result;
+        return (result == nullptr) ? make_new_empty() : result;
+    });
 }
 
 AbstractCompositeSetPtr_t AbstractCompositeSet::union_with(
@@ -472,7 +843,7 @@ AbstractCompositeSetPtr_t AbstractCompositeSet::union_with(
     return result->make_disjoint();
 }
 
-AbstractCompositeSetPtr_t AbstractCompositeSet::union_with(
+AbstractCompositeSetPtr_t AbstractCompositeSet::union_with_impl(
     const AbstractCompositeSetPtr_t &other) {
     // Early exit for empty sets
     if (simple_sets->empty()) {
@@ -540,75 +911,82 @@ AbstractCompositeSetPtr_t AbstractCompositeSet::union_with(
 
 AbstractCompositeSetPtr_t AbstractCompositeSet::difference_with(
     const AbstractSimpleSetPtr_t &other) {
-    // Early exit for empty sets or if other is empty
-    if (simple_sets->empty()) {
-        return make_new_empty();
-    }
-    if (other->is_empty()) {
-        return shared_from_this();
-    }
+    return run_in_arena("difference_with", simple_sets->size() + 1, [&]() -> AbstractCompositeSetPtr_t {
+        // Early exit for empty sets or if other is empty
+        if (simple_sets->empty()) {
+            return make_new_empty();
+        }
+        if (other->is_empty()) {
+            // a new composite set, since promoting the result does not copy sets that are not in the arena
+            return shallow_copy();
+        }
 
-    // Build "all pieces of Ai \ other," then collect and make_disjoint at the end
-    std::vector<AbstractSimpleSetPtr_t> scratch;
-    scratch.reserve(simple_sets->size());
+        // Build "all pieces of Ai \ other," then collect and make_disjoint at the end
+        std::vector<AbstractSimpleSetPtr_t> scratch;
+        scratch.reserve(simple_sets->size());
 
-    for (auto const &A : *simple_sets) {
-        auto diffA = A->difference_with(other);  // each diffA is a set of pieces
-        for (auto const &p : *diffA) {
-            scratch.push_back(p);
+        for (auto const &A : *simple_sets) {
+            auto diffA = A->difference_with(other);  // each diffA is a set of pieces
+            for (auto const &p : *diffA) {
+                scratch.push_back(p);
+            }
         }
-    }
 
-    auto result = make_new_empty();
-    if (!scratch.empty()) {
-        result->simple_sets->insert(scratch.begin(), scratch.end());
-    }
-    return result->make_disjoint();
+        auto result = make_new_empty();
+        if (!scratch.empty()) {
+            result->simple_sets->insert(scratch.begin(), scratch.end());
+        }
+        return result->make_disjoint();
+    });
 }
 
 AbstractCompositeSetPtr_t AbstractCompositeSet::difference_with(
     const AbstractCompositeSetPtr_t &other) {
-    // Early exit for empty sets
-    if (simple_sets->empty()) {
-        return make_new_empty();
-    }
-    if (other->is_empty()) {
-        return shared_from_this();
-    }
-
-    std::vector<AbstractSimpleSetPtr_t> all_survivors;
-    all_survivors.reserve(simple_sets->size() * other->simple_sets->size());
+    const auto input_simple_sets = simple_sets->size() + other->simple_sets->size();
+    return run_in_arena("difference_with", input_simple_sets, [&]() -> AbstractCompositeSetPtr_t {
+        // Early exit for empty sets
+        if (simple_sets->empty()) {
+            return make_new_empty();
+        }
+        if (other->is_empty()) {
+            // a new composite set, since promoting the result does not copy sets that are not in the arena
+            return shallow_copy();
+        }
 
-    // For each A_i in "this", subtract off all pieces in "other"
-    for (auto const &A : *simple_sets) {
-        // current_difference is "{A}" initially
-        auto current_diff = make_new_empty();
-        current_diff->simple_sets->insert(A);
-
-        // Now subtract each B_j in "other"
-        for (auto const &B : *other->simple_sets) {
-            // Compute A′ = current_diff \ B
-            // Note: difference_with(B) returns a set of pieces
-            auto temp = current_diff->difference_with(B);
-            if (temp->is_empty()) {
-                current_diff = nullptr;
-                break;  // A is fully removed
+        std::vector<AbstractSimpleSetPtr_t> all_survivors;
+        all_survivors.reserve(simple_sets->size() * other->simple_sets->size());
+
+        // For each A_i in "this", subtract off all pieces in "other"
+        for (auto const &A : *simple_sets) {
+            // current_difference is "{A}" initially
+            auto current_diff = make_new_empty();
+            current_diff->simple_sets->insert(A);
+
+            // Now subtract each B_j in "other"
+            for (auto const &B : *other->simple_sets) {
+                // Compute A′ = current_diff \ B
+                // Note: difference_with(B) returns a set of pieces
+                auto temp = current_diff->difference_with(B);
+                if (temp->is_empty()) {
+                    current_diff = nullptr;
+                    break;  // A is fully removed
+                }
+                current_diff = temp;
             }
-            current_diff = temp;
-        }
-        if (current_diff != nullptr) {
-            // Collect whatever atomic pieces remained
-            for (auto const &p : *current_diff->simple_sets) {
-                all_survivors.push_back(p);
+            if (current_diff != nullptr) {
+                // Collect whatever atomic pieces remained
+                for (auto const &p : *current_diff->simple_sets) {
+                    all_survivors.push_back(p);
+                }
             }
         }
-    }
 
-    auto result = make_new_empty();
-    if (!all_survivors.empty()) {
-        result->simple_sets->insert(all_survivors.begin(), all_survivors.end());
-    }
-    return result->make_disjoint();
+        auto result = make_new_empty();
+        if (!all_survivors.empty()) {
+            result->simple_sets->insert(all_survivors.begin(), all_survivors.end());
+        }
+        return result->make_disjoint();
+    });
 }
 
 bool AbstractCompositeSet::contains(const AbstractCompositeSetPtr_t &other) {
@@ -627,5 +1005,6 @@ bool AbstractCompositeSet::contains(const AbstractCompositeSetPtr_t &other) {
 
 void AbstractCompositeSet::add_new_simple_set(
     const AbstractSimpleSetPtr_t &simple_set) const {
+    check_mutable();
     simple_sets->insert(simple_set);  // O(log n)
 }
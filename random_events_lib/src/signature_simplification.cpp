@@ -0,0 +1,124 @@
+#include "signature_simplification.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+
+    /**
+     * Mix the hash of a cell with its column, such that the same set in different columns contributes differently.
+     * The mixed values are summed, hence a signature with one column left out is the total minus that column.
+     */
+    std::uint64_t mix_cell(std::uint64_t hash, std::uint64_t column) {
+        std::uint64_t z = hash + (column + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    bool equal_cells(const AbstractCompositeSetPtr_t &lhs, const AbstractCompositeSetPtr_t &rhs) {
+        return lhs == rhs || *lhs == *rhs;
+    }
+
+    bool equal_except(const AssignmentRow_t &lhs, const AssignmentRow_t &rhs, std::size_t left_out) {
+        for (std::size_t column = 0; column < lhs.size(); ++column) {
+            if (column != left_out && !equal_cells(lhs[column], rhs[column])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool simplify_by_signature(AssignmentRows_t &rows) {
+    if (rows.size() < 2 || rows.front().empty()) {
+        return false;
+    }
+    const std::size_t columns = rows.front().size();
+
+    // mixed hash of every cell and their sum per row
+    std::vector<std::vector<std::uint64_t>> cell_hashes(rows.size(), std::vector<std::uint64_t>(columns));
+    std::vector<std::uint64_t> row_hashes(rows.size(), 0);
+    for (std::size_t row = 0; row < rows.size(); ++row) {
+        for (std::size_t column = 0; column < columns; ++column) {
+            cell_hashes[row][column] = mix_cell(rows[row][column]->hash(), column);
+            row_hashes[row] += cell_hashes[row][column];
+        }
+    }
+
+    bool changed_any = false;
+    bool changed = true;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> buckets;
+    std::vector<bool> alive;
+
+    while (changed) {
+        changed = false;
+        RANDOM_EVENTS_COUNT(simplify_passes);
+        for (std::size_t column = 0; column < columns && rows.size() > 1; ++column) {
+
+            // group rows by their signature without this column
+            buckets.clear();
+            buckets.reserve(rows.size());
+            for (std::size_t row = 0; row < rows.size(); ++row) {
+                buckets[row_hashes[row] - cell_hashes[row][column]].push_back(row);
+            }
+
+            alive.assign(rows.size(), true);
+            bool merged = false;
+            for (auto &[signature, members]: buckets) {
+                if (members.size() < 2) {
+                    continue;
+                }
+
+                // resolve hash collisions; every member is merged into the first equal member
+                for (std::size_t i = 0; i < members.size(); ++i) {
+                    const auto target = members[i];
+                    if (!alive[target]) {
+                        continue;
+                    }
+                    bool target_changed = false;
+                    for (std::size_t j = i + 1; j < members.size(); ++j) {
+                        const auto source = members[j];
+                        if (!alive[source] || !equal_except(rows[target], rows[source], column)) {
+                            continue;
+                        }
+                        if (!equal_cells(rows[target][column], rows[source][column])) {
+                            rows[target][column] = rows[target][column]->union_with(rows[source][column]);
+                        }
+                        alive[source] = false;
+                        target_changed = true;
+                    }
+                    if (target_changed) {
+                        merged = true;
+                        row_hashes[target] -= cell_hashes[target][column];
+                        cell_hashes[target][column] = mix_cell(rows[target][column]->hash(), column);
+                        row_hashes[target] += cell_hashes[target][column];
+                    }
+                }
+            }
+
+            if (!merged) {
+                continue;
+            }
+
+            // drop the merged rows
+            std::size_t kept = 0;
+            for (std::size_t row = 0; row < rows.size(); ++row) {
+                if (!alive[row]) {
+                    continue;
+                }
+                if (kept != row) {
+                    rows[kept] = std::move(rows[row]);
+                    cell_hashes[kept] = std::move(cell_hashes[row]);
+                    row_hashes[kept] = row_hashes[row];
+                }
+                ++kept;
+            }
+            rows.resize(kept);
+            cell_hashes.resize(kept);
+            row_hashes.resize(kept);
+            changed = true;
+            changed_any = true;
+        }
+    }
+    return changed_any;
+}
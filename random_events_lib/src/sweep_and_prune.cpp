@@ -0,0 +1,188 @@
+#include "sweep_and_prune.h"
+#include <algorithm>
+#include <numeric>
+
+bool boxes_overlap(const BoundingBox_t &lhs, const BoundingBox_t &rhs) {
+    for (std::size_t axis = 0; axis < lhs.size(); ++axis) {
+        if (!(lhs[axis].first <= rhs[axis].second && rhs[axis].first <= lhs[axis].second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+    std::vector<std::size_t> order_by_lower(const std::vector<BoundingBox_t> &boxes, std::size_t axis) {
+        std::vector<std::size_t> order(boxes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return boxes[lhs][axis].first < boxes[rhs][axis].first;
+        });
+        return order;
+    }
+
+    /**
+     * Count the pairs that overlap on one axis, i.e. the number of pairs a sweep along that axis has to test.
+     */
+    std::size_t count_axis_overlaps(const std::vector<BoundingBox_t> &boxes, std::size_t axis) {
+        std::vector<double> lowers;
+        lowers.reserve(boxes.size());
+        for (auto const &box: boxes) {
+            lowers.push_back(box[axis].first);
+        }
+        std::sort(lowers.begin(), lowers.end());
+
+        auto order = order_by_lower(boxes, axis);
+        std::size_t result = 0;
+        for (std::size_t position = 0; position < order.size(); ++position) {
+            const double upper = boxes[order[position]][axis].second;
+            auto end = std::upper_bound(lowers.begin() + static_cast<std::ptrdiff_t>(position) + 1, lowers.end(),
+                                        upper);
+            result += static_cast<std::size_t>(end - lowers.begin()) - position - 1;
+        }
+        return result;
+    }
+
+    /**
+     * Count the pairs between two collections that overlap on one axis.
+     * A pair overlaps iff the rhs box starts before the lhs box ends and does not end before the lhs box starts.
+     */
+    std::size_t count_axis_overlaps(const std::vector<BoundingBox_t> &lhs, const std::vector<BoundingBox_t> &rhs,
+                                    std::size_t axis) {
+        std::vector<double> lowers, uppers;
+        lowers.reserve(rhs.size());
+        uppers.reserve(rhs.size());
+        for (auto const &box: rhs) {
+            lowers.push_back(box[axis].first);
+            uppers.push_back(box[axis].second);
+        }
+        std::sort(lowers.begin(), lowers.end());
+        std::sort(uppers.begin(), uppers.end());
+
+        std::size_t result = 0;
+        for (auto const &box: lhs) {
+            const auto starting = std::upper_bound(lowers.begin(), lowers.end(), box[axis].second) - lowers.begin();
+            const auto ended = std::lower_bound(uppers.begin(), uppers.end(), box[axis].first) - uppers.begin();
+            result += static_cast<std::size_t>(std::max<std::ptrdiff_t>(starting - ended, 0));
+        }
+        return result;
+    }
+
+    /**
+     * Test every box of `sweeping` against the boxes of `other` that start in its range on the sweep axis.
+     * Boxes of `other` with the same lower bound are only visited if `include_ties` is set.
+     */
+    template<typename Emit>
+    void sweep_against(const std::vector<BoundingBox_t> &sweeping, const std::vector<std::size_t> &sweeping_order,
+                       const std::vector<BoundingBox_t> &other, const std::vector<std::size_t> &other_order,
+                       std::size_t axis, bool include_ties, const Emit &emit) {
+        std::size_t start = 0;
+        for (const auto i: sweeping_order) {
+            const double lower = sweeping[i][axis].first;
+            const double upper = sweeping[i][axis].second;
+            // the orders are sorted by lower bound, hence the start only moves forward
+            while (start < other_order.size() && (other[other_order[start]][axis].first < lower ||
+                                                  (!include_ties && other[other_order[start]][axis].first == lower))) {
+                ++start;
+            }
+            for (std::size_t next = start; next < other_order.size() && other[other_order[next]][axis].first <= upper;
+                 ++next) {
+                const auto j = other_order[next];
+                if (boxes_overlap(sweeping[i], other[j])) {
+                    emit(i, j);
+                }
+            }
+        }
+    }
+}
+
+IndexPairs_t overlapping_pairs(const std::vector<BoundingBox_t> &boxes) {
+    IndexPairs_t result;
+    const std::size_t n = boxes.size();
+    if (n < 2) {
+        return result;
+    }
+
+    const std::size_t axes = boxes.front().size();
+    if (axes == 0) {
+        result.reserve(n * (n - 1) / 2);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                result.emplace_back(i, j);
+            }
+        }
+        return result;
+    }
+
+    // pick the most selective sweep axis
+    std::size_t sweep_axis = 0;
+    if (axes > 1) {
+        std::size_t best = count_axis_overlaps(boxes, 0);
+        for (std::size_t axis = 1; axis < axes && best > 0; ++axis) {
+            auto count = count_axis_overlaps(boxes, axis);
+            if (count < best) {
+                best = count;
+                sweep_axis = axis;
+            }
+        }
+    }
+
+    // sweep
+    auto order = order_by_lower(boxes, sweep_axis);
+    for (std::size_t position = 0; position < n; ++position) {
+        const auto i = order[position];
+        const double upper = boxes[i][sweep_axis].second;
+        for (std::size_t next = position + 1; next < n && boxes[order[next]][sweep_axis].first <= upper; ++next) {
+            const auto j = order[next];
+            if (boxes_overlap(boxes[i], boxes[j])) {
+                result.emplace_back(std::min(i, j), std::max(i, j));
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+IndexPairs_t overlapping_pairs(const std::vector<BoundingBox_t> &lhs, const std::vector<BoundingBox_t> &rhs) {
+    IndexPairs_t result;
+    if (lhs.empty() || rhs.empty()) {
+        return result;
+    }
+
+    const std::size_t axes = lhs.front().size();
+    if (axes == 0) {
+        result.reserve(lhs.size() * rhs.size());
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            for (std::size_t j = 0; j < rhs.size(); ++j) {
+                result.emplace_back(i, j);
+            }
+        }
+        return result;
+    }
+
+    // pick the most selective sweep axis
+    std::size_t sweep_axis = 0;
+    if (axes > 1) {
+        std::size_t best = count_axis_overlaps(lhs, rhs, 0);
+        for (std::size_t axis = 1; axis < axes && best > 0; ++axis) {
+            auto count = count_axis_overlaps(lhs, rhs, axis);
+            if (count < best) {
+                best = count;
+                sweep_axis = axis;
+            }
+        }
+    }
+
+    // Every overlapping pair is found from the box with the smaller lower bound, ties are found from lhs.
+    const auto lhs_order = order_by_lower(lhs, sweep_axis);
+    const auto rhs_order = order_by_lower(rhs, sweep_axis);
+    sweep_against(lhs, lhs_order, rhs, rhs_order, sweep_axis, true,
+                  [&result](std::size_t i, std::size_t j) { result.emplace_back(i, j); });
+    sweep_against(rhs, rhs_order, lhs, lhs_order, sweep_axis, false,
+                  [&result](std::size_t j, std::size_t i) { result.emplace_back(i, j); });
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,185 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+    thread_local bool inside_worker = false;
+
+    std::mutex global_pool_mutex;
+    std::size_t global_thread_count = 1;
+    ThreadPoolPtr_t global_pool;
+}
+
+//
+// ===============================
+//  —— ThreadPool ——
+// ===============================
+//
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+    thread_count = std::max<std::size_t>(thread_count, 1);
+    queues_.reserve(thread_count);
+    for (std::size_t index = 0; index < thread_count; ++index) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    threads_.reserve(thread_count);
+    for (std::size_t index = 0; index < thread_count; ++index) {
+        threads_.emplace_back(&ThreadPool::run_worker, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread: threads_) {
+        thread.join();
+    }
+}
+
+bool ThreadPool::take_task(std::size_t preferred, Task_t &task) {
+    {
+        auto &own = *queues_[preferred];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+    for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+        auto &victim = *queues_[(preferred + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_worker(std::size_t index) {
+    inside_worker = true;
+    Task_t task;
+    while (true) {
+        if (take_task(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t begin, std::size_t end, const RangeFunction_t &function,
+                              std::size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t size = end - begin;
+
+    // a few chunks per thread, such that stealing can balance uneven chunks
+    const std::size_t chunk_count = std::min((size + grain - 1) / grain, thread_count() * 4);
+    if (inside_worker || chunk_count <= 1) {
+        function(begin, end);
+        return;
+    }
+    const std::size_t chunk_size = (size + chunk_count - 1) / chunk_count;
+
+    std::atomic<std::size_t> remaining{chunk_count};
+    std::mutex done_mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        const std::size_t chunk_begin = begin + chunk * chunk_size;
+        const std::size_t chunk_end = std::min(end, chunk_begin + chunk_size);
+        Task_t task = [&, chunk_begin, chunk_end] {
+            try {
+                if (chunk_begin < chunk_end) {
+                    function(chunk_begin, chunk_end);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            // decrement under the lock, such that the waiting caller cannot return while this still notifies
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        };
+        auto &queue = *queues_[chunk % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+        ++queued_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_.notify_all();
+
+    // help instead of blocking
+    Task_t task;
+    while (remaining > 0 && take_task(0, task)) {
+        task();
+        task = nullptr;
+    }
+    {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+//
+// ===============================
+//  —— shared pool ——
+// ===============================
+//
+
+void set_thread_count(std::size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    std::lock_guard<std::mutex> lock(global_pool_mutex);
+    if (thread_count == global_thread_count) {
+        return;
+    }
+    global_thread_count = thread_count;
+    global_pool = thread_count > 1 ? std::make_shared<ThreadPool>(thread_count) : nullptr;
+}
+
+std::size_t get_thread_count() {
+    std::lock_guard<std::mutex> lock(global_pool_mutex);
+    return global_thread_count;
+}
+
+void parallel_for(std::size_t begin, std::size_t end, const RangeFunction_t &function, std::size_t grain) {
+    ThreadPoolPtr_t pool;
+    {
+        std::lock_guard<std::mutex> lock(global_pool_mutex);
+        pool = global_pool;
+    }
+    if (pool) {
+        pool->parallel_for(begin, end, function, grain);
+    } else if (begin < end) {
+        function(begin, end);
+    }
+}
@@ -0,0 +1,110 @@
+#include "tracing.h"
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    struct TraceEvent {
+        const char *name;
+        std::size_t thread;
+        double start;
+        double duration;
+        std::size_t input_simple_sets;
+        std::size_t output_simple_sets;
+    };
+
+    /**
+     * The state of the running trace. The flag is read without the lock by every span.
+     */
+    struct Tracer {
+        std::atomic<bool> enabled{false};
+        std::mutex mutex;
+        std::ofstream file;
+        std::chrono::steady_clock::time_point origin;
+        std::vector<TraceEvent> events;
+    };
+
+    Tracer &tracer() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    std::size_t thread_number() {
+        static std::atomic<std::size_t> next{1};
+        thread_local std::size_t number = next.fetch_add(1);
+        return number;
+    }
+
+    double microseconds(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+
+    void write_events(std::ofstream &file, const std::vector<TraceEvent> &events) {
+        file << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            auto const &event = events[i];
+            file << (i == 0 ? "\n" : ",\n")
+                 << "{\"name\":\"" << event.name << "\",\"cat\":\"random_events\",\"ph\":\"X\""
+                 << ",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                 << ",\"pid\":1,\"tid\":" << event.thread
+                 << ",\"args\":{\"input_simple_sets\":" << event.input_simple_sets
+                 << ",\"output_simple_sets\":" << event.output_simple_sets << "}}";
+        }
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
+
+void start_tracing(const std::string &path) {
+    stop_tracing();
+    auto &state = tracer();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.file.open(path, std::ios::out | std::ios::trunc);
+    if (!state.file) {
+        throw std::runtime_error("cannot open trace file " + path);
+    }
+    state.file.precision(3);
+    state.file.setf(std::ios::fixed);
+    state.events.clear();
+    state.origin = std::chrono::steady_clock::now();
+    state.enabled.store(true, std::memory_order_release);
+}
+
+void stop_tracing() {
+    auto &state = tracer();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.enabled.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    write_events(state.file, state.events);
+    state.file.close();
+    state.events.clear();
+    state.events.shrink_to_fit();
+}
+
+bool tracing_enabled() {
+    return tracer().enabled.load(std::memory_order_relaxed);
+}
+
+TraceSpan::TraceSpan(const char *name, std::size_t input_simple_sets) :
+        name_(name), active_(tracing_enabled()), input_simple_sets_(input_simple_sets) {
+    if (active_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (!active_) {
+        return;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    auto &state = tracer();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    // spans that end after the trace was stopped are dropped
+    if (!state.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    state.events.push_back({name_, thread_number(), microseconds(start_ - state.origin), microseconds(end - start_),
+                            input_simple_sets_, output_simple_sets_});
+}
@@ -0,0 +1,50 @@
+#include "variable_registry.h"
+#include <stdexcept>
+
+//
+// ===============================
+//  —— VariableRegistry ——
+// ===============================
+//
+
+VariableRegistry::VariableRegistry(const VariableSetPtr_t &variables) {
+    variables_.reserve(variables->size());
+    ids_.reserve(variables->size());
+    for (auto const &variable : *variables) {
+        register_variable(variable);
+    }
+}
+
+std::size_t VariableRegistry::register_variable(const AbstractVariablePtr_t &variable) {
+    auto [it, inserted] = ids_.emplace(*variable->name, variables_.size());
+    if (inserted) {
+        variables_.push_back(variable);
+    }
+    return it->second;
+}
+
+bool VariableRegistry::contains(const AbstractVariablePtr_t &variable) const {
+    return ids_.find(*variable->name) != ids_.end();
+}
+
+std::size_t VariableRegistry::id_of(const AbstractVariablePtr_t &variable) const {
+    auto it = ids_.find(*variable->name);
+    if (it == ids_.end()) {
+        throw std::out_of_range("variable " + *variable->name + " is not registered");
+    }
+    return it->second;
+}
+
+void VariableRegistry::account_memory(MemoryAccountant &accountant, bool owned) const {
+    // the nodes of the index hold the key, the ID, the cached hash and the next pointer
+    std::size_t bytes = sizeof(VariableRegistry) + variables_.capacity() * sizeof(AbstractVariablePtr_t) +
+                        ids_.bucket_count() * sizeof(void *);
+    for (auto const &[name, id]: ids_) {
+        bytes += sizeof(void *) + sizeof(std::pair<const std::string, std::size_t>) + sizeof(std::size_t) +
+                 string_heap_bytes(name);
+    }
+    accountant.add(bytes, owned);
+    for (auto const &variable: variables_) {
+        account_variable(accountant, variable, owned);
+    }
+}
@@ -0,0 +1,140 @@
+#include "workload_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+    NamePtr_t make_name(const char *prefix, std::size_t index) {
+        return std::make_shared<std::string>(prefix + std::to_string(index));
+    }
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig &config) : config_(config), engine_(config.seed) {
+    std::set<long long> universe;
+    for (std::size_t i = 0; i < config_.universe_size; ++i) {
+        universe.insert(static_cast<long long>(i));
+    }
+    all_elements_ = make_shared_all_elements(universe);
+
+    variables_ = make_shared_variable_set();
+    for (std::size_t i = 0; i < config_.continuous_variables; ++i) {
+        variables_->insert(make_shared_continuous(make_name("x", i)));
+    }
+    for (std::size_t i = 0; i < config_.symbolic_variables; ++i) {
+        variables_->insert(make_shared_symbolic(make_name("s", i), all_elements_));
+    }
+    for (std::size_t i = 0; i < config_.integer_variables; ++i) {
+        variables_->insert(make_shared_integer(make_name("i", i)));
+    }
+}
+
+double WorkloadGenerator::uniform(double lower, double upper) {
+    // 53 random bits instead of std::uniform_real_distribution, whose output differs between standard libraries
+    return lower + (upper - lower) * (static_cast<double>(engine_() >> 11) * 0x1.0p-53);
+}
+
+IntervalPtr_t WorkloadGenerator::interval() {
+    return interval(config_.overlap_density, false);
+}
+
+IntervalPtr_t WorkloadGenerator::interval(double probability, bool integral) {
+    // Two intervals of width w with lower bounds uniform in [0, r] intersect with probability 1 - (1 - w / r)^2.
+    // Solve for t = w / r and use r = domain_width - w.
+    probability = std::clamp(probability, 0.0, 1.0);
+    const double t = 1 - std::sqrt(1 - probability);
+    double width = t * config_.domain_width / (1 + t);
+    double lower = uniform(0, config_.domain_width - width);
+    if (integral) {
+        lower = std::floor(lower);
+        width = std::round(width);
+    }
+
+    // the pieces are separated by sorted points inside the hull
+    const std::size_t pieces = std::max<std::size_t>(config_.pieces_per_interval, 1);
+    std::vector<double> points{lower};
+    for (std::size_t i = 0; i + 2 < 2 * pieces; ++i) {
+        points.push_back(integral ? std::round(uniform(lower, lower + width)) : uniform(lower, lower + width));
+    }
+    points.push_back(lower + width);
+    std::sort(points.begin() + 1, points.end() - 1);
+
+    // rounded or equal points can make pieces touch, hence merge them
+    std::vector<std::pair<double, double>> merged;
+    for (std::size_t i = 0; i < points.size(); i += 2) {
+        if (!merged.empty() && points[i] <= merged.back().second) {
+            merged.back().second = std::max(merged.back().second, points[i + 1]);
+        } else {
+            merged.emplace_back(points[i], points[i + 1]);
+        }
+    }
+
+    auto simple_sets = make_shared_simple_set_set();
+    for (auto const &[piece_lower, piece_upper]: merged) {
+        simple_sets->insert(SimpleInterval::make_shared(piece_lower, piece_upper, BorderType::CLOSED,
+                                                        BorderType::CLOSED));
+    }
+    return Interval::make_shared(simple_sets);
+}
+
+SetPtr_t WorkloadGenerator::set() {
+    return set(config_.overlap_density);
+}
+
+SetPtr_t WorkloadGenerator::set(double probability) {
+    const std::size_t universe_size = all_elements_->size();
+    if (universe_size == 0) {
+        return make_shared_set(all_elements_);
+    }
+
+    // Two random subsets of size m are disjoint with probability prod_{i < m} (n - m - i) / (n - i).
+    // Use the smallest m whose probability of intersection is at least the requested one.
+    std::size_t size = 1;
+    for (; size < universe_size; ++size) {
+        double disjoint = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            disjoint *= universe_size < size + i ? 0 : static_cast<double>(universe_size - size - i) /
+                                                       static_cast<double>(universe_size - i);
+        }
+        if (1 - disjoint >= probability) {
+            break;
+        }
+    }
+
+    // partial Fisher-Yates shuffle
+    std::vector<int> indices(universe_size);
+    std::iota(indices.begin(), indices.end(), 0);
+    DynamicBitset elements(universe_size);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::swap(indices[i], indices[i + engine_() % (universe_size - i)]);
+        elements.set(static_cast<std::size_t>(indices[i]));
+    }
+    return make_shared_set(std::move(elements), all_elements_);
+}
+
+SimpleEventPtr_t WorkloadGenerator::simple_event() {
+    // the axes are independent, hence every axis intersects with the d-th root of the probability
+    const double probability = variables_->empty() ? 1.0 :
+            std::pow(std::clamp(config_.overlap_density, 0.0, 1.0), 1.0 / static_cast<double>(variables_->size()));
+
+    auto variable_map = std::make_shared<VariableMap>();
+    for (auto const &variable: *variables_) {
+        AbstractCompositeSetPtr_t assignment;
+        if (dynamic_cast<Symbolic *>(variable.get())) {
+            assignment = set(probability);
+        } else {
+            assignment = interval(probability, dynamic_cast<Integer *>(variable.get()) != nullptr);
+        }
+        variable_map->insert({variable, assignment});
+    }
+    return make_shared_simple_event(variable_map);
+}
+
+EventPtr_t WorkloadGenerator::event() {
+    auto result = make_shared_event();
+    for (std::size_t i = 0; i < config_.event_count; ++i) {
+        result->simple_sets->insert(simple_event());
+    }
+    return result;
+}
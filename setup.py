@@ -8,7 +8,23 @@ ext_modules = [
             "export/bindings.cpp",
             "random_events_lib/src/sigma_algebra.cpp",
             "random_events_lib/src/set.cpp",
-            "random_events_lib/src/product_algebra.cpp"
+            "random_events_lib/src/product_algebra.cpp",
+            "random_events_lib/src/interval.cpp",
+            "random_events_lib/src/flat_interval.cpp",
+            "random_events_lib/src/variable_registry.cpp",
+            "random_events_lib/src/dense_product_algebra.cpp",
+            "random_events_lib/src/signature_simplification.cpp",
+            "random_events_lib/src/sweep_and_prune.cpp",
+            "random_events_lib/src/thread_pool.cpp",
+            "random_events_lib/src/arena.cpp",
+            "random_events_lib/src/intern_table.cpp",
+            "random_events_lib/src/operation_cache.cpp",
+            "random_events_lib/src/workload_generator.cpp",
+            "random_events_lib/src/operation_statistics.cpp",
+            "random_events_lib/src/tracing.cpp",
+            "random_events_lib/src/event_builder.cpp",
+            "random_events_lib/src/compiled_event.cpp",
+            "random_events_lib/src/event_index.cpp"
          ],
         include_dirs=["random_events_lib/include"],
         extra_compile_args=["-std=c++17", "-fPIC"],
@@ -19,5 +35,6 @@ setup(
     name="random_events_lib",
     version="0.0.1",
     ext_modules=ext_modules,
+    install_requires=["numpy"],
     zip_safe=False,
 )
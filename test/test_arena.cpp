@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "arena.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "set.h"
+#include "variable.h"
+
+TEST(OperationArena, ScopesAndOwnership) {
+    EXPECT_EQ(OperationArena::current(), nullptr);
+
+    const auto alive = OperationArena::alive();
+    std::shared_ptr<SimpleInterval> escaped;
+    {
+        OperationScope outer;
+        EXPECT_TRUE(outer.is_outermost());
+        auto arena = OperationArena::current();
+        ASSERT_NE(arena, nullptr);
+        {
+            OperationScope inner;
+            EXPECT_FALSE(inner.is_outermost());
+            EXPECT_EQ(OperationArena::current(), arena);
+        }
+        escaped = SimpleInterval::make_shared(0, 1, BorderType::OPEN, BorderType::CLOSED);
+        EXPECT_GE(arena->allocated_bytes(), sizeof(SimpleInterval));
+    }
+    EXPECT_EQ(OperationArena::current(), nullptr);
+
+    // objects in the arena keep it alive
+    EXPECT_EQ(OperationArena::alive(), alive + 1);
+    EXPECT_EQ(escaped->upper, 1);
+    escaped.reset();
+    EXPECT_EQ(OperationArena::alive(), alive);
+}
+
+TEST(OperationArena, PromotedResults) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto event = make_shared_event();
+    for (int i = 0; i < 20; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed_open(i, i + 2.5)});
+        variable_map->insert({y, closed_open(i % 5, i % 5 + 3)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    set_arenas_enabled(false);
+    auto without_arena = event->make_disjoint();
+    auto complement_without_arena = event->complement();
+    set_arenas_enabled(true);
+
+    const auto alive = OperationArena::alive();
+    {
+        // inside an outer scope the result is not promoted and allocated in the arena
+        OperationScope scope;
+        auto nested = event->make_disjoint();
+        EXPECT_GT(OperationArena::current()->allocated_bytes(), 0);
+        EXPECT_EQ(*nested, *without_arena);
+    }
+    EXPECT_EQ(OperationArena::alive(), alive);
+
+    // the outermost operation promotes its result, the arena is gone afterwards
+    auto with_arena = event->make_disjoint();
+    EXPECT_EQ(OperationArena::current(), nullptr);
+    EXPECT_EQ(OperationArena::alive(), alive);
+    EXPECT_EQ(*with_arena, *without_arena);
+    EXPECT_EQ(*event->complement(), *complement_without_arena);
+}
+
+TEST(OperationArena, PromotionSharesHeapParts) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto event = make_shared_event();
+    for (int i = 0; i < 8; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed_open(i, i + 1)});
+        variable_map->insert({y, closed_open(i, i + 1)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    // the simple events are disjoint already, hence the new simple events of the result share their assignments
+    const auto alive = OperationArena::alive();
+    auto disjoint = event->make_disjoint();
+    EXPECT_EQ(OperationArena::alive(), alive);
+    ASSERT_EQ(*disjoint, *event);
+    std::set<AbstractCompositeSetPtr_t> assignments;
+    for (auto const &simple_set: *event->simple_sets) {
+        for (auto const &[variable, assignment]: *static_cast<SimpleEvent *>(simple_set.get())->variable_map) {
+            assignments.insert(assignment);
+        }
+    }
+    for (auto const &simple_set: *disjoint->simple_sets) {
+        for (auto const &[variable, assignment]: *static_cast<SimpleEvent *>(simple_set.get())->variable_map) {
+            EXPECT_EQ(assignments.count(assignment), 1);
+        }
+    }
+
+    // parts that were created in the arena are copied
+    OperationScope scope;
+    const auto &arena = *OperationArena::current();
+    auto in_arena = closed(0, 1);
+    ASSERT_TRUE(arena.owns(in_arena.get()));
+    ArenaSuspension suspension;
+    auto promoted = in_arena->promote(arena);
+    EXPECT_NE(promoted, in_arena);
+    EXPECT_FALSE(arena.owns(promoted.get()));
+    EXPECT_FALSE(arena.owns(promoted->simple_sets->begin()->get()));
+    EXPECT_EQ(*promoted, *in_arena);
+    EXPECT_EQ(promoted->promote(arena), promoted);
+}
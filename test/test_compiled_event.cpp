@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "compiled_event.h"
+#include "thread_pool.h"
+#include "workload_generator.h"
+#include <cmath>
+#include <random>
+
+namespace {
+    /**
+     * Check a row by iterating the simple events of an event.
+     */
+    bool reference_contains(const Event &event, const VariableRegistry &registry, const std::vector<double> &row) {
+        for (const auto &simple_set: *event.simple_sets) {
+            if (static_cast<SimpleEvent *>(simple_set.get())->variable_map->empty()) {
+                continue;
+            }
+            bool contained = true;
+            for (const auto &[variable, assignment]: *static_cast<SimpleEvent *>(simple_set.get())->variable_map) {
+                const double value = row[registry.id_of(variable)];
+                if (const auto set = dynamic_cast<Set *>(assignment.get())) {
+                    contained = set->to_bitset().test(static_cast<std::size_t>(value));
+                } else {
+                    contained = static_cast<Interval *>(assignment.get())->contains(value);
+                }
+                if (!contained) {
+                    break;
+                }
+            }
+            if (contained) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TEST(CompiledEvent, AgreesWithEvent) {
+    WorkloadConfig config;
+    config.seed = 5;
+    config.continuous_variables = 2;
+    config.symbolic_variables = 1;
+    config.integer_variables = 1;
+    config.pieces_per_interval = 2;
+    config.overlap_density = 0.1;
+    config.event_count = 64;
+    config.domain_width = 20;
+    WorkloadGenerator generator(config);
+    auto event = generator.event();
+
+    CompiledEvent compiled(*event);
+    const auto &registry = *compiled.registry();
+    ASSERT_EQ(registry.size(), 4);
+    EXPECT_GT(compiled.node_count(), 0);
+    EXPECT_LE(compiled.depth(), COMPILED_EVENT_MAX_DEPTH);
+
+    // integral values hit the borders of the integer intervals
+    std::mt19937_64 engine(1);
+    std::uniform_real_distribution<double> uniform(-1, 21);
+    const std::size_t rows = 5000;
+    std::vector<std::vector<double>> columns(registry.size(), std::vector<double>(rows));
+    std::size_t contained = 0;
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::vector<double> values(registry.size());
+        for (std::size_t id = 0; id < registry.size(); ++id) {
+            const auto &variable = registry.variable(id);
+            if (dynamic_cast<Symbolic *>(variable.get())) {
+                values[id] = static_cast<double>(engine() % config.universe_size);
+            } else if (dynamic_cast<Integer *>(variable.get())) {
+                values[id] = std::round(uniform(engine));
+            } else {
+                values[id] = uniform(engine);
+            }
+            columns[id][row] = values[id];
+        }
+        const bool expected = reference_contains(*event, registry, values);
+        contained += expected;
+        ASSERT_EQ(compiled.contains(values.data()), expected) << "row " << row;
+    }
+    EXPECT_GT(contained, 0);
+
+    std::vector<const double *> column_pointers;
+    for (const auto &column: columns) {
+        column_pointers.push_back(column.data());
+    }
+    std::vector<std::uint8_t> mask(rows);
+    set_thread_count(2);
+    compiled.contains(column_pointers.data(), rows, mask.data());
+    set_thread_count(1);
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::vector<double> values;
+        for (const auto &column: columns) {
+            values.push_back(column[row]);
+        }
+        EXPECT_EQ(mask[row], compiled.contains(values.data()));
+    }
+}
+
+TEST(CompiledEvent, Borders) {
+    auto x = make_shared_continuous("x");
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, open_closed(0, 1)->union_with(closed_open(2, 3))});
+    Event event(make_shared_simple_event(variable_map));
+    CompiledEvent compiled(event);
+
+    for (const auto &[value, expected]: std::vector<std::pair<double, bool>>{
+            {0, false}, {0.5, true}, {1, true}, {1.5, false}, {2, true}, {3, false}, {NAN, false}}) {
+        EXPECT_EQ(compiled.contains(&value), expected) << value;
+    }
+
+    CompiledEvent empty(Event{});
+    EXPECT_EQ(empty.registry()->size(), 0);
+    EXPECT_FALSE(empty.contains(nullptr));
+}
+
+TEST(CompiledEvent, SimpleEventsWithoutVariables) {
+    auto x = make_shared_continuous("x");
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, closed(0, 1)});
+    Event event(make_shared_simple_event(variable_map));
+    event.simple_sets->insert(make_shared_simple_event());
+    CompiledEvent compiled(event);
+
+    for (const auto &[value, expected]: std::vector<std::pair<double, bool>>{{0.5, true}, {2, false}}) {
+        EXPECT_EQ(compiled.contains(&value), expected) << value;
+    }
+
+    // the simple event without variables is empty and contains no row
+    CompiledEvent empty(Event{make_shared_simple_event()});
+    EXPECT_EQ(empty.registry()->size(), 0);
+    EXPECT_FALSE(empty.contains(nullptr));
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "operation_cache.h"
+#include "thread_pool.h"
+#include "workload_generator.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * Run the same operations on shared operands from several threads, as the Python bindings do without the GIL.
+     */
+    class ConcurrencyTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            set_operation_cache_capacity(32);
+            set_thread_count(2);
+        }
+
+        void TearDown() override {
+            set_operation_cache_capacity(0);
+            set_thread_count(1);
+        }
+    };
+}
+
+TEST_F(ConcurrencyTest, SharedOperands) {
+    WorkloadConfig config;
+    config.seed = 7;
+    config.continuous_variables = 2;
+    config.symbolic_variables = 1;
+    config.event_count = 4;
+    WorkloadGenerator generator(config);
+    const AbstractCompositeSetPtr_t lhs = generator.event();
+    const AbstractCompositeSetPtr_t rhs = generator.event();
+    auto marginal_variables = make_shared_variable_set();
+    marginal_variables->insert(*generator.variables()->begin());
+
+    const auto expected_union = lhs->union_with(rhs);
+    const auto expected_difference = lhs->difference_with(rhs);
+    const auto expected_complement = lhs->complement();
+    const auto expected_simplified = expected_union->simplify();
+    const auto expected_marginal = std::static_pointer_cast<Event>(lhs)->marginal(marginal_variables);
+
+    std::atomic<std::size_t> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 8; ++thread) {
+        threads.emplace_back([&] {
+            for (int round = 0; round < 5; ++round) {
+                auto union_ = lhs->union_with(rhs);
+                mismatches += *union_ != *expected_union;
+                mismatches += *lhs->difference_with(rhs) != *expected_difference;
+                mismatches += *lhs->complement() != *expected_complement;
+                mismatches += *union_->simplify() != *expected_simplified;
+                mismatches += *std::static_pointer_cast<Event>(lhs)->marginal(marginal_variables) !=
+                              *expected_marginal;
+                mismatches += union_->hash() != expected_union->hash();
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches, 0);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "dense_product_algebra.h"
+#include "interval.h"
+#include "set.h"
+#include "variable.h"
+#include <memory>
+#include <stdexcept>
+
+static auto dense_all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2});
+
+static VariableMapPtr_t box(const SymbolicPtr_t &a, const SetPtr_t &a_value,
+                            const ContinuousPtr_t &x, const IntervalPtr_t &x_value) {
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({a, a_value});
+    variable_map->insert({x, x_value});
+    return variable_map;
+}
+
+TEST(VariableRegistry, RegisterAndLookup) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto another_x = make_shared_integer("x");
+
+    auto variables = make_shared_variable_set();
+    variables->insert(y);
+    variables->insert(x);
+
+    // registered in name order
+    auto registry = make_shared_variable_registry(variables);
+    EXPECT_EQ(registry->size(), 2);
+    EXPECT_EQ(registry->id_of(x), 0);
+    EXPECT_EQ(registry->id_of(y), 1);
+
+    // variables with the same name share their ID
+    EXPECT_TRUE(registry->contains(another_x));
+    EXPECT_EQ(registry->register_variable(another_x), 0);
+    EXPECT_EQ(registry->variable(0), x);
+
+    auto z = make_shared_continuous("z");
+    EXPECT_FALSE(registry->contains(z));
+    EXPECT_THROW(registry->id_of(z), std::out_of_range);
+    EXPECT_EQ(registry->register_variable(z), 2);
+    EXPECT_EQ(registry->variables().size(), 3);
+}
+
+TEST(DenseSimpleEvent, Conversion) {
+    auto a = make_shared_symbolic(std::make_shared<std::string>("a"), dense_all_elements);
+    auto x = make_shared_continuous("x");
+    auto variable_map = box(a, make_shared_set(make_shared_set_element(0, dense_all_elements), dense_all_elements),
+                            x, closed(0, 1));
+    auto simple_event = make_shared_simple_event(variable_map);
+
+    auto registry = make_shared_variable_registry();
+    auto dense = DenseSimpleEvent(registry, *simple_event);
+    EXPECT_EQ(registry->size(), 2);
+    EXPECT_EQ(dense.assignments.size(), 2);
+    EXPECT_TRUE(*dense.to_simple_event() == *simple_event);
+
+    // variables registered later are assigned to their domain
+    auto y = make_shared_continuous("y");
+    auto y_id = registry->register_variable(y);
+    EXPECT_TRUE(*dense.assignment(y_id) == *y->get_domain());
+    EXPECT_EQ(dense.to_simple_event()->variable_map->size(), 3);
+}
+
+TEST(DenseSimpleEvent, HashIgnoresRegistryGrowth) {
+    auto x = make_shared_continuous("x");
+    auto registry = make_shared_variable_registry();
+    registry->register_variable(x);
+    auto dense = make_shared_dense_simple_event(registry, Assignments_t{closed(0, 1)});
+    auto hash = dense->hash();
+
+    // a later variable adds a slot that is assigned to its domain, which is equal to the event without the slot
+    auto y = make_shared_continuous("y");
+    auto y_id = registry->register_variable(y);
+    EXPECT_EQ(dense->hash(), hash);
+    auto with_slot = make_shared_dense_simple_event(registry, Assignments_t{closed(0, 1), y->get_domain()});
+    ASSERT_TRUE(*with_slot == *dense);
+    EXPECT_EQ(with_slot->hash(), hash);
+
+    with_slot->assignments[y_id] = closed(0, 1);
+    EXPECT_NE(with_slot->hash(), hash);
+}
+
+TEST(DenseSimpleEvent, MatchesSimpleEvent) {
+    auto a = make_shared_symbolic(std::make_shared<std::string>("a"), dense_all_elements);
+    auto x = make_shared_continuous("x");
+    auto a_01 = make_shared_set(make_shared_set_element(0, dense_all_elements), dense_all_elements);
+    a_01->simple_sets->insert(make_shared_set_element(1, dense_all_elements));
+    auto a_12 = make_shared_set(make_shared_set_element(1, dense_all_elements), dense_all_elements);
+    a_12->simple_sets->insert(make_shared_set_element(2, dense_all_elements));
+
+    auto map1 = box(a, a_01, x, closed(0, 2));
+    auto map2 = box(a, a_12, x, open(1, 3));
+    auto event1 = make_shared_simple_event(map1);
+    auto event2 = make_shared_simple_event(map2);
+
+    auto variables = event1->get_variables();
+    auto registry = make_shared_variable_registry(variables);
+    auto dense1 = make_shared_dense_simple_event(registry, *event1);
+    auto dense2 = make_shared_dense_simple_event(registry, *event2);
+
+    auto intersection = std::static_pointer_cast<DenseSimpleEvent>(dense1->intersection_with(dense2));
+    EXPECT_TRUE(*intersection->to_simple_event() == *event1->intersection_with(event2));
+
+    auto complement = dense1->complement();
+    auto expected_complement = event1->complement();
+    ASSERT_EQ(complement->size(), expected_complement->size());
+    auto it = expected_complement->begin();
+    for (auto const &dense_complement : *complement) {
+        EXPECT_TRUE(*static_cast<DenseSimpleEvent *>(dense_complement.get())->to_simple_event() == **it);
+        ++it;
+    }
+
+    EXPECT_EQ(*dense1 < *dense2, *event1 < *event2);
+    EXPECT_EQ(*dense2 < *dense1, *event2 < *event1);
+    EXPECT_FALSE(*dense1 == *dense2);
+}
+
+TEST(DenseEvent, SimplifyAndMakeDisjoint) {
+    auto a = make_shared_symbolic(std::make_shared<std::string>("a"), dense_all_elements);
+    auto x = make_shared_continuous("x");
+    auto a_0 = make_shared_set(make_shared_set_element(0, dense_all_elements), dense_all_elements);
+    auto a_1 = make_shared_set(make_shared_set_element(1, dense_all_elements), dense_all_elements);
+
+    auto event = make_shared_event();
+    auto map1 = box(a, a_0, x, closed(0, 1));
+    auto map2 = box(a, a_1, x, closed(0, 1));
+    auto map3 = box(a, a_1, x, closed(0.5, 2));
+    event->simple_sets->insert(make_shared_simple_event(map1));
+    event->simple_sets->insert(make_shared_simple_event(map2));
+    event->simple_sets->insert(make_shared_simple_event(map3));
+
+    auto registry = make_shared_variable_registry();
+    auto dense = make_shared_dense_event(registry, *event);
+    auto disjoint = dense->make_disjoint();
+    EXPECT_TRUE(disjoint->is_disjoint());
+
+    auto expected = event->make_disjoint();
+    auto converted = std::static_pointer_cast<DenseEvent>(disjoint)->to_event();
+    EXPECT_TRUE(*converted == *expected);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "event_builder.h"
+#include <stdexcept>
+
+namespace {
+    SymbolicPtr_t make_color() {
+        auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2});
+        return make_shared_symbolic(std::make_shared<std::string>("color"), all_elements);
+    }
+}
+
+TEST(EventBuilder, Build) {
+    auto x = make_shared_continuous("x");
+    auto color = make_color();
+    const double lowers[] = {0, 2, 5};
+    const double uppers[] = {1, 3, 4};
+    const long long colors[] = {0, 2, 1};
+
+    // columns are sorted by variable, independent of the order of adding them
+    EventBuilder builder(3);
+    builder.add_set_column(color, colors);
+    builder.add_interval_column(x, lowers, uppers);
+    auto event = builder.build();
+
+    // the third row is empty
+    ASSERT_EQ(event->simple_sets->size(), 2);
+
+    auto expected = make_shared_event();
+    for (int row = 0; row < 2; ++row) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed(lowers[row], uppers[row])});
+        variable_map->insert({color, make_shared_set(make_shared_set_element(static_cast<int>(colors[row]),
+                                                                             color->domain->all_elements),
+                                                     color->domain->all_elements)});
+        expected->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+    EXPECT_TRUE(*event == *expected);
+
+    // the universe of the domain is shared
+    auto first = std::static_pointer_cast<SimpleEvent>(*event->simple_sets->begin());
+    auto set = std::static_pointer_cast<Set>(first->variable_map->at(color));
+    EXPECT_EQ(set->all_elements, color->domain->all_elements);
+}
+
+TEST(EventBuilder, Borders) {
+    auto x = make_shared_continuous("x");
+    const double lowers[] = {0, 1};
+    const double uppers[] = {1, 2};
+    const std::uint8_t left_closed[] = {1, 0};
+    const std::uint8_t right_closed[] = {0, 1};
+    EventBuilder builder(2);
+    builder.add_interval_column(x, lowers, uppers, left_closed, right_closed);
+    auto event = builder.build();
+
+    auto expected = make_shared_event();
+    for (const auto &interval: {closed_open(0, 1), open_closed(1, 2)}) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, interval});
+        expected->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+    EXPECT_TRUE(*event == *expected);
+}
+
+TEST(EventBuilder, Errors) {
+    auto x = make_shared_continuous("x");
+    auto color = make_color();
+    const double bounds[] = {0};
+    const long long out_of_range[] = {3};
+
+    EventBuilder builder(1);
+    builder.add_interval_column(x, bounds, bounds);
+    EXPECT_THROW(builder.add_interval_column(x, bounds, bounds), std::invalid_argument);
+    EXPECT_THROW(builder.add_interval_column(color, bounds, bounds), std::invalid_argument);
+    EXPECT_THROW(builder.add_set_column(x, out_of_range), std::invalid_argument);
+    builder.add_set_column(color, out_of_range);
+    EXPECT_THROW(builder.build(), std::invalid_argument);
+}
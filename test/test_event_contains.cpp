@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "compiled_event.h"
+#include "thread_pool.h"
+#include "workload_generator.h"
+#include <cmath>
+#include <random>
+
+TEST(EventContains, AgreesWithCompiledEvent) {
+    WorkloadConfig config;
+    config.seed = 11;
+    config.continuous_variables = 2;
+    config.symbolic_variables = 1;
+    config.integer_variables = 1;
+    config.pieces_per_interval = 2;
+    config.overlap_density = 0.3;
+    config.event_count = 48;
+    config.domain_width = 20;
+    WorkloadGenerator generator(config);
+    auto event = generator.event();
+
+    CompiledEvent compiled(*event);
+    const auto &registry = *compiled.registry();
+
+    // an odd row count covers a partial last word
+    std::mt19937_64 engine(3);
+    std::uniform_real_distribution<double> uniform(-1, 21);
+    const std::size_t rows = 9001;
+    std::vector<std::vector<double>> values(registry.size(), std::vector<double>(rows));
+    std::vector<std::vector<long long>> indices(registry.size(), std::vector<long long>(rows));
+    std::vector<PointColumn> columns(registry.size());
+    for (std::size_t id = 0; id < registry.size(); ++id) {
+        const auto &variable = registry.variable(id);
+        for (std::size_t row = 0; row < rows; ++row) {
+            if (dynamic_cast<Symbolic *>(variable.get())) {
+                indices[id][row] = static_cast<long long>(engine() % config.universe_size);
+                values[id][row] = static_cast<double>(indices[id][row]);
+            } else if (dynamic_cast<Integer *>(variable.get())) {
+                values[id][row] = std::round(uniform(engine));
+            } else {
+                values[id][row] = uniform(engine);
+            }
+        }
+        if (dynamic_cast<Symbolic *>(variable.get())) {
+            columns[id].indices = indices[id].data();
+        } else {
+            columns[id].values = values[id].data();
+        }
+    }
+
+    std::vector<std::uint8_t> mask(rows);
+    event->contains(registry, columns.data(), rows, mask.data());
+    std::vector<std::uint8_t> parallel_mask(rows);
+    set_thread_count(2);
+    event->contains(registry, columns.data(), rows, parallel_mask.data());
+    set_thread_count(1);
+
+    std::size_t contained = 0;
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::vector<double> row_values;
+        for (const auto &column: values) {
+            row_values.push_back(column[row]);
+        }
+        ASSERT_EQ(mask[row], compiled.contains(row_values.data())) << "row " << row;
+        ASSERT_EQ(parallel_mask[row], mask[row]) << "row " << row;
+        contained += mask[row];
+    }
+    EXPECT_GT(contained, 0);
+    EXPECT_LT(contained, rows);
+}
+
+TEST(EventContains, BordersAndErrors) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2});
+    auto color = make_shared_symbolic("color", make_shared_set(all_elements));
+
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, open_closed(0, 1)->union_with(closed_open(2, 3))});
+    variable_map->insert({color, make_shared_set(make_shared_set_element(1, all_elements), all_elements)});
+    Event event(make_shared_simple_event(variable_map));
+
+    // y is not assigned by the simple event, hence unconstrained
+    auto variables = make_shared_variable_set();
+    variables->insert({x, y, color});
+    VariableRegistry registry(variables);
+
+    const std::vector<double> xs{0, 0.5, 1, 1.5, 2, 3, NAN, 0.5};
+    const std::vector<double> ys{7, 7, 7, 7, 7, 7, 7, 7};
+    const std::vector<long long> colors{1, 1, 1, 1, 1, 1, 1, 5};
+    std::vector<PointColumn> columns(3);
+    columns[registry.id_of(x)].values = xs.data();
+    columns[registry.id_of(y)].values = ys.data();
+    columns[registry.id_of(color)].indices = colors.data();
+
+    std::vector<std::uint8_t> mask(xs.size());
+    event.contains(registry, columns.data(), xs.size(), mask.data());
+    EXPECT_EQ(mask, (std::vector<std::uint8_t>{0, 1, 1, 0, 1, 0, 0, 0}));
+
+    // symbolic variables need indices
+    columns[registry.id_of(color)] = PointColumn{xs.data(), nullptr};
+    EXPECT_THROW(event.contains(registry, columns.data(), xs.size(), mask.data()), std::invalid_argument);
+
+    // every variable of the event needs a column
+    VariableRegistry partial(make_shared_variable_set(VariableSet{x}));
+    EXPECT_THROW(event.contains(partial, columns.data(), xs.size(), mask.data()), std::invalid_argument);
+
+    Event empty;
+    empty.contains(registry, columns.data(), xs.size(), mask.data());
+    EXPECT_EQ(std::count(mask.begin(), mask.end(), 1), 0);
+}
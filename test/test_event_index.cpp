@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "event_index.h"
+#include "workload_generator.h"
+
+namespace {
+    /**
+     * Check every simple event against a partial assignment by intersecting the assignments.
+     */
+    DynamicBitset reference_compatible(const EventIndex &index, const SimpleEvent &partial_assignment) {
+        DynamicBitset result(index.size());
+        for (std::size_t position = 0; position < index.size(); ++position) {
+            const auto &simple_event = *index.simple_events()[position];
+            bool compatible = !simple_event.variable_map->empty();
+            for (const auto &[variable, assignment]: *simple_event.variable_map) {
+                compatible &= !assignment->is_empty();
+            }
+            for (const auto &[variable, assignment]: *partial_assignment.variable_map) {
+                // an empty assignment is compatible with nothing, even where the simple event is unconstrained
+                compatible &= !assignment->is_empty();
+                const auto own = simple_event.variable_map->find(variable);
+                if (own != simple_event.variable_map->end()) {
+                    compatible &= !own->second->intersection_with(assignment)->is_empty();
+                }
+            }
+            if (compatible) {
+                result.set(position);
+            }
+        }
+        return result;
+    }
+}
+
+TEST(EventIndex, AgreesWithIntersection) {
+    WorkloadConfig config;
+    config.seed = 17;
+    config.continuous_variables = 2;
+    config.symbolic_variables = 2;
+    config.integer_variables = 1;
+    config.pieces_per_interval = 3;
+    config.overlap_density = 0.2;
+    config.event_count = 300;
+    WorkloadGenerator generator(config);
+    auto event = std::static_pointer_cast<Event>(generator.event());
+    EventIndex index(*event);
+    ASSERT_EQ(index.size(), event->simple_sets->size());
+    ASSERT_EQ(index.registry()->size(), 5);
+
+    std::size_t matches = 0;
+    for (int query = 0; query < 50; ++query) {
+        // drop a variable to get a partial assignment
+        auto partial_assignment = generator.simple_event();
+        const auto dropped = index.registry()->variable(query % index.registry()->size());
+        partial_assignment->variable_map->erase(dropped);
+
+        const auto compatible = index.compatible(*partial_assignment);
+        ASSERT_EQ(compatible, reference_compatible(index, *partial_assignment)) << "query " << query;
+        matches += compatible.count();
+
+        const auto selected = index.select(compatible);
+        EXPECT_EQ(selected->simple_sets->size(), compatible.count());
+    }
+    EXPECT_GT(matches, 0);
+    EXPECT_LT(matches, 50 * index.size());
+
+    // an empty partial assignment is compatible with every non-empty simple event
+    EXPECT_EQ(index.compatible(SimpleEvent()).count(), index.size());
+}
+
+TEST(EventIndex, Queries) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2});
+    auto color = make_shared_symbolic("color", make_shared_set(all_elements));
+
+    auto first = std::make_shared<VariableMap>();
+    first->insert({x, closed_open(0, 1)});
+    first->insert({color, make_shared_set(make_shared_set_element(0, all_elements), all_elements)});
+    auto second = std::make_shared<VariableMap>();
+    second->insert({x, closed(1, 2)->union_with(closed(5, 6))});
+    second->insert({y, closed(0, 1)});
+    auto event = make_shared_event();
+    event->simple_sets->insert(make_shared_simple_event(first));
+    event->simple_sets->insert(make_shared_simple_event(second));
+    EventIndex index(*event);
+    const auto &simple_events = index.simple_events();
+    const auto position_of_first = simple_events[0]->variable_map->count(color) ? 0 : 1;
+
+    auto positions = [](const DynamicBitset &bits) {
+        std::vector<std::size_t> result;
+        bits.for_each_set_bit([&result](const std::size_t position) { result.push_back(position); });
+        return result;
+    };
+    const std::vector<std::size_t> none, only_first{std::size_t(position_of_first)},
+            only_second{std::size_t(1 - position_of_first)}, both{0, 1};
+
+    // [0, 1) and [1, 2] touch without a common value
+    EXPECT_EQ(positions(index.matching(x, *closed(1, 1))), only_second);
+    EXPECT_EQ(positions(index.matching(x, *closed(0.5, 1))), both);
+    EXPECT_EQ(positions(index.matching(x, *open(2, 5))), none);
+    EXPECT_EQ(positions(index.matching(x, *closed(5.5, 7))), only_second);
+
+    // the second simple event does not assign color and the first does not assign y
+    EXPECT_EQ(positions(index.matching(color, 0)), both);
+    EXPECT_EQ(positions(index.matching(color, 2)), only_second);
+    EXPECT_EQ(positions(index.matching(y, *closed(3, 4))), only_first);
+    EXPECT_EQ(positions(index.matching(make_shared_continuous("z"), *closed(3, 4))), both);
+
+    EXPECT_THROW(index.matching(x, 0), std::invalid_argument);
+    EXPECT_THROW(index.matching(color, *closed(0, 1)), std::invalid_argument);
+
+    auto partial_assignment = std::make_shared<VariableMap>();
+    partial_assignment->insert({x, closed(0.5, 5.5)});
+    partial_assignment->insert({color, make_shared_set(make_shared_set_element(2, all_elements), all_elements)});
+    EXPECT_EQ(positions(index.compatible(SimpleEvent(partial_assignment))), only_second);
+    const auto selected = index.select(index.compatible(SimpleEvent(partial_assignment)));
+    ASSERT_EQ(selected->simple_sets->size(), 1);
+    EXPECT_EQ(*selected->simple_sets->begin(), simple_events[1 - position_of_first]);
+}
+
+TEST(EventIndex, EmptyPartialAssignment) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto first = std::make_shared<VariableMap>();
+    first->insert({x, closed(0, 2)});
+    auto second = std::make_shared<VariableMap>();
+    second->insert({y, closed(0, 2)});
+    auto event = make_shared_event();
+    event->simple_sets->insert(make_shared_simple_event(first));
+    event->simple_sets->insert(make_shared_simple_event(second));
+    EventIndex index(*event);
+
+    // the simple event that does not assign x is not compatible with an empty x either
+    auto partial_assignment = std::make_shared<VariableMap>();
+    partial_assignment->insert({x, empty()});
+    const SimpleEvent empty_x(partial_assignment);
+    EXPECT_EQ(index.compatible(empty_x).count(), 0);
+    EXPECT_EQ(index.compatible(empty_x), reference_compatible(index, empty_x));
+
+    // the same holds for a variable that no simple event assigns
+    auto unknown = std::make_shared<VariableMap>();
+    unknown->insert({make_shared_continuous("z"), empty()});
+    EXPECT_EQ(index.compatible(SimpleEvent(unknown)).count(), 0);
+}
@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+#include "flat_interval.h"
+#include "interval.h"
+#include <limits>
+
+
+TEST(FlatIntervalConstruction, FlatInterval) {
+    auto flat = FlatInterval({2.0, 0.0, 0.5, 4.0, 3.0},
+                             {3.0, 1.0, 1.5, 4.0, 3.0},
+                             {LEFT_CLOSED_BIT, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT, 0, 0, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT});
+
+    // [0, 1.5) u [2, 3]; (4, 4) is empty and [3, 3] is swallowed by [2, 3)
+    ASSERT_EQ(flat.size(), 2);
+    EXPECT_EQ(flat.lowers()[0], 0.0);
+    EXPECT_EQ(flat.uppers()[0], 1.5);
+    EXPECT_EQ(flat.left(0), BorderType::CLOSED);
+    EXPECT_EQ(flat.right(0), BorderType::OPEN);
+    EXPECT_EQ(flat.lowers()[1], 2.0);
+    EXPECT_EQ(flat.uppers()[1], 3.0);
+    EXPECT_EQ(flat.right(1), BorderType::CLOSED);
+}
+
+TEST(FlatIntervalTouchingPieces, FlatInterval) {
+    // (0, 1) u (1, 2) does not contain 1 and hence cannot be merged
+    auto open_pieces = FlatInterval({0.0, 1.0}, {1.0, 2.0}, {0, 0});
+    EXPECT_EQ(open_pieces.size(), 2);
+    EXPECT_FALSE(open_pieces.contains(1.0));
+
+    // (0, 1] u (1, 2) is (0, 2)
+    auto touching = FlatInterval({0.0, 1.0}, {1.0, 2.0}, {RIGHT_CLOSED_BIT, 0});
+    EXPECT_EQ(touching, FlatInterval::open(0, 2));
+}
+
+TEST(FlatIntervalContains, FlatInterval) {
+    auto flat = FlatInterval({0.0, 2.0, 5.0}, {1.0, 3.0, 5.0},
+                             {RIGHT_CLOSED_BIT, LEFT_CLOSED_BIT, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT});
+    EXPECT_FALSE(flat.contains(-1.0));
+    EXPECT_FALSE(flat.contains(0.0));
+    EXPECT_TRUE(flat.contains(0.5));
+    EXPECT_TRUE(flat.contains(1.0));
+    EXPECT_FALSE(flat.contains(1.5));
+    EXPECT_TRUE(flat.contains(2.0));
+    EXPECT_FALSE(flat.contains(3.0));
+    EXPECT_TRUE(flat.contains(5.0));
+    EXPECT_FALSE(flat.contains(6.0));
+}
+
+TEST(FlatIntervalConversion, FlatInterval) {
+    auto interval1 = SimpleInterval::make_shared(0.0, 1.0, BorderType::CLOSED, BorderType::CLOSED);
+    auto interval2 = SimpleInterval::make_shared(0.5, 1.5, BorderType::CLOSED, BorderType::OPEN);
+    auto interval3 = SimpleInterval::make_shared(2.0, 3.0, BorderType::OPEN, BorderType::CLOSED);
+    auto intervals = make_shared_simple_set_set();
+    intervals->insert(interval1);
+    intervals->insert(interval2);
+    intervals->insert(interval3);
+    auto interval = Interval::make_shared(intervals);
+
+    auto flat = FlatInterval(*interval);
+    EXPECT_EQ(flat.size(), 2);
+    EXPECT_TRUE(flat.simple_interval(0) == SimpleInterval(0.0, 1.5, BorderType::CLOSED, BorderType::OPEN));
+
+    auto converted = flat.to_interval();
+    EXPECT_EQ(converted->simple_sets->size(), 2);
+    EXPECT_TRUE(converted->is_disjoint());
+    EXPECT_EQ(FlatInterval(*converted), flat);
+}
+
+TEST(FlatIntervalFactories, FlatInterval) {
+    EXPECT_EQ(FlatInterval(*closed(0, 1)), FlatInterval::closed(0, 1));
+    EXPECT_EQ(FlatInterval(*open(0, 1)), FlatInterval::open(0, 1));
+    EXPECT_EQ(FlatInterval(*closed_open(0, 1)), FlatInterval::closed_open(0, 1));
+    EXPECT_EQ(FlatInterval(*open_closed(0, 1)), FlatInterval::open_closed(0, 1));
+    EXPECT_EQ(FlatInterval(*singleton(1)), FlatInterval::singleton(1));
+    EXPECT_EQ(FlatInterval(*reals()), FlatInterval::reals());
+    EXPECT_TRUE(FlatInterval::open(1, 1).is_empty());
+}
+
+TEST(FlatIntervalUnion, FlatInterval) {
+    auto a = FlatInterval({0.0, 3.0}, {1.0, 4.0}, {LEFT_CLOSED_BIT, 0});
+    auto b = FlatInterval({1.0, 5.0}, {2.0, 6.0}, {LEFT_CLOSED_BIT, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT});
+
+    // [0, 1) u [1, 2) = [0, 2)
+    auto expected = FlatInterval({0.0, 3.0, 5.0}, {2.0, 4.0, 6.0},
+                                 {LEFT_CLOSED_BIT, 0, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT});
+    EXPECT_EQ(a.union_with(b), expected);
+    EXPECT_EQ(b.union_with(a), expected);
+    EXPECT_EQ(a.union_with(FlatInterval()), a);
+}
+
+TEST(FlatIntervalIntersection, FlatInterval) {
+    auto a = FlatInterval({0.0, 2.0}, {1.0, 4.0}, {LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT, RIGHT_CLOSED_BIT});
+    auto b = FlatInterval({1.0, 3.0}, {3.0, 4.0}, {LEFT_CLOSED_BIT, LEFT_CLOSED_BIT});
+
+    // {1} u (2, 3) u [3, 4) = {1} u (2, 4)
+    auto expected = FlatInterval({1.0, 2.0}, {1.0, 4.0}, {LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT, 0});
+    EXPECT_EQ(a.intersection_with(b), expected);
+    EXPECT_EQ(b.intersection_with(a), expected);
+    EXPECT_TRUE(a.intersection_with(FlatInterval()).is_empty());
+}
+
+TEST(FlatIntervalComplement, FlatInterval) {
+    auto a = FlatInterval({0.0, 1.0}, {1.0, 2.0}, {0, RIGHT_CLOSED_BIT});
+
+    // (-inf, 0] u {1} u (2, inf)
+    auto complement = a.complement();
+    ASSERT_EQ(complement.size(), 3);
+    EXPECT_TRUE(complement.simple_interval(1) == SimpleInterval(1.0, 1.0, BorderType::CLOSED, BorderType::CLOSED));
+    EXPECT_EQ(complement.complement(), a);
+    EXPECT_TRUE(FlatInterval::reals().complement().is_empty());
+    EXPECT_EQ(FlatInterval().complement(), FlatInterval::reals());
+}
+
+TEST(FlatIntervalDifference, FlatInterval) {
+    auto a = FlatInterval::closed(0, 3);
+    auto b = FlatInterval::open(1, 2);
+    auto expected = FlatInterval({0.0, 2.0}, {1.0, 3.0},
+                                 {LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT, LEFT_CLOSED_BIT | RIGHT_CLOSED_BIT});
+    EXPECT_EQ(a.difference_with(b), expected);
+    EXPECT_TRUE(b.difference_with(a).is_empty());
+}
+
+TEST(FlatIntervalBatchContains, FlatInterval) {
+    // one interval below and one above the linear scan threshold
+    std::vector<double> lowers, uppers;
+    std::vector<std::uint8_t> borders;
+    for (int piece = 0; piece < 40; ++piece) {
+        lowers.push_back(piece * 3.0);
+        uppers.push_back(piece * 3.0 + piece % 3);
+        borders.push_back(static_cast<std::uint8_t>(piece % 4));
+    }
+    auto few = FlatInterval(std::vector<double>(lowers.begin(), lowers.begin() + 4),
+                            std::vector<double>(uppers.begin(), uppers.begin() + 4),
+                            std::vector<std::uint8_t>(borders.begin(), borders.begin() + 4));
+    auto many = FlatInterval(lowers, uppers, borders);
+    ASSERT_GT(many.size(), 8);
+
+    std::vector<double> points;
+    for (double point = -2.0; point <= 125.0; point += 0.25) {
+        points.push_back(point);
+    }
+    points.push_back(std::numeric_limits<double>::quiet_NaN());
+    points.push_back(std::numeric_limits<double>::infinity());
+
+    for (const auto &flat: {few, many}) {
+        std::vector<std::uint8_t> mask(points.size(), 7);
+        flat.contains(points.data(), points.size(), mask.data());
+        std::vector<std::uint64_t> bits((points.size() + 63) / 64, ~0ULL);
+        flat.contains_bitmask(points.data(), points.size(), bits.data());
+        for (std::size_t index = 0; index < points.size(); ++index) {
+            EXPECT_EQ(mask[index], flat.contains(points[index]) ? 1 : 0) << points[index];
+            EXPECT_EQ((bits[index / 64] >> (index % 64)) & 1, mask[index]);
+        }
+        EXPECT_EQ(bits.back() >> (points.size() % 64), 0);
+    }
+
+    // the composite interval delegates to the flat kernels
+    auto interval = many.to_interval();
+    std::vector<std::uint8_t> mask(points.size());
+    interval->contains(points.data(), points.size(), mask.data());
+    for (std::size_t index = 0; index < points.size(); ++index) {
+        EXPECT_EQ(mask[index], interval->contains(points[index]) ? 1 : 0);
+    }
+}
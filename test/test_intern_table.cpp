@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "intern_table.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "set.h"
+#include "variable.h"
+#include <thread>
+
+TEST(InternTable, CanonicalInstances) {
+    InternTable table;
+    auto first = closed(0, 1)->union_with(closed(2, 3));
+    auto second = closed(2, 3)->union_with(closed(0, 1));
+    ASSERT_NE(first, second);
+
+    auto canonical = table.intern(first);
+    EXPECT_EQ(table.intern(second), canonical);
+    EXPECT_EQ(table.intern(canonical), canonical);
+    EXPECT_EQ(*canonical, *first);
+    EXPECT_EQ(table.misses(), 1 + 2);  // the interval and its two simple intervals
+    EXPECT_EQ(table.hits(), 2);
+
+    // different types with equal hashes are never merged
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1});
+    auto set = make_shared_set(make_shared_set_element(0, all_elements), all_elements);
+    EXPECT_NE(std::static_pointer_cast<AbstractCompositeSet>(table.intern(set)),
+              std::static_pointer_cast<AbstractCompositeSet>(table.intern(singleton(0))));
+}
+
+TEST(InternTable, SharedAssignments) {
+    InternTable table;
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    auto event = make_shared_event();
+    for (int i = 0; i < 10; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed(i, i + 1)});
+        variable_map->insert({y, closed(0, 5)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    auto canonical = table.intern(std::static_pointer_cast<AbstractCompositeSet>(event));
+    EXPECT_EQ(*canonical, *event);
+
+    // all equal y assignments are one instance now
+    AbstractCompositeSetPtr_t y_assignment;
+    for (auto const &simple_set: *canonical->simple_sets) {
+        auto const &assignment = static_cast<SimpleEvent *>(simple_set.get())->variable_map->at(y);
+        if (y_assignment) {
+            EXPECT_EQ(assignment, y_assignment);
+        }
+        y_assignment = assignment;
+    }
+}
+
+TEST(InternTable, DifferentUniverses) {
+    InternTable table;
+    auto small = make_shared_all_elements(std::set<long long>{0, 1, 2});
+    auto large = make_shared_all_elements(std::set<long long>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    auto small_set = table.intern(make_shared_set(make_shared_set_element(0, small), small));
+    auto large_set = table.intern(make_shared_set(make_shared_set_element(0, large), large));
+    EXPECT_NE(small_set, large_set);
+    EXPECT_EQ(std::static_pointer_cast<Set>(large_set)->all_elements, large);
+    EXPECT_EQ(std::static_pointer_cast<Set>(large_set->complement())->cardinality(), 9);
+}
+
+TEST(InternTable, FrozenInstances) {
+    InternTable table;
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    auto x_map = std::make_shared<VariableMap>();
+    x_map->insert({x, closed(0, 1)});
+    auto canonical = std::static_pointer_cast<SimpleEvent>(table.intern(make_shared_simple_event(x_map)));
+    EXPECT_TRUE(canonical->is_frozen());
+    EXPECT_TRUE(canonical->variable_map->at(x)->is_frozen());
+    EXPECT_FALSE(canonical->deep_copy()->is_frozen());
+
+    // events fill copies of interned simple events instead of the shared instances
+    auto y_map = std::make_shared<VariableMap>();
+    y_map->insert({y, closed(0, 1)});
+    auto simple_events = make_shared_simple_set_set();
+    simple_events->insert(canonical);
+    simple_events->insert(make_shared_simple_event(y_map));
+    auto event = make_shared_event(simple_events);
+    EXPECT_EQ(canonical->variable_map->size(), 1);
+    for (auto const &simple_set: *event->simple_sets) {
+        EXPECT_EQ(static_cast<SimpleEvent *>(simple_set.get())->variable_map->size(), 2);
+    }
+    EXPECT_EQ(table.intern(make_shared_simple_event(x_map)), std::static_pointer_cast<AbstractSimpleSet>(canonical));
+
+    // frozen instances reject modification
+    EXPECT_THROW(canonical->fill_missing_variables(make_shared_variable_set(VariableSet{x, y})),
+                 std::invalid_argument);
+    auto interned_event = table.intern(std::static_pointer_cast<AbstractCompositeSet>(event));
+    EXPECT_THROW(interned_event->add_new_simple_set(canonical), std::invalid_argument);
+    EXPECT_THROW(std::static_pointer_cast<Event>(interned_event)->fill_missing_variables(
+            make_shared_variable_set(VariableSet{x, y, make_shared_continuous("z")})), std::invalid_argument);
+}
+
+TEST(InternTable, ReleaseAndConcurrency) {
+    InternTable table(8);
+    {
+        auto interval = table.intern(closed(10, 11));
+        EXPECT_GT(table.size(), 0);
+    }
+    EXPECT_EQ(table.purge(), 2);
+    EXPECT_EQ(table.size(), 0);
+
+    std::vector<AbstractCompositeSetPtr_t> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t thread = 0; thread < results.size(); ++thread) {
+        threads.emplace_back([&, thread] {
+            for (int repetition = 0; repetition < 200; ++repetition) {
+                results[thread] = table.intern(closed(0, 1)->union_with(closed(4, 5)));
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (auto const &result: results) {
+        EXPECT_EQ(result, results.front());
+    }
+}
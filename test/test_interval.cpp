@@ -2,6 +2,7 @@
 #include "interval.h"
 #include "sigma_algebra.h"
 #include <set>
+#include <unordered_set>
 #include <memory>
 #include <iostream>
 
@@ -249,3 +250,126 @@ TEST(IntervalDifference, Interval) {
     EXPECT_EQ(difference_2->simple_sets->size(), 1);
     EXPECT_TRUE(difference_2->is_disjoint());
 }
+
+TEST(IntervalSimplifyContained, Interval) {
+    auto interval1 = SimpleInterval::make_shared(0.0, 5.0, BorderType::CLOSED, BorderType::CLOSED);
+    auto interval2 = SimpleInterval::make_shared(1.0, 2.0, BorderType::CLOSED, BorderType::CLOSED);
+    auto interval3 = SimpleInterval::make_shared(5.0, 6.0, BorderType::OPEN, BorderType::OPEN);
+    auto intervals = make_shared_simple_set_set();
+    intervals->insert(interval1);
+    intervals->insert(interval2);
+    intervals->insert(interval3);
+    auto interval = Interval::make_shared(intervals);
+
+    auto simplified = interval->simplify();
+    ASSERT_EQ(simplified->simple_sets->size(), 1);
+    auto merged = std::static_pointer_cast<SimpleInterval>(*simplified->simple_sets->begin());
+    EXPECT_TRUE(*merged == SimpleInterval(0.0, 6.0, BorderType::CLOSED, BorderType::OPEN));
+
+    // the original simple intervals are left untouched
+    EXPECT_EQ(interval1->upper, 5.0);
+    EXPECT_TRUE(interval->contains(5.5));
+    EXPECT_FALSE(interval->contains(6.0));
+}
+
+TEST(IntervalSweepPointwise, Interval) {
+    // pseudo random pieces on a coarse grid, such that touching and equal bounds happen frequently
+    unsigned int state = 42;
+    auto next = [&state]() {
+        state = state * 1103515245 + 12345;
+        return (state >> 16) % 20;
+    };
+    auto random_interval = [&]() {
+        auto intervals = make_shared_simple_set_set();
+        for (int index = 0; index < 6; ++index) {
+            double lower = next();
+            double upper = lower + next() % 5;
+            intervals->insert(SimpleInterval::make_shared(lower, upper,
+                                                          next() % 2 ? BorderType::OPEN : BorderType::CLOSED,
+                                                          next() % 2 ? BorderType::OPEN : BorderType::CLOSED));
+        }
+        return std::static_pointer_cast<AbstractCompositeSet>(Interval::make_shared(intervals)->make_disjoint());
+    };
+    auto contains = [](const AbstractCompositeSetPtr_t &interval, double point) {
+        return std::static_pointer_cast<Interval>(interval)->contains(point);
+    };
+
+    for (int round = 0; round < 50; ++round) {
+        auto a = random_interval();
+        auto b = random_interval();
+        auto union_ = a->union_with(b);
+        auto intersection = a->intersection_with(b);
+        auto difference = a->difference_with(b);
+        auto complement = a->complement();
+        for (double point = -1; point <= 26; point += 0.5) {
+            EXPECT_EQ(contains(union_, point), contains(a, point) or contains(b, point));
+            EXPECT_EQ(contains(intersection, point), contains(a, point) and contains(b, point));
+            EXPECT_EQ(contains(difference, point), contains(a, point) and not contains(b, point));
+            EXPECT_EQ(contains(complement, point), not contains(a, point));
+        }
+        EXPECT_TRUE(union_->is_disjoint());
+        EXPECT_TRUE(difference->is_disjoint());
+    }
+}
+
+TEST(IntervalUnionEqualBoundsDifferentBorders, Interval) {
+    // [6, 10) and (6, 10] are equivalent in the ordering of simple sets, but their union is [6, 10]
+    auto a = closed_open(6, 10);
+    auto b = open_closed(6, 10);
+    auto union_ = a->union_with(b);
+    ASSERT_EQ(union_->simple_sets->size(), 1);
+    EXPECT_TRUE(*union_ == *closed(6, 10));
+}
+
+TEST(SimpleIntervalHash, Interval) {
+    // degenerate intervals used to cancel out in the xor of their fields
+    std::unordered_set<std::size_t> hashes;
+    for (int i = 0; i < 100; ++i) {
+        hashes.insert(std::hash<SimpleInterval>()(SimpleInterval(i, i, BorderType::CLOSED, BorderType::CLOSED)));
+    }
+    EXPECT_EQ(hashes.size(), 100);
+
+    EXPECT_NE(SimpleInterval(0, 1, BorderType::OPEN, BorderType::CLOSED).hash(),
+              SimpleInterval(0, 1, BorderType::CLOSED, BorderType::OPEN).hash());
+    EXPECT_EQ(SimpleInterval(-0.0, 1).hash(), SimpleInterval(0.0, 1).hash());
+
+    std::unordered_set<SimpleInterval> intervals{SimpleInterval(0, 1), SimpleInterval(0, 1), SimpleInterval(1, 1)};
+    EXPECT_EQ(intervals.size(), 2);
+}
+
+TEST(IntervalHash, Interval) {
+    auto a = closed(0, 1)->union_with(closed(2, 3));
+    auto b = closed(2, 3)->union_with(closed(0, 1));
+    EXPECT_EQ(a->hash(), b->hash());
+    EXPECT_NE(a->hash(), closed(0, 1)->hash());
+
+    // the cached hash is recomputed after an in-place modification
+    auto c = closed(0, 1);
+    auto before = c->hash();
+    c->add_new_simple_set(std::make_shared<SimpleInterval>(2, 3, BorderType::CLOSED, BorderType::CLOSED));
+    EXPECT_NE(c->hash(), before);
+    EXPECT_EQ(c->hash(), a->hash());
+}
+
+TEST(Interval, Arrays) {
+    // unsorted, overlapping and empty pieces are simplified
+    const double lowers[] = {5, 0, 1, 7};
+    const double uppers[] = {6, 2, 3, 7};
+    const std::uint8_t left_closed[] = {0, 1, 1, 0};
+    const std::uint8_t right_closed[] = {1, 1, 0, 1};
+    auto interval = Interval::from_arrays(lowers, uppers, left_closed, right_closed, 4);
+    EXPECT_TRUE(*interval == *closed_open(0, 3)->union_with(open_closed(5, 6)));
+
+    std::vector<double> result_lowers(2), result_uppers(2);
+    std::vector<std::uint8_t> result_left(2), result_right(2);
+    interval->to_arrays(result_lowers.data(), result_uppers.data(), result_left.data(), result_right.data());
+    EXPECT_EQ(result_lowers, (std::vector<double>{0, 5}));
+    EXPECT_EQ(result_uppers, (std::vector<double>{3, 6}));
+    EXPECT_EQ(result_left, (std::vector<std::uint8_t>{1, 0}));
+    EXPECT_EQ(result_right, (std::vector<std::uint8_t>{0, 1}));
+
+    auto round_trip = Interval::from_arrays(result_lowers.data(), result_uppers.data(), result_left.data(),
+                                            result_right.data(), 2);
+    EXPECT_TRUE(*round_trip == *interval);
+    EXPECT_TRUE(Interval::from_arrays(nullptr, nullptr, nullptr, nullptr, 0)->is_empty());
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "interval.h"
+#include "set.h"
+#include "product_algebra.h"
+#include "variable.h"
+
+TEST(MemoryUsage, IntervalGrowsWithSimpleSets) {
+    auto one = closed(0, 1);
+    auto two = closed(0, 1)->union_with(closed(2, 3));
+    auto usage_one = one->memory_usage();
+    auto usage_two = two->memory_usage();
+    EXPECT_GT(usage_one.total_bytes, 0);
+    EXPECT_EQ(usage_one.total_bytes, usage_one.unique_bytes);
+    EXPECT_GT(usage_two.total_bytes, usage_one.total_bytes);
+}
+
+TEST(MemoryUsage, SharedUniverseIsCountedOnce) {
+    std::set<long long> elements{0, 1, 2, 3};
+    auto all_elements = make_shared_all_elements(elements);
+    auto first = make_shared_set_element(0, all_elements);
+    auto second = make_shared_set_element(1, all_elements);
+    auto simple_sets = make_shared_simple_set_set();
+    simple_sets->insert(first);
+    auto set_one = make_shared_set(simple_sets, all_elements);
+    auto set_two = make_shared_set(all_elements);
+    set_two->simple_sets->insert(first);
+    set_two->simple_sets->insert(second);
+
+    // the second element only adds its node, not another copy of the universe
+    auto usage_one = set_one->memory_usage();
+    auto usage_two = set_two->memory_usage();
+    EXPECT_EQ(usage_two.total_bytes - usage_one.total_bytes,
+              TREE_NODE_BYTES + sizeof(AbstractSimpleSetPtr_t) + SHARED_CONTROL_BLOCK_BYTES + sizeof(SetElement));
+
+    // the universe is shared with the elements and the test, hence it is not unique
+    EXPECT_LT(usage_one.unique_bytes, usage_one.total_bytes);
+}
+
+TEST(MemoryUsage, SharedAssignmentsAreNotUnique) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto interval = closed(0, 1);
+
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, interval});
+    variable_map->insert({y, interval});
+    auto simple_event = make_shared_simple_event(variable_map);
+
+    auto usage = simple_event->memory_usage();
+    EXPECT_LT(usage.unique_bytes, usage.total_bytes);
+
+    // the interval is counted once although it is assigned twice
+    auto copied_map = std::make_shared<VariableMap>();
+    copied_map->insert({x, closed(0, 1)});
+    copied_map->insert({y, closed(0, 1)});
+    auto copied = make_shared_simple_event(copied_map);
+    EXPECT_EQ(copied->memory_usage().total_bytes - usage.total_bytes, interval->memory_usage().total_bytes);
+
+    // once the test releases its references, the interval is only referenced within the simple event and unique
+    interval.reset();
+    variable_map.reset();
+    copied_map.reset();
+    auto released = simple_event->memory_usage();
+    auto copied_usage = copied->memory_usage();
+    EXPECT_EQ(released.total_bytes, usage.total_bytes);
+    EXPECT_GT(released.unique_bytes, usage.unique_bytes);
+    EXPECT_EQ(released.total_bytes - released.unique_bytes, copied_usage.total_bytes - copied_usage.unique_bytes);
+}
+
+TEST(MemoryUsage, EventGrowsWithSimpleEvents) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto event = make_shared_event();
+    std::size_t previous = event->memory_usage().total_bytes;
+    for (int i = 0; i < 4; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed(2 * i, 2 * i + 1)});
+        variable_map->insert({y, closed(0, 1)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+        auto current = event->memory_usage().total_bytes;
+        EXPECT_GT(current, previous);
+        previous = current;
+    }
+}
+
+TEST(MemoryUsage, Variable) {
+    auto name = std::make_shared<std::string>("a variable with a name that does not fit the small buffer");
+    auto x = make_shared_continuous(name);
+    auto usage = x->memory_usage();
+    EXPECT_GE(usage.total_bytes, sizeof(Continuous) + name->size());
+
+    // the name is shared with the test
+    EXPECT_LT(usage.unique_bytes, usage.total_bytes);
+}
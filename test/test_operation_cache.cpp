@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "operation_cache.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "set.h"
+#include "variable.h"
+
+class OperationCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        set_operation_cache_capacity(16);
+        clear_operation_cache();
+    }
+
+    void TearDown() override {
+        set_operation_cache_capacity(0);
+        clear_operation_cache();
+    }
+};
+
+TEST_F(OperationCacheTest, DisabledByDefault) {
+    OperationCache cache;
+    EXPECT_FALSE(cache.enabled());
+    cache.insert(SetOperation::UNION, 0, closed(0, 1), closed(0, 1), closed(0, 1));
+    EXPECT_EQ(cache.statistics().size, 0);
+}
+
+TEST_F(OperationCacheTest, HitsAndMisses) {
+    auto lhs = closed(0, 2)->union_with(closed(4, 6));
+    auto lhs_copy = closed(4, 6)->union_with(closed(0, 2));
+    auto rhs = closed(1, 5);
+    auto rhs_copy = closed(1, 5);
+
+    auto first = lhs->intersection_with(rhs);
+    auto misses = get_operation_cache_statistics().misses;
+    EXPECT_GT(misses, 0);
+
+    // equal operands at different addresses hit the cache
+    auto second = lhs_copy->intersection_with(rhs_copy);
+    EXPECT_EQ(*first, *second);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(get_operation_cache_statistics().misses, misses);
+    EXPECT_GE(get_operation_cache_statistics().hits, 1);
+
+    // the results agree with the uncached computation
+    set_operation_cache_capacity(0);
+    EXPECT_EQ(*lhs->intersection_with(rhs), *first);
+    EXPECT_EQ(*lhs->complement(), *lhs_copy->complement());
+}
+
+TEST_F(OperationCacheTest, ModifiedResultsAndOperands) {
+    auto lhs = closed(0, 2)->union_with(closed(4, 6));
+    auto rhs = closed(1, 5);
+    auto expected = lhs->intersection_with(rhs)->deep_copy();
+
+    // modifying a result does not modify the cached one
+    auto result = lhs->intersection_with(rhs);
+    result->simple_sets->clear();
+    EXPECT_EQ(*lhs->intersection_with(rhs), *expected);
+
+    // modifying an operand does not return results of its old value
+    lhs->simple_sets->clear();
+    EXPECT_TRUE(lhs->intersection_with(rhs)->is_empty());
+}
+
+TEST_F(OperationCacheTest, LeastRecentlyUsedEviction) {
+    set_operation_cache_capacity(2);
+    auto a = closed(0, 1)->union_with(closed(2, 3));
+    auto b = closed(0, 1)->union_with(closed(4, 5));
+    auto c = closed(0, 1)->union_with(closed(6, 7));
+
+    a->complement();
+    b->complement();
+    a->complement();  // a is now the most recently used
+    c->complement();  // evicts b
+    auto statistics = get_operation_cache_statistics();
+    EXPECT_EQ(statistics.capacity, 2);
+    EXPECT_GE(statistics.evictions, 1);
+
+    auto hits = statistics.hits;
+    a->complement();
+    EXPECT_EQ(get_operation_cache_statistics().hits, hits + 1);
+}
+
+TEST_F(OperationCacheTest, Events) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    auto lhs_map = std::make_shared<VariableMap>();
+    lhs_map->insert({x, closed(0, 1)});
+    lhs_map->insert({y, closed(0, 1)});
+    auto rhs_map = std::make_shared<VariableMap>();
+    rhs_map->insert({x, closed(0.5, 2)});
+    rhs_map->insert({y, closed(0.5, 2)});
+    auto lhs = make_shared_event(make_shared_simple_event(lhs_map));
+    auto rhs = make_shared_event(make_shared_simple_event(rhs_map));
+
+    auto first = lhs->union_with(rhs);
+    auto hits = get_operation_cache_statistics().hits;
+    auto second = lhs->union_with(rhs);
+    EXPECT_EQ(get_operation_cache_statistics().hits, hits + 1);
+    EXPECT_EQ(*first, *second);
+
+    set_operation_cache_capacity(0);
+    EXPECT_EQ(*lhs->union_with(rhs), *first);
+}
+
+TEST_F(OperationCacheTest, ModifiedSimpleSetsOfResults) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    auto lhs_map = std::make_shared<VariableMap>();
+    lhs_map->insert({x, closed(0, 1)});
+    auto rhs_map = std::make_shared<VariableMap>();
+    rhs_map->insert({x, closed(0.5, 2)});
+    auto lhs = make_shared_event(make_shared_simple_event(lhs_map));
+    auto rhs = make_shared_event(make_shared_simple_event(rhs_map));
+
+    auto expected = lhs->intersection_with(rhs)->deep_copy();
+
+    // modifying the simple events of a result in place does not modify the cached one
+    auto result = std::static_pointer_cast<Event>(lhs->intersection_with(rhs));
+    result->fill_missing_variables(make_shared_variable_set(VariableSet{x, y}));
+    EXPECT_NE(*result, *expected);
+
+    auto hits = get_operation_cache_statistics().hits;
+    EXPECT_EQ(*lhs->intersection_with(rhs), *expected);
+    EXPECT_EQ(get_operation_cache_statistics().hits, hits + 1);
+}
+
+TEST_F(OperationCacheTest, SetsOfDifferentUniverses) {
+    auto small = make_shared_symbolic(std::make_shared<std::string>("small"),
+                                      make_shared_all_elements(std::set<long long>{0, 1, 2}));
+    auto large = make_shared_symbolic(std::make_shared<std::string>("large"),
+                                      make_shared_all_elements(std::set<long long>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    auto small_domain = std::static_pointer_cast<Set>(small->get_domain());
+    auto large_domain = std::static_pointer_cast<Set>(large->get_domain());
+    auto small_set = make_shared_set(make_shared_set_element(0, small_domain->all_elements),
+                                     small_domain->all_elements);
+    auto large_set = make_shared_set(make_shared_set_element(0, large_domain->all_elements),
+                                     large_domain->all_elements);
+
+    // the same element index of different universes is not the same set
+    EXPECT_NE(*small_set, *large_set);
+    EXPECT_FALSE(*make_shared_set_element(0, small_domain->all_elements) ==
+                 *make_shared_set_element(0, large_domain->all_elements));
+
+    EXPECT_EQ(std::static_pointer_cast<Set>(small_set->complement())->cardinality(), 2);
+    EXPECT_EQ(std::static_pointer_cast<Set>(large_set->complement())->cardinality(), 9);
+
+    // universes with the same elements are the same universe
+    auto copy = make_shared_set(make_shared_set_element(0, make_shared_all_elements(*small_domain->all_elements)),
+                                make_shared_all_elements(*small_domain->all_elements));
+    EXPECT_EQ(*copy, *small_set);
+    EXPECT_EQ(copy->hash(), small_set->hash());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "operation_statistics.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "variable.h"
+#include <thread>
+
+TEST(OperationStatistics, CountsOperations) {
+    if (!operation_statistics_enabled()) {
+        GTEST_SKIP() << "operation counters are compiled out";
+    }
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto map_a = std::make_shared<VariableMap>();
+    map_a->insert({x, closed(0, 2)});
+    map_a->insert({y, closed(0, 2)});
+    auto map_b = std::make_shared<VariableMap>();
+    map_b->insert({x, closed(1, 3)});
+    map_b->insert({y, closed(1, 3)});
+    auto a = make_shared_event(make_shared_simple_event(map_a));
+    auto b = make_shared_event(make_shared_simple_event(map_b));
+
+    reset_operation_statistics();
+    a->union_with(b);
+    auto statistics = get_operation_statistics();
+    EXPECT_GT(statistics.simple_intersections, 0);
+    EXPECT_GT(statistics.simple_complements, 0);
+    EXPECT_GT(statistics.empty_allocations, 0);
+    EXPECT_GT(statistics.split_rounds, 0);
+    EXPECT_GE(statistics.peak_simple_sets, 2);
+
+    reset_operation_statistics();
+    statistics = get_operation_statistics();
+    EXPECT_EQ(statistics.simple_intersections, 0);
+    EXPECT_EQ(statistics.peak_simple_sets, 0);
+}
+
+TEST(OperationStatistics, SimplifyPasses) {
+    if (!operation_statistics_enabled()) {
+        GTEST_SKIP() << "operation counters are compiled out";
+    }
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto event = make_shared_event();
+    for (int i = 0; i < 3; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed_open(i, i + 1)});
+        variable_map->insert({y, closed(0, 1)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    reset_operation_statistics();
+    event->simplify();
+    EXPECT_GT(get_operation_statistics().simplify_passes, 0);
+}
+
+TEST(OperationStatistics, AggregatesThreads) {
+    if (!operation_statistics_enabled()) {
+        GTEST_SKIP() << "operation counters are compiled out";
+    }
+    reset_operation_statistics();
+    auto count_complements = [] {
+        for (int i = 0; i < 10; ++i) {
+            closed(i, i + 1)->simple_sets->begin()->get()->complement();
+        }
+    };
+
+    // finished threads keep their counts
+    std::thread first(count_complements);
+    first.join();
+    std::thread second(count_complements);
+    count_complements();
+    second.join();
+    EXPECT_EQ(get_operation_statistics().simple_complements, 30);
+}
@@ -239,6 +239,108 @@ TEST(ProductAlgebra, Simplify){
 
 }
 
+TEST(ProductAlgebra, SimplifyGrid) {
+    // a k x k grid of half-open unit cells simplifies to one box
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    const int k = 12;
+
+    auto composite_event = make_shared_event();
+    for (int i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) {
+            auto variables = std::make_shared<VariableMap>();
+            variables->insert({x, closed_open(i, i + 1)});
+            variables->insert({y, closed_open(j, j + 1)});
+            composite_event->simple_sets->insert(make_shared_simple_event(variables));
+        }
+    }
+
+    // an isolated cell that must not be merged
+    auto isolated = std::make_shared<VariableMap>();
+    isolated->insert({x, closed(20, 21)});
+    isolated->insert({y, closed(20, 21)});
+    composite_event->simple_sets->insert(make_shared_simple_event(isolated));
+
+    auto result = composite_event->simplify();
+    ASSERT_EQ(result->simple_sets->size(), 2);
+
+    auto box = std::static_pointer_cast<SimpleEvent>(*result->simple_sets->begin());
+    EXPECT_EQ(*box->variable_map->at(x), *closed_open(0, k));
+    EXPECT_EQ(*box->variable_map->at(y), *closed_open(0, k));
+}
+
+TEST(ProductAlgebra, SimplifyHashConsistency) {
+    auto x = make_shared_continuous("x");
+    auto a = make_shared_symbolic("a", make_shared_set(s0, all_elements_int));
+
+    auto variables1 = std::make_shared<VariableMap>();
+    variables1->insert({x, closed(0, 1)->union_with(closed(2, 3))});
+    variables1->insert({a, make_shared_set(s1, all_elements_int)});
+    auto variables2 = std::make_shared<VariableMap>();
+    variables2->insert({x, closed(2, 3)->union_with(closed(0, 1))});
+    variables2->insert({a, make_shared_set(s1, all_elements_int)});
+
+    auto event1 = make_shared_simple_event(variables1);
+    auto event2 = make_shared_simple_event(variables2);
+    ASSERT_TRUE(*event1 == *event2);
+    EXPECT_EQ(event1->hash(), event2->hash());
+}
+
+TEST(ProductAlgebra, EventHash) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    // the variable maps are hashed by value, not by the addresses of their assignments
+    VariableMap map1{{x, closed(0, 1)}};
+    VariableMap map2{{x, closed(0, 1)}};
+    EXPECT_EQ(VariableMapHash{}(map1), VariableMapHash{}(map2));
+
+    auto variables1 = std::make_shared<VariableMap>(map1);
+    auto variables2 = std::make_shared<VariableMap>(map2);
+    auto event1 = make_shared_event(make_shared_simple_event(variables1));
+    auto event2 = make_shared_event(make_shared_simple_event(variables2));
+    EXPECT_EQ(event1->hash(), event2->hash());
+
+    // filling in variables modifies the event in place and changes its hash
+    auto before = event1->hash();
+    event1->fill_missing_variables(make_shared_variable_set(VariableSet{x, y}));
+    EXPECT_NE(event1->hash(), before);
+    event2->fill_missing_variables(make_shared_variable_set(VariableSet{x, y}));
+    EXPECT_EQ(event1->hash(), event2->hash());
+}
+
+TEST(ProductAlgebra, HashAfterInPlaceModification) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, closed(0, 1)});
+    auto simple_event = make_shared_simple_event(variable_map);
+    auto event = make_shared_event(simple_event);
+    auto interval = closed(0, 1);
+
+    // modifications through the containers are not tracked, but never leave a stale hash behind
+    auto simple_event_hash = simple_event->hash();
+    auto event_hash = event->hash();
+    variable_map->insert({y, closed(0, 1)});
+    EXPECT_NE(simple_event->hash(), simple_event_hash);
+    EXPECT_NE(event->hash(), event_hash);
+
+    auto interval_hash = interval->hash();
+    auto simple_interval = std::static_pointer_cast<SimpleInterval>(*interval->simple_sets->begin());
+    auto simple_interval_hash = simple_interval->hash();
+    simple_interval->upper = 2;
+    EXPECT_NE(simple_interval->hash(), simple_interval_hash);
+    EXPECT_NE(interval->hash(), interval_hash);
+    EXPECT_EQ(interval->hash(), closed(0, 2)->hash());
+
+    auto set_hash = event->hash();
+    auto other_map = std::make_shared<VariableMap>();
+    other_map->insert({x, closed(5, 6)});
+    other_map->insert({y, closed(0, 1)});
+    event->simple_sets->insert(make_shared_simple_event(other_map));
+    EXPECT_NE(event->hash(), set_hash);
+}
+
 TEST(ProductAlgebra, UnionDifferentVariables) {
     const auto continuous1 = make_shared_continuous("x");
     const auto continuous2 = make_shared_continuous("y");
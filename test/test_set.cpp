@@ -93,4 +93,157 @@ TEST(Set, UnionWith){
     auto element = make_shared_set_element(0, all_elements);
     auto a_ = a->union_with(element);
     EXPECT_EQ(a_->simple_sets->size(), 1);
-}
\ No newline at end of file
+}
+TEST(DynamicBitset, WordOperations) {
+    DynamicBitset a(130);
+    DynamicBitset b(130);
+    a.set(0);
+    a.set(64);
+    a.set(129);
+    b.set(64);
+    b.set(100);
+
+    EXPECT_EQ(a.count(), 3);
+    EXPECT_EQ(a.find_next(1), 64);
+    EXPECT_EQ(a.find_next(130), 130);
+
+    auto intersection = a;
+    intersection &= b;
+    EXPECT_EQ(intersection.count(), 1);
+    EXPECT_TRUE(intersection.test(64));
+
+    auto union_ = a;
+    union_ |= b;
+    EXPECT_EQ(union_.count(), 4);
+
+    auto difference = a;
+    difference -= b;
+    EXPECT_EQ(difference.count(), 2);
+    EXPECT_FALSE(difference.test(64));
+
+    auto complement = a;
+    complement.flip();
+    EXPECT_EQ(complement.count(), 127);
+    EXPECT_EQ(complement.flip(), a);
+
+    std::vector<std::size_t> visited;
+    a.for_each_set_bit([&visited](std::size_t index) { visited.push_back(index); });
+    EXPECT_EQ(visited, (std::vector<std::size_t>{0, 64, 129}));
+    EXPECT_TRUE(DynamicBitset(10).none());
+
+    EXPECT_EQ(a.find_last(), 129);
+    EXPECT_EQ(DynamicBitset(10).find_last(), 10);
+    auto symmetric_difference = a;
+    symmetric_difference ^= b;
+    EXPECT_EQ(symmetric_difference.count(), 3);
+    EXPECT_FALSE(symmetric_difference.test(64));
+
+    auto resized = a;
+    resized.resize(100);
+    EXPECT_EQ(resized.count(), 2);
+    resized.resize(200);
+    EXPECT_EQ(resized.size(), 200);
+    EXPECT_EQ(resized.find_next(65), 200);
+}
+
+TEST(Set, BitsetOperations) {
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2, 3});
+    auto sets_a = make_shared_simple_set_set();
+    sets_a->insert(make_shared_set_element(0, all_elements));
+    sets_a->insert(make_shared_set_element(1, all_elements));
+    auto sets_b = make_shared_simple_set_set();
+    sets_b->insert(make_shared_set_element(1, all_elements));
+    sets_b->insert(make_shared_set_element(3, all_elements));
+    auto a = std::static_pointer_cast<AbstractCompositeSet>(make_shared_set(sets_a, all_elements));
+    auto b = std::static_pointer_cast<AbstractCompositeSet>(make_shared_set(sets_b, all_elements));
+
+    auto intersection = std::static_pointer_cast<Set>(a->intersection_with(b));
+    EXPECT_EQ(intersection->cardinality(), 1);
+    EXPECT_TRUE(intersection->to_bitset().test(1));
+
+    auto union_ = std::static_pointer_cast<Set>(a->union_with(b));
+    EXPECT_EQ(union_->cardinality(), 3);
+    EXPECT_TRUE(union_->is_disjoint());
+
+    auto difference = std::static_pointer_cast<Set>(a->difference_with(b));
+    EXPECT_EQ(difference->cardinality(), 1);
+    EXPECT_TRUE(difference->to_bitset().test(0));
+
+    auto complement = std::static_pointer_cast<Set>(a->complement());
+    EXPECT_EQ(complement->cardinality(), 2);
+    EXPECT_EQ(complement->union_with(a)->simple_sets->size(), 4);
+    EXPECT_TRUE(complement->intersection_with(a)->is_empty());
+
+    // elements of a larger universe are dropped, unless the result would contain them
+    auto larger = make_shared_all_elements(std::set<long long>{0, 1, 2, 3, 4, 5});
+    auto foreign = std::static_pointer_cast<AbstractCompositeSet>(
+            make_shared_set(make_shared_set_element(5, larger), larger));
+    EXPECT_TRUE(a->intersection_with(foreign)->is_empty());
+    EXPECT_TRUE(*a->difference_with(foreign) == *a);
+    EXPECT_THROW(a->union_with(foreign), std::invalid_argument);
+}
+
+TEST(Set, ElementsAreCreatedOnAccess) {
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2, 3});
+    const long long indices[] = {1};
+    auto set = Set::from_indices(indices, 1, all_elements);
+
+    // results of set operations only hold their bitset
+    auto complement = std::static_pointer_cast<Set>(set->complement());
+    EXPECT_EQ(complement->simple_sets.container(), nullptr);
+    EXPECT_EQ(complement->cardinality(), 3);
+    EXPECT_FALSE(complement->is_empty());
+    EXPECT_TRUE(*complement->complement() == *set);
+    EXPECT_EQ(*complement->to_string(), "{0, 2, 3}");
+    EXPECT_EQ(complement->simple_sets.container(), nullptr);
+
+    // the first access creates the set elements, which represent the set from then on
+    EXPECT_EQ(complement->simple_sets->size(), 3);
+    EXPECT_EQ(static_cast<SetElement *>(complement->simple_sets->begin()->get())->element_index, 0);
+    complement->simple_sets->erase(complement->simple_sets->begin());
+    EXPECT_EQ(complement->cardinality(), 2);
+    EXPECT_FALSE(complement->to_bitset().test(0));
+    EXPECT_EQ(complement->complement()->simple_sets->size(), 2);
+
+    // sets are ordered like their ascending element indices
+    auto first = make_shared_set(make_shared_set_element(0, all_elements), all_elements);
+    EXPECT_TRUE(*first < *complement);
+    EXPECT_FALSE(*complement < *first);
+    EXPECT_TRUE(*set < *complement->union_with(first->complement()));
+    EXPECT_FALSE(*set < *set);
+}
+
+TEST(Set, LargeUniverseComplement) {
+    std::set<long long> universe;
+    for (long long element = 0; element < 2000; ++element) {
+        universe.insert(element);
+    }
+    auto all_elements = make_shared_all_elements(universe);
+    auto elements = make_shared_simple_set_set();
+    for (int index = 0; index < 2000; index += 7) {
+        elements->insert(make_shared_set_element(index, all_elements));
+    }
+    auto set = make_shared_set(elements, all_elements);
+    auto complement = std::static_pointer_cast<Set>(set->complement());
+    EXPECT_EQ(complement->cardinality() + set->cardinality(), 2000);
+    EXPECT_EQ(complement->simple_sets->size(), complement->cardinality());
+    EXPECT_TRUE(*complement->complement() == *set);
+}
+
+TEST(Set, Indices) {
+    auto all_elements = make_shared_all_elements(std::set<long long>{0, 1, 2, 3, 4});
+    const long long indices[] = {3, 0, 3, 1};
+    auto set = Set::from_indices(indices, 4, all_elements);
+    EXPECT_EQ(set->cardinality(), 3);
+    EXPECT_EQ(set->all_elements, all_elements);
+
+    std::vector<long long> result(set->simple_sets->size());
+    set->to_indices(result.data());
+    EXPECT_EQ(result, (std::vector<long long>{0, 1, 3}));
+    EXPECT_TRUE(*Set::from_indices(result.data(), result.size(), all_elements) == *set);
+
+    const long long out_of_range[] = {5};
+    EXPECT_THROW(Set::from_indices(out_of_range, 1, all_elements), std::invalid_argument);
+    const long long negative[] = {-1};
+    EXPECT_THROW(Set::from_indices(negative, 1, all_elements), std::invalid_argument);
+}
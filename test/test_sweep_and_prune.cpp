@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "sweep_and_prune.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "variable.h"
+#include <cmath>
+#include <random>
+
+TEST(SweepAndPrune, MatchesAllPairs) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> position(0, 100);
+    std::uniform_real_distribution<double> extent(0, 8);
+
+    std::vector<BoundingBox_t> boxes;
+    for (int i = 0; i < 300; ++i) {
+        BoundingBox_t box;
+        for (int axis = 0; axis < 3; ++axis) {
+            auto lower = position(generator);
+            box.emplace_back(lower, lower + extent(generator));
+        }
+        boxes.push_back(box);
+    }
+    // touching boxes and unbounded boxes count as overlapping
+    boxes.push_back({{-std::numeric_limits<double>::infinity(), 0}, {0, 1}, {0, 1}});
+    boxes.push_back({{0, 0}, {1, std::numeric_limits<double>::infinity()}, {1, 1}});
+
+    IndexPairs_t expected;
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        for (std::size_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes_overlap(boxes[i], boxes[j])) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    auto result = overlapping_pairs(boxes);
+    EXPECT_EQ(result, expected);
+    EXPECT_LT(result.size(), boxes.size() * (boxes.size() - 1) / 2);
+}
+
+TEST(SweepAndPrune, BoundingBoxes) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({x, closed(0, 1)->union_with(open(3, 4))});
+    variable_map->insert({y, closed(-2, 2)});
+    auto simple_event = make_shared_simple_event(variable_map);
+
+    BoundingBox_t box;
+    ASSERT_TRUE(simple_event->bounding_box(box));
+    BoundingBox_t expected = {{0, 4}, {-2, 2}};
+    EXPECT_EQ(box, expected);
+}
+
+TEST(SweepAndPrune, SparseMakeDisjoint) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    // a diagonal of boxes where only neighbours overlap
+    auto event = make_shared_event();
+    const int n = 200;
+    for (int i = 0; i < n; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        variable_map->insert({x, closed(i, i + 1.5)});
+        variable_map->insert({y, closed(i, i + 1.5)});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    auto disjoint = event->make_disjoint();
+    EXPECT_TRUE(disjoint->is_disjoint());
+
+    // every point of the diagonal is still covered exactly once
+    for (int i = 0; i < n; ++i) {
+        int hits = 0;
+        for (auto const &simple_set : *disjoint->simple_sets) {
+            auto simple_event = static_cast<SimpleEvent *>(simple_set.get());
+            if (simple_event->variable_map->at(x)->simple_sets->empty()) {
+                continue;
+            }
+            auto x_interval = std::static_pointer_cast<Interval>(simple_event->variable_map->at(x));
+            auto y_interval = std::static_pointer_cast<Interval>(simple_event->variable_map->at(y));
+            hits += x_interval->contains(i + 1.25) && y_interval->contains(i + 1.25);
+        }
+        EXPECT_EQ(hits, 1);
+    }
+}
+
+TEST(SweepAndPrune, MatchesAllCrossPairs) {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> position(0, 100);
+    std::uniform_real_distribution<double> extent(0, 8);
+    // coarse positions produce equal lower bounds on both sides
+    auto make_boxes = [&](int count) {
+        std::vector<BoundingBox_t> boxes;
+        for (int i = 0; i < count; ++i) {
+            BoundingBox_t box;
+            for (int axis = 0; axis < 2; ++axis) {
+                auto lower = std::floor(position(generator) / 4);
+                box.emplace_back(lower, lower + std::floor(extent(generator)));
+            }
+            boxes.push_back(box);
+        }
+        return boxes;
+    };
+    auto lhs = make_boxes(200);
+    auto rhs = make_boxes(150);
+    rhs.push_back({{-std::numeric_limits<double>::infinity(), 0}, {0, std::numeric_limits<double>::infinity()}});
+
+    IndexPairs_t expected;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        for (std::size_t j = 0; j < rhs.size(); ++j) {
+            if (boxes_overlap(lhs[i], rhs[j])) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    auto result = overlapping_pairs(lhs, rhs);
+    EXPECT_EQ(result, expected);
+    EXPECT_LT(result.size(), lhs.size() * rhs.size());
+    EXPECT_TRUE(overlapping_pairs(lhs, {}).empty());
+}
+
+TEST(SweepAndPrune, SparseIntersection) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+
+    // two diagonals of boxes where every box only meets its counterpart
+    auto make_diagonal = [&](double offset) {
+        auto event = make_shared_event();
+        for (int i = 0; i < 100; ++i) {
+            auto variable_map = std::make_shared<VariableMap>();
+            variable_map->insert({x, closed(2 * i + offset, 2 * i + offset + 1)});
+            variable_map->insert({y, closed(2 * i, 2 * i + 1)});
+            event->simple_sets->insert(make_shared_simple_event(variable_map));
+        }
+        return event;
+    };
+    auto lhs = make_diagonal(0);
+    auto rhs = make_diagonal(0.5);
+
+    // reference: all pairs
+    auto expected = make_shared_event();
+    for (auto const &a : *lhs->simple_sets) {
+        for (auto const &b : *rhs->simple_sets) {
+            auto intersection = a->intersection_with(b);
+            if (!intersection->is_empty()) {
+                expected->simple_sets->insert(intersection);
+            }
+        }
+    }
+    ASSERT_EQ(expected->simple_sets->size(), 100);
+    auto result = lhs->intersection_with(rhs->simple_sets);
+    EXPECT_TRUE(*result == *expected);
+    // the operands are left untouched
+    EXPECT_EQ(lhs->simple_sets->size(), 100);
+    EXPECT_EQ(rhs->simple_sets->size(), 100);
+    EXPECT_TRUE(*lhs->intersection_with(rhs->simple_sets) == *expected);
+
+    // simple events over other variables are intersected pairwise
+    auto z = make_shared_continuous("z");
+    auto variable_map = std::make_shared<VariableMap>();
+    variable_map->insert({z, closed(0, 1)});
+    auto other = make_shared_simple_set_set();
+    other->insert(make_shared_simple_event(variable_map));
+    EXPECT_FALSE(lhs->has_aligned_axes_with(other));
+    EXPECT_TRUE(lhs->has_aligned_axes_with(rhs->simple_sets));
+    EXPECT_EQ(rhs->simple_sets->size(), 100);
+
+    auto expected_other = make_shared_event();
+    for (auto const &a : *lhs->simple_sets) {
+        auto intersection = a->intersection_with(*other->begin());
+        if (!intersection->is_empty()) {
+            expected_other->simple_sets->insert(intersection);
+        }
+    }
+    EXPECT_TRUE(*lhs->intersection_with(other) == *expected_other);
+}
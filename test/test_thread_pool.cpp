@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "thread_pool.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "variable.h"
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+TEST(ThreadPool, ParallelFor) {
+    ThreadPool pool(4);
+    std::vector<std::size_t> values(10000, 0);
+    pool.parallel_for(0, values.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; ++index) {
+            values[index] = index;
+        }
+    }, 16);
+    std::vector<std::size_t> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ThreadPool, NestedAndExceptions) {
+    ThreadPool pool(3);
+    std::atomic<std::size_t> count{0};
+    pool.parallel_for(0, 8, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; ++index) {
+            // nested calls run in the worker
+            pool.parallel_for(0, 10, [&](std::size_t inner_begin, std::size_t inner_end) {
+                count += inner_end - inner_begin;
+            });
+        }
+    });
+    EXPECT_EQ(count, 80);
+
+    EXPECT_THROW(pool.parallel_for(0, 100, [](std::size_t begin, std::size_t) {
+        if (begin == 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+}
+
+TEST(ThreadPool, DeterministicMakeDisjoint) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> position(0, 20);
+    std::uniform_real_distribution<double> extent(0.5, 4);
+
+    auto event = make_shared_event();
+    for (int i = 0; i < 150; ++i) {
+        auto variable_map = std::make_shared<VariableMap>();
+        auto x_lower = position(generator);
+        auto y_lower = position(generator);
+        variable_map->insert({x, closed(x_lower, x_lower + extent(generator))});
+        variable_map->insert({y, closed(y_lower, y_lower + extent(generator))});
+        event->simple_sets->insert(make_shared_simple_event(variable_map));
+    }
+
+    set_thread_count(1);
+    auto sequential = event->make_disjoint();
+    set_thread_count(4);
+    EXPECT_EQ(get_thread_count(), 4);
+    auto parallel = event->make_disjoint();
+    set_thread_count(1);
+
+    EXPECT_EQ(sequential->simple_sets->size(), parallel->simple_sets->size());
+    EXPECT_EQ(*sequential, *parallel);
+}
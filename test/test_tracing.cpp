@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "tracing.h"
+#include "interval.h"
+#include "product_algebra.h"
+#include "variable.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::string read_file(const std::string &path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::size_t count(const std::string &text, const std::string &pattern) {
+        std::size_t result = 0;
+        for (auto position = text.find(pattern); position != std::string::npos;
+             position = text.find(pattern, position + 1)) {
+            ++result;
+        }
+        return result;
+    }
+}
+
+TEST(Tracing, WritesTraceEvents) {
+    auto x = make_shared_continuous("x");
+    auto y = make_shared_continuous("y");
+    auto map_a = std::make_shared<VariableMap>();
+    map_a->insert({x, closed(0, 2)});
+    map_a->insert({y, closed(0, 2)});
+    auto map_b = std::make_shared<VariableMap>();
+    map_b->insert({x, closed(1, 3)});
+    map_b->insert({y, closed(1, 3)});
+    auto a = make_shared_event(make_shared_simple_event(map_a));
+    auto b = make_shared_event(make_shared_simple_event(map_b));
+
+    const std::string path = testing::TempDir() + "random_events_trace.json";
+    EXPECT_FALSE(tracing_enabled());
+    start_tracing(path);
+    EXPECT_TRUE(tracing_enabled());
+    a->union_with(b);
+    a->complement();
+    stop_tracing();
+    EXPECT_FALSE(tracing_enabled());
+
+    auto trace = read_file(path);
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+    EXPECT_NE(trace.find("\"name\":\"make_disjoint\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"split_into_disjoint_and_non_disjoint\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"SimpleEvent::complement\""), std::string::npos);
+    EXPECT_NE(trace.find("\"input_simple_sets\":2"), std::string::npos);
+    EXPECT_EQ(count(trace, "{"), count(trace, "}"));
+    EXPECT_EQ(count(trace, "\"ph\":\"X\""), count(trace, "\"output_simple_sets\""));
+
+    // spans are not recorded while tracing is stopped
+    a->union_with(b);
+    EXPECT_EQ(read_file(path), trace);
+    std::remove(path.c_str());
+}
+
+TEST(Tracing, UnwritableFile) {
+    EXPECT_THROW(start_tracing("/nonexistent-directory/trace.json"), std::runtime_error);
+    EXPECT_FALSE(tracing_enabled());
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "workload_generator.h"
+#include <cmath>
+
+TEST(WorkloadGenerator, Reproducible) {
+    WorkloadConfig config;
+    config.seed = 7;
+    config.symbolic_variables = 1;
+    config.integer_variables = 1;
+    config.pieces_per_interval = 3;
+
+    WorkloadGenerator first(config);
+    WorkloadGenerator second(config);
+    auto event = first.event();
+    EXPECT_EQ(*event, *second.event());
+    EXPECT_EQ(event->simple_sets->size(), config.event_count);
+
+    config.seed = 8;
+    EXPECT_NE(*event, *WorkloadGenerator(config).event());
+}
+
+TEST(WorkloadGenerator, VariableMix) {
+    WorkloadConfig config;
+    config.continuous_variables = 2;
+    config.symbolic_variables = 3;
+    config.integer_variables = 1;
+    config.universe_size = 5;
+    WorkloadGenerator generator(config);
+
+    ASSERT_EQ(generator.variables()->size(), 6);
+    EXPECT_EQ(generator.all_elements()->size(), 5);
+
+    auto simple_event = generator.simple_event();
+    for (auto const &[variable, assignment]: *simple_event->variable_map) {
+        EXPECT_FALSE(assignment->is_empty());
+        if (auto symbolic = std::dynamic_pointer_cast<Symbolic>(variable)) {
+            EXPECT_EQ(std::static_pointer_cast<Set>(assignment)->all_elements, generator.all_elements());
+        } else if (std::dynamic_pointer_cast<Integer>(variable)) {
+            for (auto const &simple_set: *assignment->simple_sets) {
+                auto simple_interval = std::static_pointer_cast<SimpleInterval>(simple_set);
+                EXPECT_EQ(simple_interval->lower, std::floor(simple_interval->lower));
+                EXPECT_EQ(simple_interval->upper, std::floor(simple_interval->upper));
+            }
+        }
+    }
+}
+
+TEST(WorkloadGenerator, Pieces) {
+    WorkloadConfig config;
+    config.pieces_per_interval = 4;
+    WorkloadGenerator generator(config);
+    for (int i = 0; i < 10; ++i) {
+        auto interval = generator.interval();
+        EXPECT_EQ(interval->simple_sets->size(), 4);
+        EXPECT_TRUE(interval->is_disjoint());
+    }
+}
+
+TEST(WorkloadGenerator, OverlapDensity) {
+    for (double density: {0.1, 0.5, 0.9}) {
+        WorkloadConfig config;
+        config.seed = 3;
+        config.continuous_variables = 3;
+        config.overlap_density = density;
+        WorkloadGenerator generator(config);
+
+        std::vector<AbstractSimpleSetPtr_t> simple_events;
+        for (int i = 0; i < 150; ++i) {
+            simple_events.push_back(generator.simple_event());
+        }
+        std::size_t pairs = 0;
+        std::size_t intersecting = 0;
+        for (std::size_t i = 0; i < simple_events.size(); ++i) {
+            for (std::size_t j = i + 1; j < simple_events.size(); ++j) {
+                ++pairs;
+                intersecting += !simple_events[i]->intersection_with(simple_events[j])->is_empty();
+            }
+        }
+        EXPECT_NEAR(static_cast<double>(intersecting) / static_cast<double>(pairs), density, 0.05);
+    }
+}
+
+TEST(WorkloadGenerator, SetOverlap) {
+    WorkloadConfig config;
+    config.universe_size = 20;
+    config.overlap_density = 0.5;
+    WorkloadGenerator generator(config);
+
+    std::size_t intersecting = 0;
+    for (int i = 0; i < 500; ++i) {
+        intersecting += !generator.set()->intersection_with(generator.set())->is_empty();
+    }
+    EXPECT_GE(static_cast<double>(intersecting) / 500, 0.45);
+}